@@ -0,0 +1,107 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief a memory allocator.
+ *
+ * This data structure represents the source of all the memory the library allocates. Each thread
+ * carries its own current allocator, which every allocation made by the library on that thread is
+ * routed through, see `allocator_use()`. A block must be released while the allocator that
+ * allocated it is still the current one.
+ */
+struct allocator {
+	/**
+	 * @brief Resizes a block, or allocates a new one if `pointer` is `NULL`.
+	 *
+	 * Must behave like `realloc()`, returning `NULL` and leaving the block untouched on failure.
+	 */
+	void *(*reallocate)(void *context, void *pointer, size_t size);
+	/**
+	 * @brief Releases a block, must behave like `free()`.
+	 */
+	void (*deallocate)(void *context, void *pointer);
+	void *context; ///< Passed to the allocator's functions.
+};
+
+/**
+ * @brief The memory usage of a thread.
+ */
+struct allocator_usage {
+	size_t bytes;	   ///< Number of bytes currently allocated.
+	size_t peak_bytes; ///< Largest number of bytes that were allocated at once.
+	/// Number of bytes allocations are not allowed to exceed, or `0` if there is no limit.
+	size_t limit;
+	uint64_t failures; ///< Number of allocations that failed.
+};
+
+/**
+ * @brief The allocator of the C standard library, the initial allocator of every thread.
+ */
+extern const struct allocator allocator_libc;
+
+/**
+ * @brief The memory usage of the calling thread.
+ *
+ * Allocations that would make `bytes` exceed `limit` fail. Every failed allocation is counted in
+ * `failures`, so that a caller can check whether a result is complete after the fact instead of
+ * after every call.
+ */
+extern _Thread_local struct allocator_usage allocator_usage;
+
+/**
+ * @brief Sets the allocator of the calling thread.
+ *
+ * @param[in] allocator The allocator to be used from now on.
+ * @return The previously used allocator.
+ *
+ * @memberof allocator
+ */
+const struct allocator *allocator_use(const struct allocator *allocator);
+
+/**
+ * @brief Allocates a block of memory.
+ *
+ * @param[in] size The size of the block in bytes.
+ * @return The newly allocated block, or `NULL` if it couldn't be allocated.
+ *
+ * @memberof allocator
+ */
+void *allocator_allocate(size_t size);
+
+/**
+ * @brief Allocates a block of memory that is filled with zeros.
+ *
+ * @param[in] count The number of elements in the block.
+ * @param[in] size The size of an element in bytes.
+ * @return The newly allocated block, or `NULL` if it couldn't be allocated.
+ *
+ * @memberof allocator
+ */
+void *allocator_allocate_zeroed(size_t count, size_t size);
+
+/**
+ * @brief Resizes a block of memory.
+ *
+ * @param[in] pointer The block, or `NULL` to allocate a new one.
+ * @param[in] size The new size of the block in bytes.
+ * @return The resized block, or `NULL` if it couldn't be resized, in which case `pointer` is left
+ * untouched.
+ *
+ * @memberof allocator
+ */
+void *allocator_reallocate(void *pointer, size_t size);
+
+/**
+ * @brief Releases a block of memory.
+ *
+ * @param[in] pointer The block, or `NULL`.
+ *
+ * @memberof allocator
+ */
+void allocator_free(void *pointer);
+
+#endif
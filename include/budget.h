@@ -0,0 +1,85 @@
+#ifndef BUDGET_H
+#define BUDGET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief The resource limits of a call.
+ *
+ * A budget is started with `budget_begin()` and applies to everything the calling thread does until
+ * `budget_end()`. The limits are checked cooperatively by the long running loops of the library,
+ * the minterm enumeration, every pass of the Quine-McCluskey algorithm and the cover selection, so
+ * exceeding one is noticed at the next check and not at the exact moment it happens.
+ *
+ * A stage that exceeds the budget stops early and falls back to a cheaper result:
+ * * `minterms_from_expression()` returns no minterms, as a partial on-set would be a different
+ *   function.
+ * * `minterms_to_prime_implicants()` returns the prime implicants found so far together with the
+ *   implicants of the pass it stopped in, which still cover every minterm but aren't all prime.
+ * * `implicants_minimalize()` keeps every implicant, or stops selecting early, which still gives a
+ *   cover but not a minimal one.
+ *
+ * Once a budget is exceeded every later check fails too, so the remaining stages of the call take
+ * their fallbacks right away.
+ */
+struct budget {
+	double seconds;	   ///< Wall-clock seconds the call may take, or `0` if there is no deadline.
+	size_t implicants; ///< Number of minterms or implicants a stage may hold, or `0` for any.
+	size_t bytes;	   ///< Number of bytes the call may allocate, or `0` for any.
+};
+
+/**
+ * @brief The reason a budget was exceeded.
+ */
+enum budget_status {
+	budget_status_within,	  ///< The budget wasn't exceeded.
+	budget_status_deadline,	  ///< The deadline passed.
+	budget_status_implicants, ///< Too many minterms or implicants were held.
+	budget_status_bytes,	  ///< Too many bytes were allocated.
+};
+
+/**
+ * @brief Starts a budget.
+ *
+ * Makes `budget` apply to the calling thread until `budget_end()`. Budgets don't nest.
+ *
+ * @param[in] budget The limits of the call.
+ *
+ * @memberof budget
+ */
+void budget_begin(struct budget budget);
+
+/**
+ * @brief Finishes a budget.
+ *
+ * @return Whether and why the budget was exceeded.
+ *
+ * @memberof budget
+ */
+enum budget_status budget_end(void);
+
+/**
+ * @brief Checks the budget of the calling thread.
+ *
+ * Cheap enough to be called once per iteration of a loop that does real work, but it reads the
+ * clock, so tight loops should only call it every few iterations.
+ *
+ * @param[in] implicants The number of minterms or implicants the caller currently holds.
+ * @return `true` if the budget is exceeded, `false` otherwise or if there's no budget.
+ *
+ * @memberof budget
+ */
+bool budget_exceeded(size_t implicants);
+
+/**
+ * @brief Gets the name of a budget status.
+ *
+ * @param[in] status The status.
+ * @return The name of the status.
+ *
+ * @memberof budget
+ */
+const char *budget_status_name(enum budget_status status);
+
+#endif
@@ -2,6 +2,7 @@
 #define ENVIRONMENT_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #define VARIABLES_COUNT (('z' - 'a' + 1) + ('Z' - 'A' + 1))
@@ -15,6 +16,30 @@ struct environment {
 	uint64_t variables; ///< The values of the variables packed into a 64-bit number
 };
 
+/**
+ * @brief Gets the index of a variable.
+ *
+ * Returns the position of the bit that holds the variable with the given name in an environment.
+ *
+ * @param[in] name The variable's name, must be an alphabet letter.
+ * @return The index of the variable.
+ *
+ * @memberof environment
+ */
+size_t environment_variable_index(char name);
+
+/**
+ * @brief Gets the name of a variable.
+ *
+ * Returns the name of the variable that is held in the bit at the given position in an environment.
+ *
+ * @param[in] index The variable's index, must be less than `VARIABLES_COUNT`.
+ * @return The name of the variable.
+ *
+ * @memberof environment
+ */
+char environment_variable_name(size_t index);
+
 /**
  * @brief Creates a new environment.
  *
@@ -1,11 +1,56 @@
 #ifndef EXPRESSION_H
 #define EXPRESSION_H
 
+#include <allocator.h>
 #include <assert.h>
 #include <ctype.h>
 #include <environment.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <vector/declare.h>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief The largest number of variables that expressions are compared over exhaustively.
+ */
+#define EXPRESSION_PARALLEL_SUPPORT (20)
+
+/**
+ * @brief The smallest number of distinct nodes of an expression of more than 6 variables whose
+ * truth table is evaluated in Gray-code order instead of by cofactoring.
+ */
+#define TRUTH_TABLE_GRAY_NODES (32)
+
+/**
+ * @brief The largest number of variables of an expression that is compiled to a lookup table.
+ */
+#define EXPRESSION_LUT_VARIABLES (16)
+
+/**
+ * @brief The smallest number of variables for which sparse functions have their minterms enumerated
+ * with a sat solver instead of evaluating them in every environment.
+ */
+#define MINTERMS_SPARSE_VARIABLES (20)
+
+/**
+ * @brief The number of 64-environment samples a function must be false in to be considered sparse.
+ */
+#define MINTERMS_SPARSE_SAMPLES (64)
+
+/**
+ * @brief The largest number of minterms that are enumerated with a sat solver.
+ */
+#define MINTERMS_SPARSE_LIMIT (4096)
+
+/**
+ * @brief The smallest number of variables of a function whose prime implicants are computed
+ * implicitly with decision diagrams instead of the tabular method, see `zdd_prime_implicants()`.
+ */
+#define PRIME_IMPLICANTS_ZDD_VARIABLES (8)
 
 /**
  * @brief a boolean expression.
@@ -13,12 +58,19 @@
  * This data structure represents a boolean expression that might contain variables.
  * variables are represented with a single alphabet letter.
  *
+ * All memory is allocated with the calling thread's allocator, see `struct allocator`. Operations
+ * that can't be allocated are replaced with the constant false and functions that can't allocate
+ * their results return empty ones, so that running out of memory never leaves an invalid value
+ * behind, only an incomplete one. Whether that happened is recorded in `allocator_usage`.
+ *
  * Expression grammar
  * ------------------
  * * primary = value | identifier | "(", expression, ")"
  * * factor = "!" factor | factor
- * * term = factor, { ("&" | "*"), factor }
- * * expression = term, { ("|" | "+"), term }
+ * * term = factor, { ("&" | "*" | "~&"), factor }
+ * * parity = term, { ("^" | "~^"), term }
+ * * sum = parity, { ("|" | "+" | "~|"), parity }
+ * * expression = sum, [ "->", expression ]
  */
 struct expression {
 	/**
@@ -44,7 +96,13 @@ struct expression {
 				operation_type_conjunction,
 				operation_type_disjunction,
 				operation_type_negation,
+				operation_type_exclusive_disjunction, ///< XOR
+				operation_type_biconditional,		  ///< XNOR
+				operation_type_alternative_denial,	  ///< NAND
+				operation_type_joint_denial,		  ///< NOR
+				operation_type_implication,
 			} type;						 ///< Type of the operation.
+			size_t operands_count;		 ///< Number of the operation's operands.
 			struct expression *operands; ///< Array of the operation's operands.
 		} operation;
 	};
@@ -53,7 +111,8 @@ struct expression {
 /**
  * @brief Gets the arity of an operation.
  *
- * Returns the number of operands that an operation of type `type` takes.
+ * Returns the number of operands that an operation of type `type` takes, variadic operations take
+ * at least that many operands.
  *
  * @param[in] type The type of the operation.
  * @return The arity of the operation.
@@ -61,7 +120,22 @@ struct expression {
  * @memberof operation_type
  */
 static inline size_t operation_type_arity(enum operation_type type) {
-	return 1 + (type <= operation_type_disjunction);
+	return type == operation_type_negation ? 1 : 2;
+}
+
+/**
+ * @brief Checks whether an operation is variadic.
+ *
+ * Conjunctions and disjunctions are associative, so a chain of them is stored as a single operation
+ * with all of the chain's operands.
+ *
+ * @param[in] type The type of the operation.
+ * @return `true` if the operation takes any number of operands, `false` otherwise.
+ *
+ * @memberof operation_type
+ */
+static inline bool operation_type_is_variadic(enum operation_type type) {
+	return type == operation_type_conjunction || type == operation_type_disjunction;
 }
 
 /**
@@ -76,9 +150,14 @@ static inline size_t operation_type_arity(enum operation_type type) {
  */
 static inline size_t operation_type_precedence(enum operation_type type) {
 	switch (type) {
-		case operation_type_disjunction: return 0;
-		case operation_type_conjunction: return 1;
-		case operation_type_negation: return 2;
+		case operation_type_implication: return 0;
+		case operation_type_disjunction:
+		case operation_type_joint_denial: return 1;
+		case operation_type_exclusive_disjunction:
+		case operation_type_biconditional: return 2;
+		case operation_type_conjunction:
+		case operation_type_alternative_denial: return 3;
+		case operation_type_negation: return 4;
 		default: assert(false);
 	}
 }
@@ -123,7 +202,8 @@ static inline struct expression expression_variable(char name) {
  * @brief Creates a new expression of type operation.
  *
  * Returns a new expression of type operation with the given type and operands.
- * The number of operands must match the arity of the operation.
+ * The number of operands must match the arity of the operation. Operands of a variadic operation
+ * that are operations of the same type are flattened into it.
  *
  * @param[in] type The operation's type.
  * @return The newly created expression.
@@ -132,6 +212,27 @@ static inline struct expression expression_variable(char name) {
  */
 struct expression expression_operation(enum operation_type type, ...);
 
+/**
+ * @brief Creates a new expression of type operation from an array of operands.
+ *
+ * Returns a new expression of type operation that takes ownership of `operands`, an array allocated
+ * with `allocator_allocate()`. Operands of a variadic operation that are operations of the same
+ * type are flattened into it.
+ *
+ * @param[in] type The operation's type.
+ * @param[in] operands The operation's operands.
+ * @param[in] operands_count The number of operands, must match the arity of the operation or be at
+ * least it if the operation is variadic.
+ * @return The newly created expression.
+ *
+ * @memberof expression
+ */
+struct expression expression_operation_from_operands(
+	enum operation_type type,
+	struct expression *operands,
+	size_t operands_count
+);
+
 /**
  * @brief Clones an expression
  *
@@ -175,17 +276,46 @@ bool expression_equals(
  * Parses the given string into an expression.
  *
  * @param[in] string The string to be parsed.
- * @return The newly created expression.
+ * @return The newly created expression, or the constant `0` if memory ran out, in which case an
+ * error is printed.
  *
  * @memberof expression
  */
 struct expression expression_from_string(const char *string);
 
+/**
+ * @brief Creates an expression from a string, failing if it isn't well-formed.
+ *
+ * Works like `expression_from_string()`, but instead of recovering from a missing operand, an
+ * unclosed parenthesis, trailing characters or memory running out, it fails. The diagnostics are
+ * printed all the same.
+ *
+ * @param[in] string The string to be parsed.
+ * @param[out] expression Set to the newly created expression on success.
+ * @return `true` if the string was parsed, `false` otherwise.
+ *
+ * @memberof expression
+ */
+bool expression_from_string_strict(const char *string, struct expression *expression);
+
+/**
+ * @brief Gets the reason the last string failed to parse.
+ *
+ * Set by `expression_from_string_strict()` when it fails and by `minterms_from_string()` when it
+ * returns `minterms_status_invalid`, to the first diagnostic they printed, without its severity.
+ *
+ * @return The reason, empty if the last string parsed on the calling thread had no diagnostics,
+ * valid until the next string is parsed on the thread.
+ *
+ * @memberof expression
+ */
+const char *expression_parse_error(void);
+
 /**
  * @brief Converts an expression to a string.
  *
  * Creates a human-readable string representation of the given expression.
- * The returned string must be freed with `free()`
+ * The returned string must be freed with `allocator_free()`
  *
  * @param[in] expression The expression to be converted.
  * @return The newly created string.
@@ -197,8 +327,11 @@ char *expression_to_string(const struct expression *expression);
 /**
  * @brief Simplifies an expression
  *
- * Constant folds any constant sub-expressions in the given expression.
- * and might perform some mathematical simplifications if possible.
+ * Constant folds any constant sub-expressions in the given expression, flattens nested conjunctions
+ * and disjunctions and rewrites it with the idempotence (`x x = x`), complementation (`x x' = 0`),
+ * absorption (`x + x y = x`), involution (`x'' = x`) and De Morgan (`x' y' = x ~| y`) laws until
+ * none of them applies. Rewrites are done in place and never create new operations, but flattening
+ * grows the operands of the outer operation, which are left nested if memory runs out.
  *
  * @param[in,out] expression The expression to be simplified
  * @param[in] environment The environment the expression is simplified in.
@@ -207,6 +340,25 @@ char *expression_to_string(const struct expression *expression);
  */
 void expression_simplify(struct expression *expression, const struct environment *environment);
 
+/**
+ * @brief Computes a cofactor of an expression
+ *
+ * Returns the simplified residual of the given expression after every variable whose bit is set in
+ * `mask` is replaced with its value in `environment`, the other variables are left symbolic.
+ *
+ * @param[in] expression The expression to be cofactored.
+ * @param[in] environment The values of the assigned variables.
+ * @param[in] mask The variables that are assigned, indexed like the bits of an environment.
+ * @return The newly created cofactor.
+ *
+ * @memberof expression
+ */
+struct expression expression_cofactor(
+	const struct expression *expression,
+	const struct environment *environment,
+	uint64_t mask
+);
+
 /**
  * @brief Prints an expression.
  *
@@ -245,13 +397,206 @@ bool expression_evaluate(
 	const struct environment *environment
 );
 
-struct variables {
-	char *data;
-	size_t length;
-};
-void variables_drop(struct variables *variables);
+/**
+ * @brief Evaluates an expression for 64 environments at once.
+ *
+ * Returns the results of evaluating the given expression in 64 environments, where bit `i` of
+ * `variables[environment_variable_index(name)]` holds the value of the variable `name` in the `i`th
+ * environment and bit `i` of the result holds the value of the expression in it.
+ *
+ * @param[in] expression The expression to be evaluated.
+ * @param[in] variables The values of the variables, `VARIABLES_COUNT` words.
+ * @return the results of the expression
+ *
+ * @memberof expression
+ */
+uint64_t expression_evaluate_parallel(
+	const struct expression *expression,
+	const uint64_t *variables
+);
+
+/**
+ * @brief Checks whether two expressions are equivalent
+ *
+ * Checks whether the two expressions evaluate to the same value in every environment. Supports of
+ * up to `EXPRESSION_PARALLEL_SUPPORT` variables are compared 64 environments at a time, larger ones
+ * are checked by encoding the exclusive disjunction of the two sides into clauses and solving them,
+ * any solution being an environment they differ in. If the solver runs out of memory, the search
+ * splits the support by substituting its variables one at a time and simplifying instead.
+ *
+ * @param[in] expression_1 The first expression
+ * @param[in] expression_2 The second expression
+ * @param[out] counterexample If not `NULL`, set to an environment the expressions differ in.
+ * @return `true` if the expressions are equivalent, `false` otherwise
+ *
+ * @memberof expression
+ */
+bool expression_equivalent(
+	const struct expression *expression_1,
+	const struct expression *expression_2,
+	struct environment *counterexample
+);
+
+/**
+ * @brief Checks whether an expression is a tautology
+ *
+ * Checks whether the expression evaluates to true in every environment.
+ *
+ * @param[in] expression The expression to be checked
+ * @param[out] counterexample If not `NULL`, set to an environment the expression is false in.
+ * @return `true` if the expression is a tautology, `false` otherwise
+ *
+ * @memberof expression
+ */
+bool expression_is_tautology(
+	const struct expression *expression,
+	struct environment *counterexample
+);
+
+/**
+ * @brief Checks whether an expression is satisfiable
+ *
+ * Checks whether the expression evaluates to true in at least one environment.
+ *
+ * @param[in] expression The expression to be checked
+ * @param[out] witness If not `NULL`, set to an environment the expression is true in.
+ * @return `true` if the expression is satisfiable, `false` otherwise
+ *
+ * @memberof expression
+ */
+bool expression_is_satisfiable(const struct expression *expression, struct environment *witness);
+
+// there are only so many variables, so they are always kept inline
+VECTOR_DECLARE(variables, char, VARIABLES_COUNT)
 struct variables variables_from_expression(const struct expression *expression);
 
+/**
+ * @brief a truth table.
+ *
+ * This data structure represents the values of a function in all of its minterms as a bitmap, where
+ * bit `i` of the table is the value in minterm `i` and the first variable is the most significant
+ * bit of a minterm.
+ */
+struct truth_table {
+	struct variables variables; ///< The variables of the function.
+	uint64_t *data;				///< The bitmap, `truth_table_words()` words long.
+};
+
+/**
+ * @brief Gets the size of a truth table.
+ *
+ * @param[in] table The truth table.
+ * @return The number of words the table's bitmap takes.
+ *
+ * @memberof truth_table
+ */
+static inline size_t truth_table_words(const struct truth_table *table) {
+	return table->variables.length <= 6 ? 1 : (size_t)1 << (table->variables.length - 6);
+}
+
+/**
+ * @brief Drops a truth table.
+ *
+ * Releases all memory and resources owned by the truth table.
+ *
+ * @param[in,out] table The truth table to drop.
+ *
+ * @memberof truth_table
+ */
+void truth_table_drop(struct truth_table *table);
+
+/**
+ * @brief Creates the truth table of an expression.
+ *
+ * Builds the table by cofactoring the expression on its first variable and recursing into both
+ * halves. A half whose cofactor is constant is filled at once, one whose cofactor is identical to
+ * one that was already built at the same depth is copied, and the last 6 variables are evaluated 64
+ * minterms at a time.
+ *
+ * Expressions with at least `TRUTH_TABLE_GRAY_NODES` distinct nodes rarely have cofactors that
+ * simplify, so their table is evaluated in Gray-code order instead, re-evaluating only the nodes
+ * that depend on the single variable that changes from one word to the next, see
+ * `expression_pool_evaluate_table()`.
+ *
+ * @param[in] expression The expression.
+ * @return The newly created truth table.
+ *
+ * @memberof truth_table
+ */
+struct truth_table truth_table_from_expression(const struct expression *expression);
+
+/**
+ * @brief a lookup table of an expression.
+ *
+ * This data structure represents the truth table of an expression indexed by the bits of its
+ * variables in a packed environment, so that evaluating the expression is a bit extraction and a
+ * single load.
+ */
+struct expression_lut {
+	uint64_t mask;	///< The bits of the expression's variables in a packed environment.
+	uint64_t *data; ///< The bitmap, bit `i` is the value where the extracted bits are `i`.
+	/// The extracted bits of every value of every byte of a packed environment, for targets
+	/// without `pext`.
+	uint16_t (*bytes)[256];
+};
+
+/**
+ * @brief Compiles an expression to a lookup table.
+ *
+ * Builds the truth table of the expression once, the same way `truth_table_from_expression()`
+ * does, with its variables ordered so that the table is indexed by the bits of a packed
+ * environment that belong to them, in order.
+ *
+ * @param[in] expression The expression.
+ * @param[out] lut Set to the lookup table on success.
+ * @return `true` if the table was built, `false` if the expression has more than
+ * `EXPRESSION_LUT_VARIABLES` variables or memory ran out.
+ *
+ * @memberof expression_lut
+ */
+bool expression_compile_lut(const struct expression *expression, struct expression_lut *lut);
+
+/**
+ * @brief Drops a lookup table.
+ *
+ * Releases all memory and resources owned by the lookup table.
+ *
+ * @param[in,out] lut The lookup table to drop.
+ *
+ * @memberof expression_lut
+ */
+void expression_lut_drop(struct expression_lut *lut);
+
+/**
+ * @brief Evaluates an expression with its lookup table.
+ *
+ * Works like `expression_evaluate()`. The bits of the expression's variables are extracted with
+ * `pext` when the target has BMI2 and a byte at a time from precomputed tables otherwise.
+ *
+ * @param[in] lut The lookup table of the expression.
+ * @param[in] environment The environment the expression is evaluated in.
+ * @return the result of the expression
+ *
+ * @memberof expression_lut
+ */
+static inline bool expression_lut_evaluate(
+	const struct expression_lut *lut,
+	const struct environment *environment
+) {
+	assert(lut != NULL && environment != NULL);
+
+#if defined(__BMI2__)
+	uint64_t index = _pext_u64(environment->variables, lut->mask);
+#else
+	uint64_t index = 0;
+	for (size_t i = 0; i < 8; i++) {
+		index += lut->bytes[i][(environment->variables >> (i * 8)) & 0xFF];
+	}
+#endif
+
+	return (lut->data[index / 64] >> (index % 64)) & 1U;
+}
+
 struct minterms {
 	struct variables variables;
 	uint64_t *data;
@@ -259,6 +604,39 @@ struct minterms {
 };
 void minterms_drop(struct minterms *minterms);
 struct minterms minterms_from_expression(const struct expression *expression);
+
+/**
+ * @brief The outcome of parsing a function given directly by its minterms.
+ */
+enum minterms_status {
+	minterms_status_absent,	 ///< The string doesn't give minterms, it may be an expression.
+	minterms_status_parsed,	 ///< The minterms were parsed.
+	minterms_status_invalid, ///< The string gives minterms, but they don't describe a function.
+};
+
+/**
+ * @brief Parses a function given directly by its minterms.
+ *
+ * Accepts the variables of the function, `f(a, b, c) = `, the first one being the most
+ * significant bit of a minterm, followed by either a list of minterms, `Σm(1, 3, 5)` or
+ * `m(1, 3, 5)`, or a truth table in hexadecimal, `0xE8`, or binary, `0b11101000`, where bit `i`
+ * of the number is the value of the function in minterm `i`. A list's largest minterm must fit in
+ * the variables, a table must be exactly `2^n` bits long for `n` variables, except that the table
+ * of a function of fewer than 2 variables may be a single hexadecimal digit, `f() = 0x1`. The
+ * variables are required, as `m(1)` or `0b10` on their own are valid expressions too, but there may
+ * be none of them, and each may only be given once.
+ *
+ * No expression is built or evaluated, the minterms are read straight from the string.
+ *
+ * @param[in] string The string to be parsed.
+ * @param[out] minterms Set to the parsed minterms on success.
+ * @return `minterms_status_parsed` if the string was parsed, `minterms_status_absent` if it doesn't
+ * start with the variables of a function, or `minterms_status_invalid` if it does but isn't
+ * followed by valid minterms, in which case an error is printed.
+ *
+ * @memberof minterms
+ */
+enum minterms_status minterms_from_string(const char *string, struct minterms *minterms);
 struct implicants minterms_to_prime_implicants(const struct minterms *minterms);
 
 struct implicant {
@@ -268,18 +646,13 @@ struct implicant {
 bool implicant_combinable(struct implicant implicant_1, struct implicant implicant_2);
 struct implicant implicant_combine(struct implicant implicant_1, struct implicant implicant_2);
 
-struct implicants {
-	struct implicant *data;
-	size_t length;
-	size_t capacity;
-};
-struct implicants implicants_new(void);
-void implicants_drop(struct implicants *implicants);
-void implicants_add(struct implicants *implicants, struct implicant implicant);
+// most minimized functions have only a few implicants, which are then kept inline
+VECTOR_DECLARE(implicants, struct implicant, 4)
+bool implicants_add(struct implicants *implicants, struct implicant implicant);
 struct expression implicants_to_expression(
 	const struct implicants *implicants,
 	const struct variables *variables
 );
-void implicants_minimalize(struct implicants *implicants, const struct minterms *minterms);
+bool implicants_minimalize(struct implicants *implicants, const struct minterms *minterms);
 
 #endif
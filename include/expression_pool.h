@@ -0,0 +1,285 @@
+#ifndef EXPRESSION_POOL_H
+#define EXPRESSION_POOL_H
+
+#include <environment.h>
+#include <expression.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The index of a node that doesn't exist.
+ */
+#define EXPRESSION_POOL_NONE (UINT32_MAX)
+
+/**
+ * @brief a pool of expression nodes.
+ *
+ * This data structure represents a boolean expression as a directed acyclic graph whose nodes are
+ * stored in parallel arrays instead of being allocated one by one. Nodes are referred to by their
+ * 32-bit index and are kept in topological order, every operand comes before the operations that
+ * use it and the root of the expression is the last node, so that any bottom-up pass over the
+ * expression is a single linear scan of the arrays.
+ *
+ * Nodes are hash-consed, adding a node that is identical to an existing one returns the existing
+ * node's index, which makes structurally equal sub-expressions share a single node and lets them be
+ * compared by index.
+ */
+struct expression_pool {
+	size_t length;	 ///< Number of nodes.
+	size_t capacity; ///< Number of nodes the per-node arrays can hold.
+	uint8_t *types;	 ///< Types of the nodes, `enum expression_type`.
+	/// Values of constants, names of variables and `enum operation_type` of operations.
+	uint8_t *values;
+	uint32_t *operands_starts; ///< Positions of the nodes' first operands in `operands`.
+	uint32_t *operands_counts; ///< Numbers of the nodes' operands.
+
+	uint32_t *operands;		  ///< Indices of the operands of all the operations.
+	size_t operands_length;	  ///< Number of operands.
+	size_t operands_capacity; ///< Number of operands the array can hold.
+
+	uint32_t *buckets;	  ///< Hash table of the nodes, `EXPRESSION_POOL_NONE` if empty.
+	size_t buckets_count; ///< Number of buckets, a power of two.
+};
+
+/**
+ * @brief Creates a new pool.
+ *
+ * Initializes a new pool without any nodes.
+ *
+ * @return The newly created pool.
+ *
+ * @memberof expression_pool
+ */
+struct expression_pool expression_pool_new(void);
+
+/**
+ * @brief Drops a pool.
+ *
+ * Releases all memory and resources owned by the pool.
+ *
+ * @param[in,out] pool The pool to drop.
+ *
+ * @memberof expression_pool
+ */
+void expression_pool_drop(struct expression_pool *pool);
+
+/**
+ * @brief Gets the root of a pool.
+ *
+ * @param[in] pool The pool, must not be empty.
+ * @return The index of the root of the pool's expression.
+ *
+ * @memberof expression_pool
+ */
+static inline uint32_t expression_pool_root(const struct expression_pool *pool) {
+	assert(pool != NULL && pool->length != 0);
+
+	return (uint32_t)(pool->length - 1);
+}
+
+/**
+ * @brief Adds a constant to a pool.
+ *
+ * @param[in,out] pool The pool the constant is added to.
+ * @param[in] value The constant's value.
+ * @return The index of the constant's node, or `EXPRESSION_POOL_NONE` if memory ran out.
+ *
+ * @memberof expression_pool
+ */
+uint32_t expression_pool_add_constant(struct expression_pool *pool, bool value);
+
+/**
+ * @brief Adds a variable to a pool.
+ *
+ * @param[in,out] pool The pool the variable is added to.
+ * @param[in] name The variable's name, must be an alphabet letter.
+ * @return The index of the variable's node, or `EXPRESSION_POOL_NONE` if memory ran out.
+ *
+ * @memberof expression_pool
+ */
+uint32_t expression_pool_add_variable(struct expression_pool *pool, char name);
+
+/**
+ * @brief Adds an operation to a pool.
+ *
+ * The operands must already be nodes of the pool and their number must match the arity of the
+ * operation, or be at least it if the operation is variadic. An operand may be
+ * `EXPRESSION_POOL_NONE`, in which case so is the operation, so that running out of memory carries
+ * over to the nodes built on top of the failed one.
+ *
+ * @param[in,out] pool The pool the operation is added to.
+ * @param[in] type The operation's type.
+ * @param[in] operands The indices of the operation's operands.
+ * @param[in] operands_count The number of operands.
+ * @return The index of the operation's node, or `EXPRESSION_POOL_NONE` if memory ran out.
+ *
+ * @memberof expression_pool
+ */
+uint32_t expression_pool_add_operation(
+	struct expression_pool *pool,
+	enum operation_type type,
+	const uint32_t *operands,
+	size_t operands_count
+);
+
+/**
+ * @brief Adds an expression to a pool.
+ *
+ * Adds the nodes of the expression to the pool in post-order, sharing the nodes the pool already
+ * has, so that several expressions can be added to a single pool.
+ *
+ * @param[in,out] pool The pool the expression is added to.
+ * @param[in] expression The expression to be added.
+ * @return The index of the expression's root node, or `EXPRESSION_POOL_NONE` if memory ran out, in
+ * which case the nodes that were added before stay in the pool.
+ *
+ * @memberof expression_pool
+ */
+uint32_t expression_pool_add_expression(
+	struct expression_pool *pool,
+	const struct expression *expression
+);
+
+/**
+ * @brief Creates a pool from an expression.
+ *
+ * Adds the nodes of the expression to a new pool in post-order, so that its root is the pool's
+ * root.
+ *
+ * @param[in] expression The expression to be converted.
+ * @return The newly created pool, which is empty if memory ran out.
+ *
+ * @memberof expression_pool
+ */
+struct expression_pool expression_pool_from_expression(const struct expression *expression);
+
+/**
+ * @brief Converts a pool to an expression.
+ *
+ * Creates a tree expression out of the pool's root, nodes that are shared by multiple operations
+ * are cloned for each of them.
+ *
+ * @param[in] pool The pool to be converted, must not be empty.
+ * @return The newly created expression, or the constant `0` if memory ran out.
+ *
+ * @memberof expression_pool
+ */
+struct expression expression_pool_to_expression(const struct expression_pool *pool);
+
+/**
+ * @brief Evaluates the expression of a pool.
+ *
+ * Evaluates every node of the pool in order, so that operands are always evaluated before the
+ * operations that use them.
+ *
+ * @param[in] pool The pool to be evaluated, must not be empty.
+ * @param[in] environment The environment the expression is evaluated in.
+ * @return the result of the expression
+ *
+ * @memberof expression_pool
+ */
+bool expression_pool_evaluate(
+	const struct expression_pool *pool,
+	const struct environment *environment
+);
+
+/**
+ * @brief Evaluates the expression of a pool for 64 environments at once.
+ *
+ * Works like `expression_evaluate_parallel()` but evaluates the nodes of the pool in order.
+ *
+ * @param[in] pool The pool to be evaluated, must not be empty.
+ * @param[in] variables The values of the variables, `VARIABLES_COUNT` words.
+ * @return the results of the expression
+ *
+ * @memberof expression_pool
+ */
+uint64_t expression_pool_evaluate_parallel(
+	const struct expression_pool *pool,
+	const uint64_t *variables
+);
+
+/**
+ * @brief Evaluates the expression of a pool in every environment of some variables.
+ *
+ * Fills the truth table of the expression, whose bit `i` is the value of the expression in the
+ * environment where the `j`th variable has the value of bit `variables->length - j - 1` of `i`. The
+ * last 6 variables are evaluated 64 environments at a time and the others take their values in
+ * Gray-code order, so that a single variable changes from one word of the table to the next. The
+ * value of every node is kept and only the nodes that depend on the changed variable are evaluated
+ * again, which makes every word cost the size of that variable's cone rather than of the whole
+ * expression.
+ *
+ * Checks the budget of the calling thread every 64 words, see `budget_exceeded()`.
+ *
+ * @param[in] pool The pool to be evaluated, must not be empty.
+ * @param[in] variables The variables of the table, must include every variable of the pool.
+ * @param[out] table Set to the truth table, `2^(variables->length - 6)` words or one word if there
+ * are at most 6 variables.
+ * @return `true` if the table was filled, `false` if memory ran out or the budget was exceeded.
+ *
+ * @memberof expression_pool
+ */
+bool expression_pool_evaluate_table(
+	const struct expression_pool *pool,
+	const struct variables *variables,
+	uint64_t *table
+);
+
+/**
+ * @brief Evaluates the expression of a pool for a block of environments at once.
+ *
+ * Works like `expression_pool_evaluate_parallel()` but for `64 * words` environments, every node is
+ * evaluated over all the words before moving on to the next one, so that the cost of walking the
+ * pool is shared by the whole block and the loops over the words can be vectorized.
+ *
+ * @param[in] pool The pool to be evaluated, must not be empty.
+ * @param[in] variables The values of the variables, `VARIABLES_COUNT` runs of `words` words, the
+ * run of the variable `name` starting at `variables[environment_variable_index(name) * words]`.
+ * @param[in] words The number of words of every run.
+ * @param[out] results Set to the results of the expression, `words` words.
+ * @return `true` if the pool was evaluated, `false` if memory ran out.
+ *
+ * @memberof expression_pool
+ */
+bool expression_pool_evaluate_block(
+	const struct expression_pool *pool,
+	const uint64_t *variables,
+	size_t words,
+	uint64_t *results
+);
+
+/**
+ * @brief Simplifies the expression of a pool.
+ *
+ * Applies the rewrite rules of `expression_simplify()` in a single pass over the nodes, rebuilding
+ * every node on top of its already simplified operands, and then removes the nodes that are no
+ * longer reachable from the root.
+ *
+ * @param[in,out] pool The pool to be simplified, must not be empty.
+ * @param[in] environment The environment the expression is simplified in, or `NULL`.
+ *
+ * If memory runs out, the pool is left as it was.
+ *
+ * @memberof expression_pool
+ */
+void expression_pool_simplify(
+	struct expression_pool *pool,
+	const struct environment *environment
+);
+
+/**
+ * @brief Converts the expression of a pool to a string.
+ *
+ * Creates the same representation as `expression_to_string()` without recursing.
+ * The returned string must be freed with `allocator_free()`
+ *
+ * @param[in] pool The pool to be converted, must not be empty.
+ * @return The newly created string, or `NULL` if memory ran out.
+ *
+ * @memberof expression_pool
+ */
+char *expression_pool_to_string(const struct expression_pool *pool);
+
+#endif
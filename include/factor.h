@@ -0,0 +1,39 @@
+#ifndef FACTOR_H
+#define FACTOR_H
+
+#include <expression.h>
+#include <expression_pool.h>
+#include <stdint.h>
+
+/**
+ * @brief The largest number of kernels that are considered as divisors of a cover.
+ */
+#define FACTOR_KERNELS_LIMIT (256)
+
+/**
+ * @brief Factors a sum of products.
+ *
+ * Turns the sum of the given implicants into a multi-level expression by algebraic division. The
+ * common cube of a cover is factored out first, then the cover is divided by the kernel that saves
+ * the most literals, a kernel being a cube-free quotient of the cover by a cube, and the quotient,
+ * the divisor and the remainder are factored in turn. Covers without a useful kernel are factored
+ * by their most frequent literal.
+ *
+ * The factors are added to the pool, so that factors that occur more than once, within the
+ * expression or across expressions added to the same pool, are shared by all their uses.
+ *
+ * @param[in] implicants The implicants of the sum, as given by `implicants_minimalize()`.
+ * @param[in] variables The variables of the implicants.
+ * @param[in,out] pool The pool the factored expression is added to.
+ * @return The index of the factored expression's root node, or `EXPRESSION_POOL_NONE` if memory ran
+ * out.
+ *
+ * @memberof implicants
+ */
+uint32_t implicants_factor(
+	const struct implicants *implicants,
+	const struct variables *variables,
+	struct expression_pool *pool
+);
+
+#endif
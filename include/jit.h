@@ -0,0 +1,89 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <environment.h>
+#include <expression.h>
+#include <expression_pool.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The largest number of nodes of an expression that is compiled to native code.
+ *
+ * The compiled code keeps the value of every node on the stack, so larger expressions are
+ * interpreted instead.
+ */
+#define JIT_NODES_LIMIT (16384)
+
+/**
+ * @brief a compiled expression.
+ *
+ * This data structure represents an expression that was translated to x86-64 machine code, a
+ * function that evaluates it for 64 environments at once and one that evaluates it for a single
+ * packed environment. The code lives in a mapping of its own that is made executable, and never
+ * writable, once it's generated.
+ *
+ * On other architectures, or if the expression is too large or the mapping can't be made, the
+ * expression is interpreted from its pool instead, so that a compiled expression can always be
+ * evaluated.
+ */
+struct jit {
+	struct expression_pool pool; ///< The nodes of the expression.
+	void *code;					 ///< The mapping of the code, or `NULL` if it's interpreted.
+	size_t code_size;			 ///< Size of the mapping in bytes.
+	/// Evaluates the expression for 64 environments, or `NULL` if it's interpreted.
+	uint64_t (*parallel)(const uint64_t *variables);
+	/// Evaluates the expression for a packed environment, or `NULL` if it's interpreted.
+	uint64_t (*single)(uint64_t variables);
+};
+
+/**
+ * @brief Compiles an expression.
+ *
+ * @param[in] expression The expression to be compiled.
+ * @return The newly compiled expression, whose pool is empty if memory ran out, in which case it
+ * must not be evaluated.
+ *
+ * @memberof jit
+ */
+struct jit jit_compile(const struct expression *expression);
+
+/**
+ * @brief Drops a compiled expression.
+ *
+ * Unmaps the code and releases all memory and resources owned by the compiled expression.
+ *
+ * @param[in,out] jit The compiled expression to drop.
+ *
+ * @memberof jit
+ */
+void jit_drop(struct jit *jit);
+
+/**
+ * @brief Evaluates a compiled expression.
+ *
+ * Works like `expression_evaluate()`.
+ *
+ * @param[in] jit The compiled expression.
+ * @param[in] environment The environment the expression is evaluated in.
+ * @return the result of the expression
+ *
+ * @memberof jit
+ */
+bool jit_evaluate(const struct jit *jit, const struct environment *environment);
+
+/**
+ * @brief Evaluates a compiled expression for 64 environments at once.
+ *
+ * Works like `expression_evaluate_parallel()`.
+ *
+ * @param[in] jit The compiled expression.
+ * @param[in] variables The values of the variables, `VARIABLES_COUNT` words.
+ * @return the results of the expression
+ *
+ * @memberof jit
+ */
+uint64_t jit_evaluate_parallel(const struct jit *jit, const uint64_t *variables);
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef PLA_H
+#define PLA_H
+
+#include <expression.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief The largest number of inputs of a PLA whose outputs are read into minterms.
+ */
+#define PLA_MAXIMUM_INPUTS (32)
+
+/**
+ * @brief a reader of Berkeley PLA files.
+ *
+ * This data structure represents a PLA file that is being read one cube at a time, so that files of
+ * any size are read in a single pass while holding only one line of them in memory.
+ *
+ * The header keywords `.i`, `.o`, `.ilb`, `.ob`, `.p`, `.type` and `.e` are understood and comments
+ * are skipped. Inputs are the columns `0`, `1` and `-` (or `2`), outputs are `1` (or `4`) if the
+ * cube is in the on-set of the output and anything else otherwise, so don't-care cubes of `fd`
+ * files are treated as off.
+ */
+struct pla_reader {
+	FILE *file;			   ///< The file being read.
+	char *line;			   ///< The current line.
+	size_t line_capacity;  ///< Number of bytes the line can hold.
+	size_t line_number;	   ///< Number of the current line, for error messages.
+	size_t inputs_count;   ///< Number of inputs, the columns of a cube's input part.
+	size_t outputs_count;  ///< Number of outputs, the columns of a cube's output part.
+	char **output_names;   ///< Names of the outputs from `.ob`, or `NULL`.
+	struct variables variables; ///< The inputs as variables, named after `.ilb` if possible.
+	bool pending;		   ///< Whether the current line holds a cube that wasn't returned yet.
+	bool ended;			   ///< Whether the end of the PLA was reached.
+	bool failed;		   ///< Whether the file was malformed.
+};
+
+/**
+ * @brief Opens a PLA reader.
+ *
+ * Reads the header of the PLA up to its first cube.
+ *
+ * @param[out] reader The reader to be opened.
+ * @param[in] file The file to be read, is not closed by the reader.
+ * @return `true` if the header was read, `false` otherwise, in which case an error is printed.
+ *
+ * @memberof pla_reader
+ */
+bool pla_reader_open(struct pla_reader *reader, FILE *file);
+
+/**
+ * @brief Closes a PLA reader.
+ *
+ * Releases all memory owned by the reader.
+ *
+ * @param[in,out] reader The reader to be closed.
+ *
+ * @memberof pla_reader
+ */
+void pla_reader_close(struct pla_reader *reader);
+
+/**
+ * @brief Reads the next cube of a PLA.
+ *
+ * @param[in,out] reader The reader.
+ * @param[out] cube The input part of the cube, the first input being its most significant bit.
+ * @param[out] outputs Set to whether the cube is in the on-set of each output, `outputs_count`
+ * elements.
+ * @return `true` if a cube was read, `false` at the end of the PLA or if it is malformed, in which
+ * case `failed` is set and an error is printed.
+ *
+ * @memberof pla_reader
+ */
+bool pla_reader_next(struct pla_reader *reader, struct implicant *cube, bool *outputs);
+
+/**
+ * @brief Reads the on-sets of all the outputs of a PLA.
+ *
+ * Reads the remaining cubes and marks the minterms they cover in a bitmap per output, so that the
+ * memory used depends on the number of inputs and not on the size of the file. The PLA must have at
+ * most `PLA_MAXIMUM_INPUTS` inputs.
+ *
+ * @param[in,out] reader The reader.
+ * @param[out] minterms Set to the minterms of each output, `outputs_count` elements.
+ * @return `true` if the cubes were read, `false` otherwise, in which case an error is printed.
+ *
+ * @memberof pla_reader
+ */
+bool pla_reader_read_minterms(struct pla_reader *reader, struct minterms *minterms);
+
+/**
+ * @brief a writer of Berkeley PLA files.
+ *
+ * This data structure represents a PLA file of type `f` that is being written one cube at a time.
+ * Every cube belongs to a single output.
+ */
+struct pla_writer {
+	FILE *file;			  ///< The file being written.
+	char *line;			  ///< A cube line, reused for every cube.
+	size_t inputs_count;  ///< Number of inputs.
+	size_t outputs_count; ///< Number of outputs.
+	bool failed;		  ///< Whether writing to the file failed.
+};
+
+/**
+ * @brief Opens a PLA writer.
+ *
+ * Writes the header of the PLA.
+ *
+ * @param[out] writer The writer to be opened.
+ * @param[in] file The file to be written, is not closed by the writer.
+ * @param[in] variables The inputs of the PLA.
+ * @param[in] outputs_count The number of outputs.
+ * @param[in] output_names The names of the outputs, or `NULL`.
+ * @return `true` if the header was written, `false` otherwise.
+ *
+ * @memberof pla_writer
+ */
+bool pla_writer_open(
+	struct pla_writer *writer,
+	FILE *file,
+	const struct variables *variables,
+	size_t outputs_count,
+	char *const *output_names
+);
+
+/**
+ * @brief Writes a cube of a PLA.
+ *
+ * @param[in,out] writer The writer.
+ * @param[in] cube The input part of the cube.
+ * @param[in] output The output whose on-set the cube belongs to.
+ *
+ * @memberof pla_writer
+ */
+void pla_writer_write(struct pla_writer *writer, struct implicant cube, size_t output);
+
+/**
+ * @brief Closes a PLA writer.
+ *
+ * Terminates the PLA and releases all memory owned by the writer.
+ *
+ * @param[in,out] writer The writer to be closed.
+ * @return `true` if the whole PLA was written, `false` otherwise.
+ *
+ * @memberof pla_writer
+ */
+bool pla_writer_close(struct pla_writer *writer);
+
+#endif
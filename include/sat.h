@@ -0,0 +1,156 @@
+#ifndef SAT_H
+#define SAT_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief a conflict-driven clause learning satisfiability solver.
+ *
+ * This data structure represents an incremental solver for boolean formulas in conjunctive normal
+ * form. It propagates with two watched literals per clause, learns first unique implication point
+ * clauses from conflicts, branches on the most active variable with saved phases and restarts
+ * following the Luby sequence. Clauses may be added between calls to `sat_solver_solve()`, which
+ * makes it suitable for enumerating solutions with blocking clauses.
+ *
+ * A literal is a variable's index shifted left by one, with the lowest bit set if it is negated.
+ */
+struct sat_solver {
+	size_t variables_count;	   ///< Number of variables.
+	size_t variables_capacity; ///< Number of variables the per-variable arrays can hold.
+	uint8_t *values;		   ///< Values of the variables, `SAT_VALUE_UNASSIGNED` if unassigned.
+	uint8_t *polarities;	   ///< Last values assigned to the variables.
+	size_t *levels;			   ///< Decision levels the variables were assigned at.
+	size_t *reasons;		   ///< Clauses that implied the variables, or `SAT_REASON_NONE`.
+	double *activities;		   ///< Activities of the variables.
+	double activity_increment; ///< Amount the activity of a variable is bumped by.
+	uint8_t *seen;			   ///< Marks used during conflict analysis.
+
+	size_t *heap;			///< Unassigned variables ordered by their activity.
+	size_t heap_length;		///< Number of variables in the heap.
+	size_t *heap_positions; ///< Positions of the variables in the heap, or `SIZE_MAX`.
+
+	uint32_t *trail;	  ///< Assigned literals in the order they were assigned in.
+	size_t trail_length;  ///< Number of assigned literals.
+	size_t propagated;	  ///< Number of literals of the trail that were propagated.
+	size_t *trail_limits; ///< Lengths of the trail at the start of each decision level.
+	size_t level;		  ///< Current decision level.
+
+	struct sat_watches {
+		size_t *data; ///< Clauses watching the literal's negation.
+		size_t length;
+		size_t capacity;
+	} *watches; ///< Watch lists of the literals.
+
+	uint32_t *clauses;		 ///< Arena of clauses, each one is its length followed by its literals.
+	size_t clauses_length;	 ///< Number of words of the arena that are in use.
+	size_t clauses_capacity; ///< Number of words the arena can hold.
+
+	uint32_t *learnt;	   ///< Scratch buffer for learnt clauses.
+	uint64_t conflicts;	   ///< Number of conflicts encountered so far.
+	bool unsatisfiable;	   ///< Whether the clauses are known to be unsatisfiable.
+	bool out_of_memory;	   ///< Whether memory ran out, after which every call fails.
+};
+
+#define SAT_VALUE_FALSE (0)
+#define SAT_VALUE_TRUE (1)
+#define SAT_VALUE_UNASSIGNED (2)
+#define SAT_REASON_NONE (SIZE_MAX)
+
+/**
+ * @brief Creates a literal.
+ *
+ * Returns the literal of the given variable, negated if `negated` is `true`.
+ *
+ * @param[in] variable The literal's variable.
+ * @param[in] negated Whether the literal is negated.
+ * @return The literal.
+ *
+ * @memberof sat_solver
+ */
+static inline uint32_t sat_literal(size_t variable, bool negated) {
+	assert(variable <= UINT32_MAX / 2);
+
+	return (uint32_t)(variable << 1U) | (uint32_t)negated;
+}
+
+/**
+ * @brief Creates a new solver.
+ *
+ * Initializes a new solver without any variables or clauses.
+ *
+ * @return The newly created solver.
+ *
+ * @memberof sat_solver
+ */
+struct sat_solver sat_solver_new(void);
+
+/**
+ * @brief Drops a solver.
+ *
+ * Releases all memory and resources owned by the solver.
+ *
+ * @param[in,out] solver The solver to drop.
+ *
+ * @memberof sat_solver
+ */
+void sat_solver_drop(struct sat_solver *solver);
+
+/**
+ * @brief Adds a variable to a solver.
+ *
+ * If memory runs out, `out_of_memory` is set and the returned index must not be relied on.
+ *
+ * @param[in,out] solver The solver the variable is added to.
+ * @return The index of the new variable.
+ *
+ * @memberof sat_solver
+ */
+size_t sat_solver_new_variable(struct sat_solver *solver);
+
+/**
+ * @brief Adds a clause to a solver.
+ *
+ * Adds the disjunction of the given literals to the solver's formula. Any assignment found by a
+ * previous call to `sat_solver_solve()` is discarded.
+ *
+ * @param[in,out] solver The solver the clause is added to.
+ * @param[in] literals The literals of the clause.
+ * @param[in] length The number of literals.
+ * @return `false` if the formula became unsatisfiable or memory ran out, `true` otherwise.
+ *
+ * @memberof sat_solver
+ */
+bool sat_solver_add_clause(struct sat_solver *solver, const uint32_t *literals, size_t length);
+
+/**
+ * @brief Solves the formula of a solver.
+ *
+ * Searches for an assignment that satisfies all the clauses added so far, which can then be read
+ * with `sat_solver_value()`.
+ *
+ * @param[in,out] solver The solver.
+ * @return `true` if the formula is satisfiable, `false` if it isn't or memory ran out, in which
+ * case `out_of_memory` is set.
+ *
+ * @memberof sat_solver
+ */
+bool sat_solver_solve(struct sat_solver *solver);
+
+/**
+ * @brief Retrieves the value of a variable.
+ *
+ * Returns the value of the variable in the assignment found by the last call to
+ * `sat_solver_solve()`, which must have succeeded.
+ *
+ * @param[in] solver The solver.
+ * @param[in] variable The variable's index.
+ * @return The value of the variable.
+ *
+ * @memberof sat_solver
+ */
+bool sat_solver_value(const struct sat_solver *solver, size_t variable);
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include <expression.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The version of the binary format, files of other versions are rejected.
+ */
+#define SERIAL_VERSION (1)
+
+/**
+ * @brief The kind of data a serialized buffer holds.
+ */
+enum serial_kind {
+	serial_kind_expression = 1, ///< A `struct expression`.
+	serial_kind_minterms,		///< A `struct minterms`.
+	serial_kind_implicants,		///< A `struct implicants` and the variables of its function.
+};
+
+/**
+ * @brief the header every serialized buffer starts with.
+ *
+ * The header is followed by the payload of its kind. An expression is a stream of `count` nodes in
+ * pre-order, every operation being followed by its operands. Minterms and implicants are the names
+ * of the `variables_count` variables, padded to a multiple of 8 bytes, followed by `count` minterms
+ * as 64-bit words or `count` implicants laid out like `struct implicant`.
+ *
+ * Everything is stored in the host's byte order and aligned to its size within the buffer, so that
+ * a buffer can be read in place, a buffer of the other byte order is rejected because its version
+ * doesn't match.
+ */
+struct serial_header {
+	char magic[8];			  ///< `"DGLBYTES"`, without a terminator.
+	uint32_t version;		  ///< `SERIAL_VERSION`.
+	uint32_t kind;			  ///< `enum serial_kind`.
+	uint64_t variables_count; ///< Number of variables of minterms and implicants, `0` otherwise.
+	uint64_t count;			  ///< Number of nodes, minterms or implicants.
+};
+
+/**
+ * @brief a serialized expression node.
+ */
+struct serial_node {
+	uint8_t type;			 ///< `enum expression_type`.
+	/// Value of a constant, name of a variable or `enum operation_type` of an operation.
+	uint8_t value;
+	uint16_t reserved;		 ///< Always `0`.
+	uint32_t operands_count; ///< Number of operands of an operation, `0` otherwise.
+};
+
+/**
+ * @brief a view of a serialized expression.
+ *
+ * This data structure refers to the nodes of a serialized expression where they are, for example
+ * in a mapped file, so that the expression can be evaluated without being rebuilt node by node.
+ */
+struct serial_expression {
+	const struct serial_node *nodes; ///< The nodes of the expression in pre-order.
+	size_t length;					 ///< Number of nodes.
+	size_t depth; ///< Largest number of values that are pending while the nodes are evaluated.
+};
+
+/**
+ * @brief Serializes an expression.
+ *
+ * @param[in] expression The expression to be serialized.
+ * @param[out] size Set to the size of the serialized expression in bytes.
+ * @return The newly allocated serialized expression, or `NULL` if memory ran out or an operation
+ * has more than `UINT32_MAX` operands.
+ *
+ * @memberof expression
+ */
+void *expression_serialize(const struct expression *expression, size_t *size);
+
+/**
+ * @brief Serializes minterms.
+ *
+ * @param[in] minterms The minterms to be serialized.
+ * @param[out] size Set to the size of the serialized minterms in bytes.
+ * @return The newly allocated serialized minterms, or `NULL` if memory ran out.
+ *
+ * @memberof minterms
+ */
+void *minterms_serialize(const struct minterms *minterms, size_t *size);
+
+/**
+ * @brief Serializes implicants.
+ *
+ * @param[in] implicants The implicants to be serialized.
+ * @param[in] variables The variables of the implicants' function.
+ * @param[out] size Set to the size of the serialized implicants in bytes.
+ * @return The newly allocated serialized implicants, or `NULL` if memory ran out.
+ *
+ * @memberof implicants
+ */
+void *implicants_serialize(
+	const struct implicants *implicants,
+	const struct variables *variables,
+	size_t *size
+);
+
+/**
+ * @brief Views a serialized expression.
+ *
+ * Checks that the buffer holds a well-formed expression in a single pass over its nodes, without
+ * copying them. The buffer must be aligned to 8 bytes, as mappings and allocations are, and must
+ * outlive the view.
+ *
+ * @param[in] data The serialized expression.
+ * @param[in] size The size of the buffer in bytes.
+ * @param[out] expression Set to the view of the expression on success.
+ * @return `true` if the buffer holds a valid expression, `false` otherwise.
+ *
+ * @memberof serial_expression
+ */
+bool serial_expression_view(const void *data, size_t size, struct serial_expression *expression);
+
+/**
+ * @brief Evaluates a serialized expression for 64 environments at once.
+ *
+ * Works like `expression_evaluate_parallel()`, the nodes are evaluated in a single backward pass.
+ *
+ * @param[in] expression The view of the expression.
+ * @param[in] variables The values of the variables, `VARIABLES_COUNT` words.
+ * @param[out] values Set to the results of the expression.
+ * @return `true` if the expression was evaluated, `false` if memory ran out.
+ *
+ * @memberof serial_expression
+ */
+bool serial_expression_evaluate_parallel(
+	const struct serial_expression *expression,
+	const uint64_t *variables,
+	uint64_t *values
+);
+
+/**
+ * @brief Rebuilds an expression from its view.
+ *
+ * @param[in] expression The view of the expression.
+ * @param[out] result Set to the newly built expression on success.
+ * @return `true` if the expression was rebuilt, `false` if memory ran out.
+ *
+ * @memberof serial_expression
+ */
+bool serial_expression_to_expression(
+	const struct serial_expression *expression,
+	struct expression *result
+);
+
+/**
+ * @brief Deserializes minterms.
+ *
+ * The minterms are copied out of the buffer in bulk, which must be aligned to 8 bytes.
+ *
+ * @param[in] data The serialized minterms.
+ * @param[in] size The size of the buffer in bytes.
+ * @param[out] minterms Set to the deserialized minterms on success.
+ * @return `true` if the buffer holds valid minterms, `false` if it doesn't or memory ran out.
+ *
+ * @memberof minterms
+ */
+bool minterms_deserialize(const void *data, size_t size, struct minterms *minterms);
+
+/**
+ * @brief Deserializes implicants.
+ *
+ * The implicants are copied out of the buffer in bulk, which must be aligned to 8 bytes.
+ *
+ * @param[in] data The serialized implicants.
+ * @param[in] size The size of the buffer in bytes.
+ * @param[out] implicants Set to the deserialized implicants on success.
+ * @param[out] variables Set to the variables of the implicants' function on success.
+ * @return `true` if the buffer holds valid implicants, whose values and masks don't have bits
+ * beyond the variables, `false` if it doesn't or memory ran out.
+ *
+ * @memberof implicants
+ */
+bool implicants_deserialize(
+	const void *data,
+	size_t size,
+	struct implicants *implicants,
+	struct variables *variables
+);
+
+/**
+ * @brief Maps a file into memory for reading.
+ *
+ * @param[in] path The path of the file.
+ * @param[out] data Set to the mapping of the file on success, page-aligned.
+ * @param[out] size Set to the size of the file in bytes on success.
+ * @return `true` if the file was mapped, `false` otherwise, in which case an error is printed.
+ */
+bool serial_map(const char *path, void **data, size_t *size);
+
+/**
+ * @brief Unmaps a file that was mapped with `serial_map()`.
+ *
+ * @param[in] data The mapping of the file.
+ * @param[in] size The size of the file in bytes.
+ */
+void serial_unmap(void *data, size_t size);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <budget.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <store.h>
+
+/**
+ * @brief The largest payload of a request in bytes, a connection that sends a longer one is closed.
+ */
+#define SERVER_PAYLOAD_LIMIT ((size_t)1 << 24)
+
+/**
+ * @brief The number of results every worker keeps in its cache.
+ */
+#define SERVER_CACHE_SLOTS (256)
+
+/**
+ * @brief The type of a request.
+ */
+enum server_request {
+	/// Minimizes an expression or a function given by its minterms, see `minterms_from_string()`,
+	/// the response is the minimal sum of products.
+	server_request_minimize = 'm',
+	/// Evaluates an expression, the payload is the expression followed by a null character and the
+	/// names of the variables that are true, the response is `0` or `1`.
+	server_request_evaluate = 'e',
+	/// Builds the truth table of an expression, the response is the table in the format accepted by
+	/// `minterms_from_string()`, `f(a, b) = 0x8`.
+	server_request_truth_table = 't',
+};
+
+/**
+ * @brief The status of a response.
+ */
+enum server_status {
+	server_status_ok,		  ///< The request succeeded.
+	server_status_incomplete, ///< The budget was exceeded, the cover isn't minimal.
+	server_status_error,	  ///< The request failed, the payload is an error message.
+};
+
+/**
+ * @brief Serves requests over a Unix domain socket.
+ *
+ * Listens on a socket at `path` until the process receives `SIGINT` or `SIGTERM`. Every message is
+ * a frame made of the length of its payload as a 32-bit little-endian number, a byte that is the
+ * type of a request or the status of a response, and the payload. A client may send any number of
+ * requests without waiting, each is answered by exactly one response, in order.
+ *
+ * A single thread waits for all the connections with `epoll`, and the requests are handled by a
+ * pool of workers so that requests of different clients are handled in parallel. The process stays
+ * warm between requests, and every worker caches its latest results, so that repeated requests are
+ * answered without being handled again. The workers share the store, which is safe to look up
+ * and insert into from all of them at once.
+ *
+ * @param[in] path The path of the socket, an existing socket at it is replaced.
+ * @param[in] workers_count The number of worker threads, at least `1`.
+ * @param[in] budget The limits of every minimization.
+ * @param[in,out] store The store that minimizations are looked up in and inserted into, opened as
+ * writable, or `NULL`.
+ * @return `true` if the server shut down cleanly, `false` if it failed to start.
+ */
+bool server_run(
+	const char *path,
+	size_t workers_count,
+	struct budget budget,
+	struct store *store
+);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <expression.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * @brief The number of 64-bit words of a block of vectors, vectors are simulated a block at a time.
+ */
+#define SIMULATION_BLOCK_WORDS (64)
+
+/**
+ * @brief Simulates an expression over a file of test vectors.
+ *
+ * Every line of `vectors` is a vector made of a column of `0` or `1` per input, columns may be
+ * separated by whitespace. The columns are the variables of the expression in alphabetical order,
+ * unless the first line is a header `.inputs` followed by the names of the columns, in which case
+ * columns of variables that don't occur in the expression are ignored. Comments start with `#` and
+ * blank lines are skipped.
+ *
+ * The vectors are transposed into a word per variable for every 64 vectors and the expression is
+ * evaluated bit-parallel over blocks of `SIMULATION_BLOCK_WORDS` words, see
+ * `expression_pool_evaluate_block()`. The value of the expression for every vector is written to
+ * `results` as a line holding `0` or `1`.
+ *
+ * @param[in] expression The expression to be simulated.
+ * @param[in] vectors The file the vectors are read from.
+ * @param[in] results The file the values are written to.
+ * @return `true` if every vector was simulated, `false` otherwise, in which case an error is
+ * printed.
+ */
+bool simulation_run(const struct expression *expression, FILE *vectors, FILE *results);
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <allocator.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief A stage of the minimization pipeline.
+ */
+enum stats_stage {
+	stats_stage_parse,			  ///< Parsing expressions, `expression_from_string()`.
+	stats_stage_enumeration,	  ///< Enumerating minterms, `minterms_from_expression()`.
+	stats_stage_prime_implicants, ///< Finding prime implicants, `minterms_to_prime_implicants()`.
+	stats_stage_minimalize,		  ///< Selecting a cover, `implicants_minimalize()`.
+	stats_stage_output,			  ///< Building and printing the results.
+};
+
+#define STATS_STAGES_COUNT (5)
+
+/**
+ * @brief An amount of time.
+ */
+struct stats_time {
+	double wall; ///< Elapsed wall-clock seconds.
+	double cpu;	 ///< Elapsed seconds of cpu time of the calling thread.
+};
+
+/**
+ * @brief Performance counters.
+ *
+ * This data structure represents the counters collected by the calling thread while statistics are
+ * enabled. Every stage accumulates the time spent in it and the allocations made while it was the
+ * innermost running stage, and every pass of the Quine-McCluskey algorithm is recorded separately.
+ */
+struct stats {
+	struct stats_stage_counters {
+		uint64_t calls;		  ///< Number of times the stage ran.
+		struct stats_time time; ///< Total time spent in the stage.
+		uint64_t allocations; ///< Number of allocations made in the stage.
+		int64_t bytes;		  ///< Number of bytes the stage left allocated, in total.
+		size_t peak_bytes;	  ///< Largest number of bytes allocated at once in the stage.
+	} stages[STATS_STAGES_COUNT]; ///< Counters of the stages.
+
+	struct stats_pass {
+		struct stats_time time; ///< Total time spent in the pass.
+		uint64_t implicants;	///< Number of implicants the pass started with.
+		uint64_t combined;		///< Number of implicants the pass combined them into.
+		uint64_t primes;		///< Number of prime implicants the pass found.
+	} *passes;				///< Counters of the passes, accumulated over all the runs.
+	size_t passes_length;	///< Number of passes.
+	size_t passes_capacity; ///< Number of passes the array can hold.
+
+	uint64_t duplicates;  ///< Number of duplicate implicants rejected by `table_add_implicant()`.
+	uint64_t allocations; ///< Number of allocations made in total.
+
+	/// The innermost running stage, or `STATS_STAGES_COUNT` outside of any stage.
+	enum stats_stage stage;
+};
+
+/**
+ * @brief A running stage or pass.
+ */
+struct stats_span {
+	struct stats_time start; ///< Time the span started at.
+	size_t bytes;			 ///< Number of bytes allocated when the span started.
+	enum stats_stage stage;	 ///< The stage that is running.
+	enum stats_stage parent; ///< The stage that was running when the span started.
+};
+
+/**
+ * @brief Whether statistics are collected.
+ *
+ * Must only be set before any work starts, every counter is a single predictable branch while it is
+ * `false`. Spans are also recorded to the trace when one is being written, see `trace_open()`.
+ */
+extern bool stats_enabled;
+
+/**
+ * @brief The counters of the calling thread.
+ */
+extern _Thread_local struct stats stats;
+
+/**
+ * @brief Reads the current time.
+ *
+ * @return The current wall-clock time and cpu time of the calling thread.
+ *
+ * @memberof stats
+ */
+struct stats_time stats_time_now(void);
+
+/**
+ * @brief Starts timing a stage.
+ *
+ * Makes `stage` the innermost running stage until the returned span is passed to `stats_end()`.
+ * Does nothing if statistics are disabled.
+ *
+ * @param[in] stage The stage that starts.
+ * @return The running span.
+ *
+ * @memberof stats
+ */
+static inline struct stats_span stats_begin(enum stats_stage stage) {
+	struct stats_span span = { .start = { 0 }, .bytes = 0, .stage = stage, .parent = stage };
+	if (stats_enabled) {
+		span.start = stats_time_now();
+		span.bytes = allocator_usage.bytes;
+		span.parent = stats.stage;
+		stats.stage = stage;
+	}
+	return span;
+}
+
+/**
+ * @brief Finishes timing a stage.
+ *
+ * Adds the time since `span` started to its stage and makes the previously running stage the
+ * innermost one again. Does nothing if statistics are disabled.
+ *
+ * @param[in] span The span returned by `stats_begin()`.
+ *
+ * @memberof stats
+ */
+void stats_end(struct stats_span span);
+
+/**
+ * @brief Finishes timing a pass of the Quine-McCluskey algorithm.
+ *
+ * Adds the time since `span` started and the pass's counts to the counters of the `pass`th pass.
+ * Does nothing if statistics are disabled.
+ *
+ * @param[in] span The span returned by `stats_begin()` when the pass started.
+ * @param[in] pass The index of the pass.
+ * @param[in] implicants The number of implicants the pass started with.
+ * @param[in] combined The number of implicants the pass combined them into.
+ * @param[in] primes The number of prime implicants the pass found.
+ *
+ * @memberof stats
+ */
+void stats_end_pass(
+	struct stats_span span,
+	size_t pass,
+	size_t implicants,
+	size_t combined,
+	size_t primes
+);
+
+/**
+ * @brief Counts an allocation.
+ *
+ * @param[in] bytes The number of bytes allocated after the allocation.
+ *
+ * @memberof stats
+ */
+static inline void stats_count_allocation(size_t bytes) {
+	if (stats_enabled) {
+		stats.allocations++;
+		if (stats.stage != STATS_STAGES_COUNT) {
+			struct stats_stage_counters *counters = &stats.stages[stats.stage];
+			counters->allocations++;
+			if (bytes > counters->peak_bytes) {
+				counters->peak_bytes = bytes;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Counts a rejected duplicate implicant.
+ *
+ * @memberof stats
+ */
+static inline void stats_count_duplicate(void) {
+	if (stats_enabled) {
+		stats.duplicates++;
+	}
+}
+
+/**
+ * @brief Merges the counters of the calling thread into the totals.
+ *
+ * Adds the counters of the calling thread to those of the threads that finished before it and drops
+ * them. Must be called by every thread other than the one that prints the counters before it exits.
+ *
+ * @memberof stats
+ */
+void stats_merge(void);
+
+/**
+ * @brief Prints the counters.
+ *
+ * Writes the counters of the calling thread, added to those merged from other threads by
+ * `stats_merge()`, to `file` as a single JSON object.
+ *
+ * @param[in] file The file the counters are written to.
+ *
+ * @memberof stats
+ */
+void stats_print(FILE *file);
+
+/**
+ * @brief Drops the counters of the calling thread and the merged totals.
+ *
+ * Releases all memory owned by the counters and resets them.
+ *
+ * @memberof stats
+ */
+void stats_drop(void);
+
+#endif
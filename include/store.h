@@ -0,0 +1,104 @@
+#ifndef STORE_H
+#define STORE_H
+
+#include <expression.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief a persistent result store.
+ *
+ * This data structure represents an append-only file of minimization results that is memory-mapped
+ * into the process. Each record is keyed by a hash of the minimized function's truth table (the
+ * number of variables and its minterms) and holds the minimal list of implicants for it, laid out
+ * exactly like `struct implicant` so that lookups return a pointer into the mapping without any
+ * deserialization.
+ *
+ * Any number of processes may read the store concurrently while another appends to it, writers
+ * serialize among themselves with an exclusive lock on the file. Within a process, any number of
+ * threads may look up and insert records through the same store. The file is stored in the host's
+ * byte order.
+ *
+ * The file is remapped as it grows, but earlier mappings are only unmapped when the store is
+ * closed, so the views returned by `store_lookup()` stay valid until then.
+ */
+struct store {
+	int file_descriptor; ///< Descriptor of the store's file.
+	bool writable;		 ///< Whether the store was opened for appending.
+	unsigned char *data; ///< The latest mapping of the store's file.
+	size_t size;		 ///< Size of the latest mapping in bytes.
+	struct store_mapping {
+		unsigned char *data;
+		size_t size;
+	} *retired;					   ///< Earlier mappings, which views may still point into.
+	size_t retired_length;		   ///< Number of earlier mappings.
+	pthread_mutex_t mapping_mutex; ///< Protects the mappings while they are replaced.
+	pthread_mutex_t insert_mutex;  ///< Serializes the threads that append to the store.
+};
+
+/**
+ * @brief Opens a store.
+ *
+ * Maps the store at `path` into memory. If `writable` is `true` the file is created if it doesn't
+ * exist and records can be appended to it with `store_insert()`.
+ *
+ * @param[out] store The store to be opened.
+ * @param[in] path Path of the store's file.
+ * @param[in] writable Whether records are going to be appended to the store.
+ * @return `true` if the store was opened, `false` otherwise.
+ *
+ * @memberof store
+ */
+bool store_open(struct store *store, const char *path, bool writable);
+
+/**
+ * @brief Closes a store.
+ *
+ * Unmaps the store and releases all resources owned by it.
+ *
+ * @param[in,out] store The store to be closed.
+ *
+ * @memberof store
+ */
+void store_close(struct store *store);
+
+/**
+ * @brief Looks up the minimal implicants of a function.
+ *
+ * Searches the store for the function described by `minterms`. On success `implicants` is set to a
+ * borrowed view into the mapping, it must not be dropped and is valid until the store is closed.
+ *
+ * @param[in,out] store The store to be searched.
+ * @param[in] minterms The minterms of the function.
+ * @param[out] implicants The minimal implicants of the function.
+ * @return `true` if the function was found, `false` otherwise.
+ *
+ * @memberof store
+ */
+bool store_lookup(
+	struct store *store,
+	const struct minterms *minterms,
+	struct implicants *implicants
+);
+
+/**
+ * @brief Inserts the minimal implicants of a function.
+ *
+ * Appends a record mapping the function described by `minterms` to `implicants`, unless the store
+ * already contains one. The store must have been opened as writable.
+ *
+ * @param[in,out] store The store to be appended to.
+ * @param[in] minterms The minterms of the function.
+ * @param[in] implicants The minimal implicants of the function.
+ * @return `true` if the store contains the record afterwards, `false` otherwise.
+ *
+ * @memberof store
+ */
+bool store_insert(
+	struct store *store,
+	const struct minterms *minterms,
+	const struct implicants *implicants
+);
+
+#endif
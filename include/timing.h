@@ -0,0 +1,169 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <environment.h>
+#include <expression.h>
+#include <expression_pool.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector/declare.h>
+
+/**
+ * @brief The number of operation types, the length of a table of delays per operation type.
+ */
+#define TIMING_OPERATIONS_COUNT ((size_t)operation_type_implication + 1)
+
+/**
+ * @brief a gate-level netlist.
+ *
+ * This data structure represents a set of expressions as a circuit, every variable is an input,
+ * every operation is a gate with a delay in ticks and the roots of the expressions are the outputs.
+ * The expressions share a pool, so that identical sub-expressions are a single gate with a fanout
+ * of more than one.
+ */
+struct timing_netlist {
+	struct expression_pool pool; ///< The nets, a node per input, constant and gate.
+	uint32_t *delays;			 ///< Delay of every node, `0` for inputs and constants.
+	/// Positions of the nodes' first fanouts in `fanouts`, `pool.length + 1` elements.
+	uint32_t *fanouts_starts;
+	uint32_t *fanouts;			   ///< The gates every node is an operand of.
+	uint32_t inputs[VARIABLES_COUNT]; ///< Node of every variable, or `EXPRESSION_POOL_NONE`.
+	uint32_t *outputs;			   ///< Node of every output.
+	size_t outputs_count;		   ///< Number of outputs.
+	/// Positions of the nodes' first outputs in `outputs_of`, `pool.length + 1` elements.
+	uint32_t *outputs_starts;
+	uint32_t *outputs_of; ///< The outputs every node is, grouped by node.
+};
+
+/**
+ * @brief Creates a netlist from expressions.
+ *
+ * @param[in] expressions The expressions of the outputs.
+ * @param[in] expressions_count The number of expressions.
+ * @param[in] delays The delay of a gate of every operation type in ticks, `TIMING_OPERATIONS_COUNT`
+ * elements that are all at least `1`, or `NULL` for a delay of `1` for every gate. The delays of
+ * single gates can be changed in `delays` afterwards.
+ * @return The newly created netlist.
+ *
+ * @memberof timing_netlist
+ */
+struct timing_netlist timing_netlist_new(
+	const struct expression *expressions,
+	size_t expressions_count,
+	const uint32_t *delays
+);
+
+/**
+ * @brief Drops a netlist.
+ *
+ * Releases all memory and resources owned by the netlist.
+ *
+ * @param[in,out] netlist The netlist to drop.
+ *
+ * @memberof timing_netlist
+ */
+void timing_netlist_drop(struct timing_netlist *netlist);
+
+/**
+ * @brief a change of the value of a net.
+ */
+struct timing_change {
+	uint64_t time; ///< The tick the net changed at.
+	bool value;	   ///< The net's new value.
+};
+
+VECTOR_DECLARE(timing_changes, struct timing_change)
+
+/**
+ * @brief a scheduled change of the value of a net.
+ */
+struct timing_event {
+	uint32_t node; ///< The net that changes.
+	bool value;	   ///< The net's new value.
+};
+
+VECTOR_DECLARE(timing_events, struct timing_event)
+
+/**
+ * @brief an event-driven simulator of a netlist.
+ *
+ * This data structure represents the state of a netlist whose inputs change over time. Changes are
+ * scheduled on a timing wheel with a slot per tick that is longer than the largest delay of the
+ * netlist, so that scheduling and retrieving an event takes constant time. Only the gates whose
+ * operands changed in a tick are evaluated, and a gate whose new value differs from its last
+ * scheduled one schedules a change after its delay. Delays are transport delays, so pulses shorter
+ * than a gate's delay pass through it and glitches show in the waveforms.
+ */
+struct timing_simulator {
+	const struct timing_netlist *netlist; ///< The simulated netlist.
+	bool *values;		  ///< Current value of every node.
+	bool *projected;	  ///< Value of every node after its scheduled changes.
+	uint64_t *stamps;	  ///< Tick plus one every gate was last queued for evaluation at.
+	uint32_t *evaluated;  ///< The gates queued for evaluation in the current tick.
+	struct timing_events *wheel; ///< The events of every slot of the wheel.
+	size_t wheel_mask;	  ///< Number of slots of the wheel minus one, a power of two minus one.
+	size_t pending;		  ///< Number of scheduled events.
+	uint64_t time;		  ///< The next tick to be simulated.
+	uint64_t settle_time; ///< The last tick any net changed at.
+	uint64_t events_count;				 ///< Number of events that changed a net.
+	struct timing_changes *waveforms;	 ///< Changes of every output, starting at tick `0`.
+};
+
+/**
+ * @brief Creates a new simulator.
+ *
+ * Starts the netlist at tick `0` with every input being false and every gate settled.
+ *
+ * @param[in] netlist The netlist to be simulated, must outlive the simulator.
+ * @return The newly created simulator.
+ *
+ * @memberof timing_simulator
+ */
+struct timing_simulator timing_simulator_new(const struct timing_netlist *netlist);
+
+/**
+ * @brief Drops a simulator.
+ *
+ * Releases all memory and resources owned by the simulator.
+ *
+ * @param[in,out] simulator The simulator to drop.
+ *
+ * @memberof timing_simulator
+ */
+void timing_simulator_drop(struct timing_simulator *simulator);
+
+/**
+ * @brief Changes an input of a simulator.
+ *
+ * Simulates the ticks before `time` and schedules the change of the input, changes of inputs that
+ * don't occur in the netlist are ignored.
+ *
+ * @param[in,out] simulator The simulator.
+ * @param[in] time The tick the input changes at, must not be before the ticks that were already
+ * simulated.
+ * @param[in] name The input's name.
+ * @param[in] value The input's new value.
+ *
+ * @memberof timing_simulator
+ */
+void timing_simulator_set(
+	struct timing_simulator *simulator,
+	uint64_t time,
+	char name,
+	bool value
+);
+
+/**
+ * @brief Simulates a netlist until it settles.
+ *
+ * Simulates the ticks until there are no scheduled events left.
+ *
+ * @param[in,out] simulator The simulator.
+ * @return The last tick any net changed at.
+ *
+ * @memberof timing_simulator
+ */
+uint64_t timing_simulator_settle(struct timing_simulator *simulator);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stats.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Whether a trace is being written.
+ *
+ * Set by `trace_open()` and cleared by `trace_close()`, spans are only recorded while it is `true`.
+ */
+extern bool trace_enabled;
+
+/**
+ * @brief Starts writing a trace.
+ *
+ * Creates the file at `path` and writes the spans recorded until `trace_close()` to it in the
+ * Chrome trace-event format, which can be loaded into `chrome://tracing` or Perfetto. Every thread
+ * that records a span gets its own track, the calling thread's is labeled `main` and the others'
+ * `worker N` in the order they record their first span.
+ *
+ * @param[in] path Path of the trace's file.
+ * @return `true` if the trace was started, `false` otherwise.
+ */
+bool trace_open(const char *path);
+
+/**
+ * @brief Finishes writing a trace.
+ *
+ * Terminates the trace and closes its file. Does nothing if no trace is being written.
+ */
+void trace_close(void);
+
+/**
+ * @brief Records a span.
+ *
+ * Adds a complete event to the calling thread's track. Does nothing if no trace is being written.
+ *
+ * @param[in] name The name of the span.
+ * @param[in] index The index of the span among the spans with the same name, shown as an argument.
+ * @param[in] start The time the span started at, as returned by `stats_time_now()`.
+ * @param[in] end The time the span ended at, as returned by `stats_time_now()`.
+ */
+void trace_span(const char *name, size_t index, struct stats_time start, struct stats_time end);
+
+#endif
@@ -1,18 +1,49 @@
 #ifndef VECTOR_DECLARE_H
 #define VECTOR_DECLARE_H
 
+#include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
 
-#define VECTOR_DECLARE(name, type)                                                                 \
+/**
+ * @brief Declares a vector named `name` of elements of type `type`.
+ *
+ * An optional third argument gives the number of elements the vector holds inline, `1` by default,
+ * it only allocates once it grows past them. Since the vector may be copied around by value, its
+ * elements are reached through `name_elements()` or `name_const_elements()`, which are only valid
+ * until the vector is changed.
+ */
+#define VECTOR_DECLARE(...) VECTOR_DECLARE_(__VA_ARGS__, 1, )
+#define VECTOR_DECLARE_(name, type, inline_capacity, ...)                                          \
 	typedef type name##_type;                                                                      \
 	struct name {                                                                                  \
-		name##_type *elements;                                                                     \
+		union {                                                                                    \
+			name##_type *heap;                                                                     \
+			name##_type buffer[inline_capacity];                                                   \
+		} storage;                                                                                 \
 		size_t length;                                                                             \
 		size_t capacity;                                                                           \
 	};                                                                                             \
+	static inline size_t name##_inline_capacity(void) {                                            \
+		return sizeof(((struct name *)NULL)->storage.buffer) / sizeof(name##_type);                \
+	}                                                                                              \
+	static inline name##_type *name##_elements(struct name *self) {                                \
+		assert(self != NULL);                                                                      \
+                                                                                                   \
+		return self->capacity > name##_inline_capacity() ? self->storage.heap                      \
+														 : self->storage.buffer;                   \
+	}                                                                                              \
+	static inline const name##_type *name##_const_elements(const struct name *self) {              \
+		assert(self != NULL);                                                                      \
+                                                                                                   \
+		return self->capacity > name##_inline_capacity() ? self->storage.heap                      \
+														 : self->storage.buffer;                   \
+	}                                                                                              \
 	struct name name##_new(void);                                                                  \
 	void name##_drop(struct name *self);                                                           \
+	bool name##_reserve(struct name *self, size_t capacity);                                       \
+	void name##_shrink(struct name *self);                                                         \
+	bool name##_append(struct name *self, const name##_type *elements, size_t length);             \
 	bool name##_insert(                                                                            \
 		struct name *self,                                                                         \
 		size_t index,                                                                              \
@@ -1,34 +1,88 @@
 #ifndef VECTOR_DEFINE_H
 #define VECTOR_DEFINE_H
 
+#include <allocator.h>
 #include <assert.h>
 #include <stdint.h>
-#include <stdlib.h>
 #include <string.h>
 
 #define VECTOR_DEFINE(...) VECTOR_DEFINE_(__VA_ARGS__, NULL, )
 #define VECTOR_DEFINE_(name, drop, ...)                                                            \
 	struct name name##_new(void) {                                                                 \
 		return (struct name){                                                                      \
-			.elements = NULL,                                                                      \
 			.length = 0,                                                                           \
-			.capacity = 0,                                                                         \
+			.capacity = name##_inline_capacity(),                                                  \
 		};                                                                                         \
 	}                                                                                              \
 	void name##_drop(struct name *self) {                                                          \
 		assert(self != NULL);                                                                      \
                                                                                                    \
 		if ((drop) != NULL) {                                                                      \
+			name##_type *elements = name##_elements(self);                                         \
 			for (size_t i = 0; i < self->length; i++) {                                            \
-				((void (*)(name##_type *))(drop))(&self->elements[i]);                             \
+				((void (*)(name##_type *))(drop))(&elements[i]);                                   \
 			}                                                                                      \
 		}                                                                                          \
-		free(self->elements);                                                                      \
+		if (self->capacity > name##_inline_capacity()) {                                           \
+			allocator_free(self->storage.heap);                                                    \
+		}                                                                                          \
+	}                                                                                              \
+	bool name##_reserve(struct name *self, size_t capacity) {                                      \
+		assert(self != NULL);                                                                      \
+                                                                                                   \
+		if (capacity <= self->capacity) {                                                          \
+			return true;                                                                           \
+		}                                                                                          \
+		if (capacity > SIZE_MAX / sizeof(name##_type)) {                                           \
+			return false;                                                                          \
+		}                                                                                          \
+                                                                                                   \
+		name##_type *elements;                                                                     \
+		if (self->capacity > name##_inline_capacity()) {                                           \
+			elements = allocator_reallocate(self->storage.heap, capacity * sizeof(*elements));     \
+			if (elements == NULL) {                                                                \
+				return false;                                                                      \
+			}                                                                                      \
+		} else {                                                                                   \
+			elements = allocator_allocate(capacity * sizeof(*elements));                           \
+			if (elements == NULL) {                                                                \
+				return false;                                                                      \
+			}                                                                                      \
+			memcpy(elements, self->storage.buffer, self->length * sizeof(*elements));              \
+		}                                                                                          \
+                                                                                                   \
+		self->storage.heap = elements;                                                             \
+		self->capacity = capacity;                                                                 \
+                                                                                                   \
+		return true;                                                                               \
+	}                                                                                              \
+	void name##_shrink(struct name *self) {                                                        \
+		assert(self != NULL);                                                                      \
+                                                                                                   \
+		if (self->capacity <= name##_inline_capacity() || self->length == self->capacity) {        \
+			return;                                                                                \
+		}                                                                                          \
+                                                                                                   \
+		/* the pointer shares its storage with the buffer, so it's kept aside while copying */     \
+		name##_type *heap = self->storage.heap;                                                    \
+		if (self->length <= name##_inline_capacity()) {                                            \
+			memcpy(self->storage.buffer, heap, self->length * sizeof(*heap));                      \
+			allocator_free(heap);                                                                  \
+			self->capacity = name##_inline_capacity();                                             \
+			return;                                                                                \
+		}                                                                                          \
+                                                                                                   \
+		/* if the memory can't be given back, the vector keeps it */                               \
+		name##_type *elements = allocator_reallocate(heap, self->length * sizeof(*heap));          \
+		if (elements != NULL) {                                                                    \
+			self->storage.heap = elements;                                                         \
+			self->capacity = self->length;                                                         \
+		}                                                                                          \
 	}                                                                                              \
 	static bool name##_expand(struct name *self, size_t length) {                                  \
 		assert(self != NULL);                                                                      \
                                                                                                    \
-		if (length > SIZE_MAX / sizeof(*self->elements)) {                                         \
+		if (length > SIZE_MAX / sizeof(name##_type)) {                                             \
 			return false;                                                                          \
 		}                                                                                          \
                                                                                                    \
@@ -36,22 +90,14 @@
 		do {                                                                                       \
 			if (capacity == 0) {                                                                   \
 				capacity = 1;                                                                      \
-			} else if (capacity > SIZE_MAX / sizeof(*self->elements) / 2) {                        \
-				capacity = SIZE_MAX / sizeof(*self->elements);                                     \
+			} else if (capacity > SIZE_MAX / sizeof(name##_type) / 2) {                            \
+				capacity = SIZE_MAX / sizeof(name##_type);                                         \
 			} else {                                                                               \
 				capacity *= 2;                                                                     \
 			}                                                                                      \
 		} while (capacity < length);                                                               \
                                                                                                    \
-		name##_type *elements = realloc(self->elements, capacity * sizeof(*self->elements));       \
-		if (elements == NULL) {                                                                    \
-			return false;                                                                          \
-		}                                                                                          \
-                                                                                                   \
-		self->elements = elements;                                                                 \
-		self->capacity = capacity;                                                                 \
-                                                                                                   \
-		return true;                                                                               \
+		return name##_reserve(self, capacity);                                                     \
 	}                                                                                              \
 	bool name##_insert(                                                                            \
 		struct name *self,                                                                         \
@@ -70,29 +116,32 @@
 			return false;                                                                          \
 		}                                                                                          \
                                                                                                    \
-		memmove(                                                                                   \
-			&self->elements[index + length],                                                       \
-			&self->elements[index],                                                                \
-			(self->length - index) * sizeof(*self->elements)                                       \
-		);                                                                                         \
-		memmove(&self->elements[index], elements, length * sizeof(*self->elements));               \
+		name##_type *data = name##_elements(self);                                                 \
+		memmove(&data[index + length], &data[index], (self->length - index) * sizeof(*data));      \
+		memmove(&data[index], elements, length * sizeof(*data));                                   \
                                                                                                    \
 		self->length += length;                                                                    \
                                                                                                    \
 		return true;                                                                               \
 	}                                                                                              \
+	bool name##_append(struct name *self, const name##_type *elements, size_t length) {            \
+		assert(self != NULL);                                                                      \
+                                                                                                   \
+		return name##_insert(self, self->length, elements, length);                                \
+	}                                                                                              \
 	void name##_remove(struct name *self, size_t index, size_t length) {                           \
 		assert(self != NULL && index < self->length && length <= self->length - index);            \
                                                                                                    \
+		name##_type *data = name##_elements(self);                                                 \
 		if ((drop) != NULL) {                                                                      \
 			for (size_t i = index; i < index + length; i++) {                                      \
-				((void (*)(name##_type *))(drop))(&self->elements[i]);                             \
+				((void (*)(name##_type *))(drop))(&data[i]);                                       \
 			}                                                                                      \
 		}                                                                                          \
 		memmove(                                                                                   \
-			&self->elements[index],                                                                \
-			&self->elements[index + length],                                                       \
-			(self->length - index) * sizeof(*self->elements)                                       \
+			&data[index],                                                                          \
+			&data[index + length],                                                                 \
+			(self->length - index - length) * sizeof(*data)                                        \
 		);                                                                                         \
                                                                                                    \
 		self->length -= length;                                                                    \
@@ -0,0 +1,142 @@
+#ifndef ZDD_H
+#define ZDD_H
+
+#include <expression.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The index of a node that couldn't be made because memory ran out or the budget was
+ * exceeded.
+ */
+#define ZDD_NONE (UINT32_MAX)
+
+/**
+ * @brief The false function, or the empty set of cubes.
+ */
+#define ZDD_EMPTY (0)
+
+/**
+ * @brief The true function, or the set made of the cube without literals.
+ */
+#define ZDD_BASE (1)
+
+/**
+ * @brief an entry of the cache of operations of a decision diagram.
+ */
+struct zdd_cache_entry {
+	uint32_t operation; ///< The operation, `0` if the entry is empty.
+	uint32_t operand_1; ///< The first operand.
+	uint32_t operand_2; ///< The second operand.
+	uint32_t result;	///< The result.
+};
+
+/**
+ * @brief a store of decision diagrams.
+ *
+ * This data structure holds binary decision diagrams of functions and zero-suppressed decision
+ * diagrams of sets of cubes in shared parallel arrays of nodes. Nodes are referred to by their
+ * 32-bit index, are hash-consed and are never freed before the store is dropped, so that equal
+ * diagrams are the same node and every node comes after its children.
+ *
+ * A node of a function tests the `i`th variable, the first one being the most significant bit of a
+ * minterm, and a node of a set of cubes tests the literal `2 * i` of the `i`th variable, or its
+ * complement `2 * i + 1`, its high child being the cubes that contain the literal. A set of cubes
+ * takes space proportional to the structure it shares rather than to the number of its cubes, so
+ * sets can be far larger than the memory that listing them would take.
+ */
+struct zdd {
+	size_t variables_count; ///< Number of variables of the functions.
+	size_t length;			///< Number of nodes.
+	size_t capacity;		///< Number of nodes the arrays can hold.
+	uint32_t *variables;	///< Variable or literal of every node, `UINT32_MAX` for the terminals.
+	uint32_t *lows;			///< Child of every node where its variable is false or literal absent.
+	uint32_t *highs;		///< Child of every node where its variable is true or literal present.
+
+	uint32_t *buckets;	  ///< Hash table of the nodes, `ZDD_NONE` if empty.
+	size_t buckets_count; ///< Number of buckets, a power of two.
+
+	struct zdd_cache_entry *cache; ///< Results of operations, `buckets_count` entries.
+
+	bool failed; ///< Whether memory ran out or the budget was exceeded.
+};
+
+/**
+ * @brief Creates a new store.
+ *
+ * @param[in] variables_count The number of variables of the functions, at most `64`.
+ * @return The newly created store, with only the two terminals.
+ *
+ * @memberof zdd
+ */
+struct zdd zdd_new(size_t variables_count);
+
+/**
+ * @brief Drops a store.
+ *
+ * Releases all memory and resources owned by the store.
+ *
+ * @param[in,out] zdd The store to drop.
+ *
+ * @memberof zdd
+ */
+void zdd_drop(struct zdd *zdd);
+
+/**
+ * @brief Builds the decision diagram of a function.
+ *
+ * @param[in,out] zdd The store, with as many variables as the function.
+ * @param[in] minterms The minterms of the function.
+ * @return The root of the function's diagram, or `ZDD_NONE` on failure.
+ *
+ * @memberof zdd
+ */
+uint32_t zdd_from_minterms(struct zdd *zdd, const struct minterms *minterms);
+
+/**
+ * @brief Computes the prime implicants of a function.
+ *
+ * Computes the set of prime implicants implicitly, in the manner of Coudert and Madre. The primes
+ * of `f` that don't depend on its first variable `x` are the primes of `f0 f1`, where `f0` and `f1`
+ * are its cofactors, and the others are `x'` or `x` times the primes of `f0` or `f1` that aren't
+ * primes of `f0 f1`.
+ *
+ * Checks the budget of the calling thread every few nodes, see `budget_exceeded()`.
+ *
+ * @param[in,out] zdd The store.
+ * @param[in] function The root of the function's diagram.
+ * @return The root of the set of prime implicants, or `ZDD_NONE` on failure.
+ *
+ * @memberof zdd
+ */
+uint32_t zdd_prime_implicants(struct zdd *zdd, uint32_t function);
+
+/**
+ * @brief Counts the cubes of a set.
+ *
+ * @param[in] zdd The store.
+ * @param[in] set The root of the set.
+ * @param[out] count Set to the number of cubes, approximately if it's beyond 2^53.
+ * @return `true` if the cubes were counted, `false` if memory ran out.
+ *
+ * @memberof zdd
+ */
+bool zdd_count(const struct zdd *zdd, uint32_t set, double *count);
+
+/**
+ * @brief Lists the cubes of a set.
+ *
+ * Adds every cube of the set to `implicants`. Checks the budget of the calling thread every 64
+ * cubes, see `budget_exceeded()`.
+ *
+ * @param[in] zdd The store.
+ * @param[in] set The root of the set.
+ * @param[in,out] implicants The implicants the cubes are added to.
+ * @return `true` if every cube was added, `false` if memory ran out or the budget was exceeded.
+ *
+ * @memberof zdd
+ */
+bool zdd_to_implicants(const struct zdd *zdd, uint32_t set, struct implicants *implicants);
+
+#endif
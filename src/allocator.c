@@ -0,0 +1,113 @@
+#include <allocator.h>
+
+#include <assert.h>
+#include <stats.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void *allocator_libc_reallocate(void *context, void *pointer, size_t size) {
+	(void)context;
+	return realloc(pointer, size);
+}
+static void allocator_libc_deallocate(void *context, void *pointer) {
+	(void)context;
+	free(pointer);
+}
+const struct allocator allocator_libc = {
+	.reallocate = allocator_libc_reallocate,
+	.deallocate = allocator_libc_deallocate,
+	.context = NULL,
+};
+
+_Thread_local struct allocator_usage allocator_usage = {
+	.bytes = 0,
+	.peak_bytes = 0,
+	.limit = 0,
+	.failures = 0,
+};
+
+static _Thread_local const struct allocator *allocator_current = &allocator_libc;
+
+// every block starts with its size, so that the usage can be tracked without the callers having to
+// remember the sizes of their blocks
+union allocator_header {
+	size_t size;
+	max_align_t alignment;
+};
+
+const struct allocator *allocator_use(const struct allocator *allocator) {
+	assert(allocator != NULL);
+
+	const struct allocator *previous = allocator_current;
+	allocator_current = allocator;
+	return previous;
+}
+
+static bool allocator_exceeds_limit_(size_t old_size, size_t size) {
+	if (allocator_usage.limit == 0 || size <= old_size) {
+		return false;
+	}
+
+	return allocator_usage.bytes > allocator_usage.limit ||
+		   size - old_size > allocator_usage.limit - allocator_usage.bytes;
+}
+
+void *allocator_reallocate(void *pointer, size_t size) {
+	union allocator_header *header = NULL;
+	size_t old_size = 0;
+	if (pointer != NULL) {
+		header = (union allocator_header *)pointer - 1;
+		old_size = header->size;
+	}
+
+	if (size > SIZE_MAX - sizeof(*header) || allocator_exceeds_limit_(old_size, size)) {
+		allocator_usage.failures++;
+		return NULL;
+	}
+
+	header = allocator_current->reallocate(
+		allocator_current->context,
+		header,
+		sizeof(*header) + size
+	);
+	if (header == NULL) {
+		allocator_usage.failures++;
+		return NULL;
+	}
+	header->size = size;
+
+	allocator_usage.bytes = allocator_usage.bytes - old_size + size;
+	if (allocator_usage.bytes > allocator_usage.peak_bytes) {
+		allocator_usage.peak_bytes = allocator_usage.bytes;
+	}
+	stats_count_allocation(allocator_usage.bytes);
+
+	return header + 1;
+}
+
+void *allocator_allocate(size_t size) {
+	return allocator_reallocate(NULL, size);
+}
+
+void *allocator_allocate_zeroed(size_t count, size_t size) {
+	if (size != 0 && count > SIZE_MAX / size) {
+		allocator_usage.failures++;
+		return NULL;
+	}
+
+	void *pointer = allocator_allocate(count * size);
+	if (pointer != NULL) {
+		memset(pointer, 0, count * size);
+	}
+	return pointer;
+}
+
+void allocator_free(void *pointer) {
+	if (pointer == NULL) {
+		return;
+	}
+
+	union allocator_header *header = (union allocator_header *)pointer - 1;
+	allocator_usage.bytes -= header->size;
+	allocator_current->deallocate(allocator_current->context, header);
+}
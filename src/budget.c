@@ -0,0 +1,95 @@
+#include <budget.h>
+
+#include <allocator.h>
+#include <assert.h>
+#include <stdint.h>
+#include <time.h>
+
+static _Thread_local struct {
+	bool active;
+	struct budget budget;
+	double deadline;
+	size_t bytes;		// bytes allocated when the budget started
+	uint64_t failures;	// allocation failures when the budget started
+	size_t limit;		// the allocator's limit before the budget started
+	enum budget_status status;
+} budget_state = {
+	.active = false,
+	.status = budget_status_within,
+};
+
+// returns the seconds of the monotonic clock, which is all a deadline needs, the budget is checked
+// often enough that also reading the thread's cpu time would show up in profiles
+static double budget_now_(void) {
+	struct timespec time;
+	if (clock_gettime(CLOCK_MONOTONIC, &time) != 0) {
+		return 0.0;
+	}
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+void budget_begin(struct budget budget) {
+	assert(!budget_state.active);
+
+	budget_state.active = true;
+	budget_state.budget = budget;
+	budget_state.deadline = budget.seconds > 0.0 ? budget_now_() + budget.seconds : 0.0;
+	budget_state.bytes = allocator_usage.bytes;
+	budget_state.failures = allocator_usage.failures;
+	budget_state.limit = allocator_usage.limit;
+	budget_state.status = budget_status_within;
+
+	// the allocator enforces the byte limit on its own, so that a stage that doesn't check the
+	// budget for a while can't overshoot it
+	if (budget.bytes != 0 &&
+		(allocator_usage.limit == 0 || allocator_usage.limit - budget_state.bytes > budget.bytes)) {
+		allocator_usage.limit = budget_state.bytes + budget.bytes;
+	}
+}
+
+enum budget_status budget_end(void) {
+	assert(budget_state.active);
+
+	// failed allocations are only noticed if they happened during the budget
+	(void)budget_exceeded(0);
+
+	budget_state.active = false;
+	allocator_usage.limit = budget_state.limit;
+
+	return budget_state.status;
+}
+
+bool budget_exceeded(size_t implicants) {
+	if (!budget_state.active) {
+		return false;
+	}
+	if (budget_state.status != budget_status_within) {
+		return true;
+	}
+
+	const struct budget *budget = &budget_state.budget;
+	if (budget->implicants != 0 && implicants > budget->implicants) {
+		budget_state.status = budget_status_implicants;
+	} else if (budget->bytes != 0 &&
+			   (allocator_usage.failures != budget_state.failures ||
+				(allocator_usage.bytes > budget_state.bytes &&
+				 allocator_usage.bytes - budget_state.bytes > budget->bytes))) {
+		budget_state.status = budget_status_bytes;
+	} else if (budget_state.deadline > 0.0 && budget_now_() > budget_state.deadline) {
+		budget_state.status = budget_status_deadline;
+	}
+
+	return budget_state.status != budget_status_within;
+}
+
+const char *budget_status_name(enum budget_status status) {
+	switch (status) {
+		case budget_status_within: return "within budget";
+		case budget_status_deadline: return "deadline";
+		case budget_status_implicants: return "implicants";
+		case budget_status_bytes: return "bytes";
+		default: assert(false);
+	}
+
+	return NULL;
+}
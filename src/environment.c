@@ -7,6 +7,18 @@
 #define VARIABLE_INDEX(name)                                                                       \
 	(islower(name) ? (size_t)((name) - 'a') : (size_t)((name) - 'A' + ('z' - 'a' + 1)))
 
+size_t environment_variable_index(char name) {
+	assert(isalpha((unsigned char)name));
+
+	return VARIABLE_INDEX(name);
+}
+
+char environment_variable_name(size_t index) {
+	assert(index < VARIABLES_COUNT);
+
+	return (char)(index < ('z' - 'a' + 1) ? 'a' + index : 'A' + (index - ('z' - 'a' + 1)));
+}
+
 struct environment environment_new(void) {
 	return (struct environment){
 		.variables = 0,
@@ -22,6 +34,6 @@ bool environment_get_variable(const struct environment *environment, char name)
 void environment_set_variable(struct environment *environment, char name, bool value) {
 	assert(environment != NULL && isalpha((unsigned char)name));
 
-	environment->variables &= ~(1U << VARIABLE_INDEX(name));
-	environment->variables |= ((unsigned)value << VARIABLE_INDEX(name));
+	environment->variables &= ~(UINT64_C(1) << VARIABLE_INDEX(name));
+	environment->variables |= ((uint64_t)value << VARIABLE_INDEX(name));
 }
@@ -1,14 +1,21 @@
 #include <expression.h>
 
+#include <allocator.h>
+#include <budget.h>
 #include <errno.h>
+#include <expression_pool.h>
 #include <float.h>
 #include <limits.h>
+#include <sat.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stats.h>
 #include <stdlib.h>
 #include <string.h>
+#include <vector/define.h>
+#include <zdd.h>
 
 struct expression expression_operation(enum operation_type type, ...) {
 	va_list arguments;
@@ -16,16 +23,76 @@ struct expression expression_operation(enum operation_type type, ...) {
 
 	size_t arity = operation_type_arity(type);
 
-	struct expression *operands = malloc(arity * sizeof(*operands));
+	struct expression *operands = allocator_allocate(arity * sizeof(*operands));
+	if (operands == NULL) {
+		for (size_t i = 0; i < arity; i++) {
+			struct expression operand = va_arg(arguments, struct expression);
+			expression_drop(&operand);
+		}
+		va_end(arguments);
+		return expression_constant(false);
+	}
 	for (size_t i = 0; i < arity; i++) {
 		operands[i] = va_arg(arguments, struct expression);
 	}
 
 	va_end(arguments);
 
+	return expression_operation_from_operands(type, operands, arity);
+}
+
+struct expression expression_operation_from_operands(
+	enum operation_type type,
+	struct expression *operands,
+	size_t operands_count
+) {
+	assert(operands != NULL);
+	assert(
+		operation_type_is_variadic(type) ? operands_count >= operation_type_arity(type)
+										 : operands_count == operation_type_arity(type)
+	);
+
+	// operands that are operations of the same variadic type are replaced with their own operands
+	size_t flattened_count = operands_count;
+	if (operation_type_is_variadic(type)) {
+		for (size_t i = 0; i < operands_count; i++) {
+			if (operands[i].type == expression_type_operation &&
+				operands[i].operation.type == type) {
+				flattened_count += operands[i].operation.operands_count - 1;
+			}
+		}
+	}
+
+	// if there's no memory for flattening, the operands are left nested, which is equivalent
+	struct expression *flattened_operands = NULL;
+	if (flattened_count != operands_count) {
+		flattened_operands = allocator_allocate(flattened_count * sizeof(*operands));
+	}
+	if (flattened_operands != NULL) {
+		size_t j = 0;
+		for (size_t i = 0; i < operands_count; i++) {
+			if (operands[i].type == expression_type_operation &&
+				operands[i].operation.type == type) {
+				memcpy(
+					&flattened_operands[j],
+					operands[i].operation.operands,
+					operands[i].operation.operands_count * sizeof(*operands)
+				);
+				j += operands[i].operation.operands_count;
+				allocator_free(operands[i].operation.operands);
+			} else {
+				flattened_operands[j++] = operands[i];
+			}
+		}
+
+		allocator_free(operands);
+		operands = flattened_operands;
+		operands_count = flattened_count;
+	}
+
 	return (struct expression){
 		.type = expression_type_operation,
-		.operation = { .type = type, .operands = operands },
+		.operation = { .type = type, .operands_count = operands_count, .operands = operands },
 	};
 }
 
@@ -36,14 +103,21 @@ struct expression expression_clone(const struct expression *expression) {
 		case expression_type_constant:
 		case expression_type_variable: return *expression;
 		case expression_type_operation: {
-			size_t arity = operation_type_arity(expression->operation.type);
-			struct expression *operands = malloc(arity * sizeof(*operands));
-			for (size_t i = 0; i < arity; i++) {
+			size_t operands_count = expression->operation.operands_count;
+			struct expression *operands = allocator_allocate(operands_count * sizeof(*operands));
+			if (operands == NULL) {
+				return expression_constant(false);
+			}
+			for (size_t i = 0; i < operands_count; i++) {
 				operands[i] = expression_clone(&expression->operation.operands[i]);
 			}
 			return (struct expression){
 				.type = expression_type_operation,
-				.operation = { .type = expression->operation.type, .operands = operands },
+				.operation = {
+					.type = expression->operation.type,
+					.operands_count = operands_count,
+					.operands = operands,
+				},
 			};
 		} break;
 		default: assert(false);
@@ -59,11 +133,10 @@ void expression_drop(struct expression *expression) {
 		case expression_type_constant:
 		case expression_type_variable: break;
 		case expression_type_operation: {
-			size_t arity = operation_type_arity(expression->operation.type);
-			for (size_t i = 0; i < arity; i++) {
+			for (size_t i = 0; i < expression->operation.operands_count; i++) {
 				expression_drop(&expression->operation.operands[i]);
 			}
-			free(expression->operation.operands);
+			allocator_free(expression->operation.operands);
 		} break;
 		default: assert(false);
 	}
@@ -85,12 +158,12 @@ bool expression_equals(
 		case expression_type_variable:
 			return expression_1->variable.name == expression_2->variable.name;
 		case expression_type_operation: {
-			if (expression_1->operation.type != expression_2->operation.type) {
+			if (expression_1->operation.type != expression_2->operation.type ||
+				expression_1->operation.operands_count != expression_2->operation.operands_count) {
 				return false;
 			}
 
-			size_t arity = operation_type_arity(expression_1->operation.type);
-			for (size_t i = 0; i < arity; i++) {
+			for (size_t i = 0; i < expression_1->operation.operands_count; i++) {
 				if (!expression_equals(
 						&expression_1->operation.operands[i],
 						&expression_2->operation.operands[i]
@@ -105,6 +178,33 @@ bool expression_equals(
 	}
 }
 
+// the first reason a string isn't an expression as written or a function as given by its minterms,
+// so that `expression_from_string_strict()` can reject it while `expression_from_string()` recovers
+static _Thread_local char expression_parse_error_[256] = "";
+
+// prints a diagnostic of a string that isn't well-formed, and records it as the reason the string
+// failed to parse unless an earlier one was recorded
+static void expression_parse_fail_(const char *severity, const char *format, ...) {
+	assert(severity != NULL && format != NULL);
+
+	va_list arguments;
+	va_start(arguments, format);
+	if (expression_parse_error_[0] == '\0') {
+		va_list copy;
+		va_copy(copy, arguments);
+		(void)vsnprintf(expression_parse_error_, sizeof(expression_parse_error_), format, copy);
+		va_end(copy);
+	}
+	(void)fprintf(stderr, "%s: ", severity);
+	(void)vfprintf(stderr, format, arguments);
+	(void)fputc('\n', stderr);
+	va_end(arguments);
+}
+
+const char *expression_parse_error(void) {
+	return expression_parse_error_;
+}
+
 static struct expression expression_from_string_expression(const char **string);
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 static struct expression expression_from_string_atom(const char **string) {
@@ -128,7 +228,7 @@ static struct expression expression_from_string_atom(const char **string) {
 		if (**string == ')') {
 			++*string;
 		} else {
-			(void)fprintf(stderr, "Warning: unclosed parentheses \"%s\"\n", *string);
+			expression_parse_fail_("Warning", "unclosed parentheses \"%s\"", *string);
 		}
 	} else if (isalpha((unsigned char)**string)) {
 		char name = **string;
@@ -140,7 +240,7 @@ static struct expression expression_from_string_atom(const char **string) {
 		char *end = NULL;
 		long value = strtol(*string, &end, 10);
 		if (end == *string) {
-			(void)fprintf(stderr, "Error: failed to parse constant from \"%s\"\n", *string);
+			expression_parse_fail_("Error", "failed to parse constant from \"%s\"", *string);
 			value = false;
 		}
 
@@ -202,10 +302,70 @@ static struct expression expression_from_string_primary(const char **string) {
 
 	return primary;
 }
+// appends an operand to the operands of a chain that is being parsed, if memory runs out the
+// operand and the operands are dropped and `false` is returned
+static bool expression_operands_push_(
+	struct expression **operands,
+	size_t *length,
+	size_t *capacity,
+	struct expression operand
+) {
+	assert(operands != NULL && length != NULL && capacity != NULL);
+
+	if (*length == *capacity) {
+		size_t new_capacity = *capacity == 0 ? 4 : 2 * *capacity;
+		struct expression *new_operands = NULL;
+		if (new_capacity <= SIZE_MAX / sizeof(**operands)) {
+			new_operands = allocator_reallocate(*operands, new_capacity * sizeof(**operands));
+		}
+		if (new_operands == NULL) {
+			expression_drop(&operand);
+			for (size_t i = 0; i < *length; i++) {
+				expression_drop(&(*operands)[i]);
+			}
+			allocator_free(*operands);
+			*operands = NULL;
+			*length = 0;
+			*capacity = 0;
+			return false;
+		}
+		*operands = new_operands;
+		*capacity = new_capacity;
+	}
+	(*operands)[(*length)++] = operand;
+
+	return true;
+}
+// creates a variadic operation from the operands of a parsed chain, or returns its only operand
+static struct expression expression_operands_collect_(
+	enum operation_type type,
+	struct expression *operands,
+	size_t length
+) {
+	assert(operands != NULL && length != 0);
+
+	if (length == 1) {
+		struct expression operand = operands[0];
+		allocator_free(operands);
+		return operand;
+	}
+
+	return expression_operation_from_operands(type, operands, length);
+}
 static struct expression expression_from_string_factor(const char **string) {
 	assert(string != NULL && *string != NULL);
 
-	struct expression factor = expression_from_string_primary(string);
+	struct expression *operands = NULL;
+	size_t length = 0;
+	size_t capacity = 0;
+	if (!expression_operands_push_(
+			&operands,
+			&length,
+			&capacity,
+			expression_from_string_primary(string)
+		)) {
+		return expression_constant(false);
+	}
 
 	while (1) {
 		while (isspace((unsigned char)**string)) {
@@ -213,44 +373,73 @@ static struct expression expression_from_string_factor(const char **string) {
 		}
 
 		if (**string == '!' || **string == '(' || isalpha((unsigned char)**string)) {
-			factor = expression_operation(
-				operation_type_conjunction,
-				factor,
-				expression_from_string_primary(string)
-			);
+			if (!expression_operands_push_(
+					&operands,
+					&length,
+					&capacity,
+					expression_from_string_primary(string)
+				)) {
+				return expression_constant(false);
+			}
 		} else {
 			break;
 		}
 	}
 
-	return factor;
+	return expression_operands_collect_(operation_type_conjunction, operands, length);
 }
 static struct expression expression_from_string_term(const char **string) {
 	assert(string != NULL && *string != NULL);
 
-	struct expression expression = expression_from_string_factor(string);
+	// the operands of the conjunction that is being parsed, alternative denials aren't associative
+	// so they end the conjunction and become the first operand of the next one
+	struct expression *operands = NULL;
+	size_t length = 0;
+	size_t capacity = 0;
+	if (!expression_operands_push_(
+			&operands,
+			&length,
+			&capacity,
+			expression_from_string_factor(string)
+		)) {
+		return expression_constant(false);
+	}
 
 	while (1) {
 		while (isspace((unsigned char)**string)) {
 			++*string;
 		}
 
-		switch (**string) {
-			case '&':
-			case '*': {
-				++*string;
-
-				expression = expression_operation(
-					operation_type_conjunction,
-					expression,
+		if (**string == '&' || **string == '*') {
+			++*string;
+			if (!expression_operands_push_(
+					&operands,
+					&length,
+					&capacity,
 					expression_from_string_factor(string)
-				);
-			} break;
-			default: return expression;
+				)) {
+				return expression_constant(false);
+			}
+		} else if (**string == '~' && (*string)[1] == '&') {
+			*string += 2;
+			struct expression expression = expression_operation(
+				operation_type_alternative_denial,
+				expression_operands_collect_(operation_type_conjunction, operands, length),
+				expression_from_string_factor(string)
+			);
+
+			operands = NULL;
+			length = 0;
+			capacity = 0;
+			if (!expression_operands_push_(&operands, &length, &capacity, expression)) {
+				return expression_constant(false);
+			}
+		} else {
+			return expression_operands_collect_(operation_type_conjunction, operands, length);
 		}
 	}
 }
-static struct expression expression_from_string_expression(const char **string) {
+static struct expression expression_from_string_parity(const char **string) {
 	assert(string != NULL && *string != NULL);
 
 	struct expression expression = expression_from_string_term(string);
@@ -260,38 +449,136 @@ static struct expression expression_from_string_expression(const char **string)
 			++*string;
 		}
 
-		switch (**string) {
-			case '|':
-			case '+': {
-				++*string;
+		enum operation_type type;
+		if (**string == '^') {
+			++*string;
+			type = operation_type_exclusive_disjunction;
+		} else if (**string == '~' && (*string)[1] == '^') {
+			*string += 2;
+			type = operation_type_biconditional;
+		} else {
+			return expression;
+		}
 
-				expression = expression_operation(
-					operation_type_disjunction,
-					expression,
-					expression_from_string_term(string)
-				);
-			} break;
-			default: return expression;
+		expression = expression_operation(type, expression, expression_from_string_term(string));
+	}
+}
+static struct expression expression_from_string_sum(const char **string) {
+	assert(string != NULL && *string != NULL);
+
+	// the operands of the disjunction that is being parsed, joint denials end it like alternative
+	// denials end conjunctions
+	struct expression *operands = NULL;
+	size_t length = 0;
+	size_t capacity = 0;
+	if (!expression_operands_push_(
+			&operands,
+			&length,
+			&capacity,
+			expression_from_string_parity(string)
+		)) {
+		return expression_constant(false);
+	}
+
+	while (1) {
+		while (isspace((unsigned char)**string)) {
+			++*string;
+		}
+
+		if (**string == '|' || **string == '+') {
+			++*string;
+			if (!expression_operands_push_(
+					&operands,
+					&length,
+					&capacity,
+					expression_from_string_parity(string)
+				)) {
+				return expression_constant(false);
+			}
+		} else if (**string == '~' && (*string)[1] == '|') {
+			*string += 2;
+			struct expression expression = expression_operation(
+				operation_type_joint_denial,
+				expression_operands_collect_(operation_type_disjunction, operands, length),
+				expression_from_string_parity(string)
+			);
+
+			operands = NULL;
+			length = 0;
+			capacity = 0;
+			if (!expression_operands_push_(&operands, &length, &capacity, expression)) {
+				return expression_constant(false);
+			}
+		} else {
+			return expression_operands_collect_(operation_type_disjunction, operands, length);
 		}
 	}
 }
+static struct expression expression_from_string_expression(const char **string) {
+	assert(string != NULL && *string != NULL);
+
+	struct expression expression = expression_from_string_sum(string);
+
+	while (isspace((unsigned char)**string)) {
+		++*string;
+	}
+
+	// implication is right associative
+	if (**string == '-' && (*string)[1] == '>') {
+		*string += 2;
+
+		expression = expression_operation(
+			operation_type_implication,
+			expression,
+			expression_from_string_expression(string)
+		);
+	}
+
+	return expression;
+}
 
 struct expression expression_from_string(const char *string) {
 	assert(string != NULL);
 
+	struct stats_span span = stats_begin(stats_stage_parse);
+
+	uint64_t failures = allocator_usage.failures;
+
 	struct expression expression = expression_from_string_expression(&string);
 
 	while (isspace((unsigned char)*string)) {
 		++string;
 	}
 
-	if (*string != '\0') {
-		(void)fprintf(stderr, "Warning: trailing characters \"%s\" after expression\n", string);
+	// the parts of the expression that memory ran out for were replaced with constants, so the
+	// expression isn't the one that was written and is dropped
+	if (allocator_usage.failures != failures) {
+		expression_parse_fail_("Error", "ran out of memory while parsing expression");
+		expression_drop(&expression);
+		expression = expression_constant(false);
+	} else if (*string != '\0') {
+		expression_parse_fail_("Warning", "trailing characters \"%s\" after expression", string);
 	}
 
+	stats_end(span);
+
 	return expression;
 }
 
+bool expression_from_string_strict(const char *string, struct expression *expression) {
+	assert(string != NULL && expression != NULL);
+
+	expression_parse_error_[0] = '\0';
+	struct expression parsed = expression_from_string(string);
+	if (expression_parse_error_[0] != '\0') {
+		expression_drop(&parsed);
+		return false;
+	}
+
+	*expression = parsed;
+	return true;
+}
+
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 static int expression_to_string_(
 	char *string,
@@ -327,39 +614,57 @@ static int expression_to_string_(
 		case expression_type_operation: {
 			switch (expression->operation.type) {
 				case operation_type_conjunction:
-				case operation_type_disjunction: {
-					if (expression->operation.operands[0].type == expression_type_operation &&
-						(operation_type_precedence(expression->operation.operands[0].operation.type
-						 ) < operation_type_precedence(expression->operation.type))) {
-						print(snprintf, "(");
-						print(expression_to_string_, &expression->operation.operands[0]);
-						print(snprintf, ")");
-					} else {
-						print(expression_to_string_, &expression->operation.operands[0]);
-					}
+				case operation_type_disjunction:
+				case operation_type_exclusive_disjunction:
+				case operation_type_biconditional:
+				case operation_type_alternative_denial:
+				case operation_type_joint_denial:
+				case operation_type_implication: {
+					static const char *const separators[] = {
+						[operation_type_disjunction] = " + ",
+						[operation_type_exclusive_disjunction] = " ^ ",
+						[operation_type_biconditional] = " ~^ ",
+						[operation_type_alternative_denial] = " ~& ",
+						[operation_type_joint_denial] = " ~| ",
+						[operation_type_implication] = " -> ",
+					};
+
+					enum operation_type type = expression->operation.type;
+					const struct expression *operands = expression->operation.operands;
+					size_t precedence = operation_type_precedence(type);
+					// implication is right associative and the rest are left associative, an
+					// alternative denial also has to be parenthesized before a juxtaposition
+					bool right_associative = type == operation_type_implication;
+
+					for (size_t i = 0; i < expression->operation.operands_count; i++) {
+						if (i != 0 && type != operation_type_conjunction) {
+							print(snprintf, "%s", separators[type]);
+						} else if (i != 0 && (operands[i - 1].type == expression_type_constant ||
+											  operands[i].type == expression_type_constant)) {
+							print(snprintf, " * ");
+						}
 
-					switch (expression->operation.type) {
-						case operation_type_conjunction: {
-							if (expression->operation.operands[0].type ==
-									expression_type_constant ||
-								expression->operation.operands[1].type ==
-									expression_type_constant) {
-								print(snprintf, " * ");
+						bool parenthesized = false;
+						if (operands[i].type == expression_type_operation) {
+							enum operation_type operand_type = operands[i].operation.type;
+							if (operation_type_precedence(operand_type) < precedence) {
+								parenthesized = true;
+							} else if (operation_type_precedence(operand_type) == precedence) {
+								parenthesized =
+									i == 0 ? right_associative ||
+												 (type == operation_type_conjunction &&
+												  operand_type == operation_type_alternative_denial)
+										   : !right_associative;
 							}
-						} break;
-						case operation_type_disjunction: print(snprintf, " + "); break;
-						// we have already checked the operation's type before
-						default: __builtin_unreachable();
-					}
+						}
 
-					if (expression->operation.operands[1].type == expression_type_operation &&
-						(operation_type_precedence(expression->operation.operands[1].operation.type
-						 ) <= operation_type_precedence(expression->operation.type))) {
-						print(snprintf, "(");
-						print(expression_to_string_, &expression->operation.operands[1]);
-						print(snprintf, ")");
-					} else {
-						print(expression_to_string_, &expression->operation.operands[1]);
+						if (parenthesized) {
+							print(snprintf, "(");
+							print(expression_to_string_, &operands[i]);
+							print(snprintf, ")");
+						} else {
+							print(expression_to_string_, &operands[i]);
+						}
 					}
 				} break;
 				case operation_type_negation: {
@@ -392,24 +697,20 @@ char *expression_to_string(const struct expression *expression) {
 		return NULL;
 	}
 
-	char *string = malloc((size_t)length + 1);
+	char *string = allocator_allocate((size_t)length + 1);
 	if (string == NULL) {
 		return NULL;
 	}
 
 	if (expression_to_string_(string, (size_t)length + 1, expression) < 0) {
-		free(string);
+		allocator_free(string);
 		return NULL;
 	}
 
 	return string;
 }
 
-void variables_drop(struct variables *variables) {
-	assert(variables != NULL);
-
-	free(variables->data);
-}
+VECTOR_DEFINE(variables)
 
 void expression_variables_(const struct expression *expression, struct environment *environment) {
 	assert(expression != NULL && environment != NULL);
@@ -420,8 +721,7 @@ void expression_variables_(const struct expression *expression, struct environme
 			environment_set_variable(environment, expression->variable.name, true);
 		} break;
 		case expression_type_operation: {
-			size_t arity = operation_type_arity(expression->operation.type);
-			for (size_t i = 0; i < arity; i++) {
+			for (size_t i = 0; i < expression->operation.operands_count; i++) {
 				expression_variables_(&expression->operation.operands[i], environment);
 			}
 		} break;
@@ -434,13 +734,11 @@ struct variables variables_from_expression(const struct expression *expression)
 	struct environment environment = environment_new();
 	expression_variables_(expression, &environment);
 
-	struct variables variables = {
-		.data = malloc(VARIABLES_COUNT),
-	};
+	struct variables variables = variables_new();
+	char *names = variables_elements(&variables);
 	for (size_t i = 0; i < VARIABLES_COUNT; i++) {
 		if ((environment.variables >> i) & 1U) {
-			variables.data[variables.length++] =
-				(char)(i < ('z' - 'a' + 1) ? 'a' + i : 'A' + (i - ('z' - 'a' + 1)));
+			names[variables.length++] = environment_variable_name(i);
 		}
 	}
 
@@ -451,189 +749,1572 @@ void minterms_drop(struct minterms *minterms) {
 	assert(minterms != NULL);
 
 	variables_drop(&minterms->variables);
-	free(minterms->data);
+	allocator_free(minterms->data);
 }
 
-struct minterms minterms_from_expression(const struct expression *expression) {
+static uint64_t expression_hash_(const struct expression *expression) {
 	assert(expression != NULL);
 
-	struct minterms minterms = {
-		.variables = variables_from_expression(expression),
-	};
+	uint64_t hash = (UINT64_C(14695981039346656037) ^ expression->type) * UINT64_C(1099511628211);
+	switch (expression->type) {
+		case expression_type_constant: return (hash ^ expression->constant.value) * 31U;
+		case expression_type_variable: {
+			return (hash ^ (unsigned char)expression->variable.name) * UINT64_C(1099511628211);
+		}
+		case expression_type_operation: {
+			hash = (hash ^ expression->operation.type) * UINT64_C(1099511628211);
+			for (size_t i = 0; i < expression->operation.operands_count; i++) {
+				hash = (hash ^ expression_hash_(&expression->operation.operands[i])) *
+					   UINT64_C(1099511628211);
+			}
+			return hash;
+		}
+		default: assert(false);
+	}
+}
 
-	struct expression simplified_expression = expression_clone(expression);
-	expression_simplify(&simplified_expression, NULL);
+#define TRUTH_TABLE_MEMO_LIMIT (1U << 16U)
+
+// residuals that were already built, so that identical sub-tables are copied instead of rebuilt
+struct truth_table_memo {
+	struct truth_table_residual {
+		uint64_t hash;
+		size_t depth;
+		uint64_t offset;
+		struct expression expression;
+	} *residuals;
+	size_t length;
+	size_t capacity;
+};
+static void truth_table_memo_drop(struct truth_table_memo *memo) {
+	assert(memo != NULL);
 
-	minterms.data = malloc((1U << minterms.variables.length) * sizeof(*minterms.data));
-	minterms.length = 0;
-	for (uint64_t i = 0; i < (1U << minterms.variables.length); i++) {
-		struct environment environment = environment_new();
-		for (size_t j = 0; j < minterms.variables.length; j++) {
-			environment_set_variable(
-				&environment,
-				minterms.variables.data[minterms.variables.length - j - 1],
-				(i >> j) & 1U
-			);
+	for (size_t i = 0; i < memo->capacity; i++) {
+		if (memo->residuals[i].offset != UINT64_MAX) {
+			expression_drop(&memo->residuals[i].expression);
 		}
+	}
+	allocator_free(memo->residuals);
+}
+static const struct truth_table_residual *truth_table_memo_find(
+	const struct truth_table_memo *memo,
+	const struct expression *expression,
+	uint64_t hash,
+	size_t depth
+) {
+	assert(memo != NULL && expression != NULL);
 
-		if (expression_evaluate(&simplified_expression, &environment)) {
-			minterms.data[minterms.length++] = i;
-		}
+	if (memo->capacity == 0) {
+		return NULL;
 	}
 
-	expression_drop(&simplified_expression);
+	for (size_t i = hash & (memo->capacity - 1); memo->residuals[i].offset != UINT64_MAX;
+		 i = (i + 1) & (memo->capacity - 1)) {
+		if (memo->residuals[i].hash == hash && memo->residuals[i].depth == depth &&
+			expression_equals(&memo->residuals[i].expression, expression)) {
+			return &memo->residuals[i];
+		}
+	}
 
-	return minterms;
+	return NULL;
 }
+// takes ownership of the residual's expression, unless the memo is full
+static bool truth_table_memo_insert(
+	struct truth_table_memo *memo,
+	struct truth_table_residual residual
+) {
+	assert(memo != NULL);
 
-void expression_simplify(struct expression *expression, const struct environment *environment) {
-	assert(expression != NULL);
+	if (memo->length >= TRUTH_TABLE_MEMO_LIMIT) {
+		return false;
+	}
 
-	switch (expression->type) {
-		case expression_type_constant: break;
-		case expression_type_variable: {
-			if (environment != NULL) {
-				*expression = expression_constant(
-					environment_get_variable(environment, expression->variable.name)
-				);
-			}
-		} break;
-		case expression_type_operation: {
-			size_t arity = operation_type_arity(expression->operation.type);
-			for (size_t i = 0; i < arity; i++) {
-				expression_simplify(&expression->operation.operands[i], environment);
+	if (2 * (memo->length + 1) > memo->capacity) {
+		size_t capacity = memo->capacity == 0 ? 64 : 2 * memo->capacity;
+		struct truth_table_residual *residuals = allocator_allocate(capacity * sizeof(*residuals));
+		if (residuals == NULL) {
+			return false;
+		}
+		for (size_t i = 0; i < capacity; i++) {
+			residuals[i].offset = UINT64_MAX;
+		}
+		for (size_t i = 0; i < memo->capacity; i++) {
+			if (memo->residuals[i].offset != UINT64_MAX) {
+				size_t j = memo->residuals[i].hash & (capacity - 1);
+				while (residuals[j].offset != UINT64_MAX) {
+					j = (j + 1) & (capacity - 1);
+				}
+				residuals[j] = memo->residuals[i];
 			}
+		}
+		allocator_free(memo->residuals);
+		memo->residuals = residuals;
+		memo->capacity = capacity;
+	}
 
-			switch (expression->operation.type) {
-				case operation_type_conjunction: {
-					if (expression->operation.operands[0].type == expression_type_constant) {
-						struct expression *operands = expression->operation.operands;
-						if (expression->operation.operands[0].constant.value) {
-							*expression = expression->operation.operands[1];
-						} else {
-							expression_drop(&expression->operation.operands[1]);
-							*expression = expression->operation.operands[0];
-						}
-						free(operands);
-					} else if (expression->operation.operands[1].type == expression_type_constant) {
-						struct expression *operands = expression->operation.operands;
-						if (expression->operation.operands[1].constant.value) {
-							*expression = expression->operation.operands[0];
-						} else {
-							expression_drop(&expression->operation.operands[0]);
-							*expression = expression->operation.operands[1];
-						}
-						free(operands);
-					}
-				} break;
-				case operation_type_disjunction: {
-					if (expression->operation.operands[0].type == expression_type_constant) {
-						struct expression *operands = expression->operation.operands;
-						if (expression->operation.operands[0].constant.value) {
-							expression_drop(&expression->operation.operands[1]);
-							*expression = expression->operation.operands[0];
-						} else {
-							*expression = expression->operation.operands[1];
-						}
-						free(operands);
-					} else if (expression->operation.operands[1].type == expression_type_constant) {
-						struct expression *operands = expression->operation.operands;
-						if (expression->operation.operands[1].constant.value) {
-							expression_drop(&expression->operation.operands[0]);
-							*expression = expression->operation.operands[1];
-						} else {
-							*expression = expression->operation.operands[0];
-						}
-						free(operands);
-					}
-				} break;
-				case operation_type_negation: {
-					if (expression->operation.operands[0].type == expression_type_constant) {
-						struct expression *operands = expression->operation.operands;
-						*expression =
-							expression_constant(!expression->operation.operands[0].constant.value);
-						free(operands);
-					}
-				} break;
-				default: assert(false);
-			}
-		} break;
-		default: assert(false);
+	size_t i = residual.hash & (memo->capacity - 1);
+	while (memo->residuals[i].offset != UINT64_MAX) {
+		i = (i + 1) & (memo->capacity - 1);
 	}
+	memo->residuals[i] = residual;
+	memo->length++;
+
+	return true;
 }
 
-void expression_print(const struct expression *expression) {
-	assert(expression != 0);
+// builds the sub-table of `residual`, the cofactor of the function on its first `depth` variables,
+// starting at bit `offset`, takes ownership of `residual`
+static void truth_table_build_(
+	uint64_t *table,
+	const struct variables *variables,
+	struct truth_table_memo *memo,
+	struct expression *residual,
+	size_t depth,
+	uint64_t offset
+) {
+	assert(table != NULL && variables != NULL && memo != NULL && residual != NULL);
 
-	char *string = expression_to_string(expression);
+	size_t remaining = variables->length - depth;
 
-	printf("%s", string);
+	if (residual->type == expression_type_constant) {
+		if (residual->constant.value) {
+			if (remaining >= 6) {
+				memset(&table[offset / 64], 0xFF, ((size_t)1 << (remaining - 6)) * sizeof(*table));
+			} else {
+				table[offset / 64] |= ((UINT64_C(1) << (1U << remaining)) - 1U) << (offset % 64);
+			}
+		}
+		return;
+	}
 
-	free(string);
-}
+	if (remaining <= 6) {
+		static const uint64_t patterns[] = {
+			UINT64_C(0xAAAAAAAAAAAAAAAA), UINT64_C(0xCCCCCCCCCCCCCCCC),
+			UINT64_C(0xF0F0F0F0F0F0F0F0), UINT64_C(0xFF00FF00FF00FF00),
+			UINT64_C(0xFFFF0000FFFF0000), UINT64_C(0xFFFFFFFF00000000),
+		};
 
-void expression_debug_print(const struct expression *expression) {
-	assert(expression != 0);
+		const char *names = variables_const_elements(variables);
+		uint64_t words[VARIABLES_COUNT] = { 0 };
+		for (size_t i = 0; i < remaining; i++) {
+			words[environment_variable_index(names[variables->length - i - 1])] = patterns[i];
+		}
 
-	switch (expression->type) {
-		case expression_type_constant: printf("constant(%d)", expression->constant.value); break;
-		case expression_type_variable: printf("variable(%c)", expression->variable.name); break;
-		case expression_type_operation: {
-			printf("operation(");
-			switch (expression->operation.type) {
-				case operation_type_conjunction: printf("conjunction("); break;
-				case operation_type_disjunction: printf("disjunction("); break;
-				case operation_type_negation: printf("negation("); break;
-				default: assert(false);
-			}
-			size_t arity = operation_type_arity(expression->operation.type);
-			for (size_t i = 0; i < arity; i++) {
-				if (i != 0) {
-					printf(", ");
-				}
-				expression_debug_print(&expression->operation.operands[i]);
+		uint64_t values = expression_evaluate_parallel(residual, words);
+		if (remaining < 6) {
+			values &= (UINT64_C(1) << (1U << remaining)) - 1U;
+		}
+		table[offset / 64] |= values << (offset % 64);
+
+		expression_drop(residual);
+		return;
+	}
+
+	// the rest of the table is left empty once the budget is exceeded
+	if (budget_exceeded(0)) {
+		expression_drop(residual);
+		return;
+	}
+
+	uint64_t hash = expression_hash_(residual);
+	const struct truth_table_residual *built = truth_table_memo_find(memo, residual, hash, depth);
+	if (built != NULL) {
+		memcpy(
+			&table[offset / 64],
+			&table[built->offset / 64],
+			((size_t)1 << (remaining - 6)) * sizeof(*table)
+		);
+		expression_drop(residual);
+		return;
+	}
+
+	char name = variables_const_elements(variables)[depth];
+	size_t index = environment_variable_index(name);
+	for (int value = 0; value <= 1; value++) {
+		struct environment environment = environment_new();
+		environment_set_variable(&environment, name, value);
+
+		struct expression half = expression_cofactor(residual, &environment, UINT64_C(1) << index);
+		truth_table_build_(
+			table,
+			variables,
+			memo,
+			&half,
+			depth + 1,
+			offset + ((uint64_t)value << (remaining - 1))
+		);
+	}
+
+	if (!truth_table_memo_insert(
+			memo,
+			(struct truth_table_residual){
+				.hash = hash,
+				.depth = depth,
+				.offset = offset,
+				.expression = *residual,
 			}
-			printf("))");
-		} break;
-		default: assert(false);
+		)) {
+		expression_drop(residual);
 	}
 }
-
-bool expression_evaluate(
+static uint64_t *truth_table_data_(
 	const struct expression *expression,
-	const struct environment *environment
+	const struct variables *variables
 ) {
-	assert(expression != NULL);
+	assert(expression != NULL && variables != NULL);
 
-	switch (expression->type) {
-		case expression_type_constant: return expression->constant.value;
-		case expression_type_variable: {
-			if (environment == NULL) {
-				return false;
-			}
+	size_t words = variables->length <= 6 ? 1 : (size_t)1 << (variables->length - 6);
+	uint64_t *table = allocator_allocate_zeroed(words, sizeof(*table));
+	if (table == NULL) {
+		return NULL;
+	}
 
-			return environment_get_variable(environment, expression->variable.name);
+	struct truth_table_memo memo = {
+		.residuals = NULL,
+		.length = 0,
+		.capacity = 0,
+	};
+
+	struct expression residual = expression_clone(expression);
+	expression_simplify(&residual, NULL);
+
+	// if memory runs out the pool is empty, and the table is built recursively instead
+	if (variables->length > 6) {
+		struct expression_pool pool = expression_pool_from_expression(&residual);
+		bool evaluated = pool.length >= TRUTH_TABLE_GRAY_NODES &&
+			expression_pool_evaluate_table(&pool, variables, table);
+		expression_pool_drop(&pool);
+
+		if (evaluated) {
+			expression_drop(&residual);
+			return table;
+		}
+		memset(table, 0, words * sizeof(*table));
+	}
+
+	truth_table_build_(table, variables, &memo, &residual, 0, 0);
+
+	truth_table_memo_drop(&memo);
+
+	return table;
+}
+
+void truth_table_drop(struct truth_table *table) {
+	assert(table != NULL);
+
+	variables_drop(&table->variables);
+	allocator_free(table->data);
+}
+
+struct truth_table truth_table_from_expression(const struct expression *expression) {
+	assert(expression != NULL);
+
+	struct truth_table table = {
+		.variables = variables_from_expression(expression),
+		.data = NULL,
+	};
+	table.data = truth_table_data_(expression, &table.variables);
+
+	return table;
+}
+
+bool expression_compile_lut(const struct expression *expression, struct expression_lut *lut) {
+	assert(expression != NULL && lut != NULL);
+
+	struct environment environment = environment_new();
+	expression_variables_(expression, &environment);
+	if (__builtin_popcountll(environment.variables) > EXPRESSION_LUT_VARIABLES) {
+		return false;
+	}
+
+	// the first variable of a table is the most significant bit of its index, while the extracted
+	// bits are in increasing order of the variables, so the variables are listed backwards
+	struct variables variables = variables_new();
+	char *names = variables_elements(&variables);
+	for (size_t i = VARIABLES_COUNT; i-- > 0;) {
+		if ((environment.variables >> i) & 1U) {
+			names[variables.length++] = environment_variable_name(i);
+		}
+	}
+
+	uint64_t *data = truth_table_data_(expression, &variables);
+	variables_drop(&variables);
+	uint16_t (*bytes)[256] = allocator_allocate_zeroed(8, sizeof(*bytes));
+	if (data == NULL || bytes == NULL) {
+		allocator_free(data);
+		allocator_free(bytes);
+		return false;
+	}
+
+	// the bits of a byte's value that belong to variables are extracted at the positions they take
+	// among all the extracted bits
+	for (size_t i = 0; i < 8; i++) {
+		uint64_t mask = (environment.variables >> (i * 8)) & 0xFF;
+		uint64_t lower = environment.variables & ((UINT64_C(1) << (i * 8)) - 1);
+		size_t offset = (size_t)__builtin_popcountll(lower);
+		for (uint64_t value = 0; value < 256; value++) {
+			size_t position = offset;
+			for (uint64_t bits = mask; bits != 0; bits &= bits - 1) {
+				if ((value >> __builtin_ctzll(bits)) & 1U) {
+					bytes[i][value] |= (uint16_t)(1U << position);
+				}
+				position++;
+			}
+		}
+	}
+
+	*lut = (struct expression_lut){
+		.mask = environment.variables,
+		.data = data,
+		.bytes = bytes,
+	};
+	return true;
+}
+
+void expression_lut_drop(struct expression_lut *lut) {
+	assert(lut != NULL);
+
+	allocator_free(lut->data);
+	allocator_free(lut->bytes);
+}
+
+// estimates whether the expression is true in only a few environments by sampling it
+static bool expression_sparse_(const struct expression *expression) {
+	assert(expression != NULL);
+
+	uint64_t state = UINT64_C(0x9E3779B97F4A7C15);
+	uint64_t variables[VARIABLES_COUNT];
+
+	uint64_t ones_count = 0;
+	for (size_t i = 0; i < MINTERMS_SPARSE_SAMPLES; i++) {
+		for (size_t j = 0; j < VARIABLES_COUNT; j++) {
+			state ^= state << 13U;
+			state ^= state >> 7U;
+			state ^= state << 17U;
+			variables[j] = state;
+		}
+		ones_count += (uint64_t)__builtin_popcountll(
+			expression_evaluate_parallel(expression, variables)
+		);
+	}
+
+	return ones_count == 0;
+}
+
+static uint32_t expression_encode_(
+	const struct expression *expression,
+	struct sat_solver *solver,
+	const size_t *variables
+) {
+	assert(expression != NULL && solver != NULL && variables != NULL);
+
+	switch (expression->type) {
+		case expression_type_constant: {
+			uint32_t literal = sat_literal(sat_solver_new_variable(solver), false);
+			(void)sat_solver_add_clause(solver, &literal, 1);
+			return expression->constant.value ? literal : literal ^ 1U;
+		}
+		case expression_type_variable: {
+			return sat_literal(
+				variables[environment_variable_index(expression->variable.name)],
+				false
+			);
+		}
+		case expression_type_operation: {
+			const struct expression *operands = expression->operation.operands;
+			switch (expression->operation.type) {
+				case operation_type_exclusive_disjunction:
+				case operation_type_biconditional: {
+					uint32_t operand_1 = expression_encode_(&operands[0], solver, variables);
+					uint32_t operand_2 = expression_encode_(&operands[1], solver, variables);
+					uint32_t literal = sat_literal(sat_solver_new_variable(solver), false);
+
+					uint32_t clauses[4][3] = {
+						{ literal ^ 1U, operand_1, operand_2 },
+						{ literal ^ 1U, operand_1 ^ 1U, operand_2 ^ 1U },
+						{ literal, operand_1 ^ 1U, operand_2 },
+						{ literal, operand_1, operand_2 ^ 1U },
+					};
+					for (size_t i = 0; i < 4; i++) {
+						(void)sat_solver_add_clause(solver, clauses[i], 3);
+					}
+
+					// a biconditional is the negation of an exclusive disjunction
+					return literal ^ (expression->operation.type == operation_type_biconditional);
+				}
+				case operation_type_conjunction:
+				case operation_type_disjunction:
+				case operation_type_alternative_denial:
+				case operation_type_joint_denial:
+				case operation_type_implication: {
+					// every other operation is a conjunction with some of its operands and its
+					// result negated, for example a disjunction is the negation of the conjunction
+					// of its negated operands, these are the flips of the first operand, the rest
+					// of the operands and the result
+					static const uint32_t flips_table[][3] = {
+						[operation_type_conjunction] = { 0, 0, 0 },
+						[operation_type_disjunction] = { 1, 1, 1 },
+						[operation_type_alternative_denial] = { 0, 0, 1 },
+						[operation_type_joint_denial] = { 1, 1, 0 },
+						[operation_type_implication] = { 0, 1, 1 },
+					};
+					const uint32_t *flips = flips_table[expression->operation.type];
+
+					size_t operands_count = expression->operation.operands_count;
+					uint32_t literal = sat_literal(sat_solver_new_variable(solver), false);
+
+					// the clause that implies the result from all of the operands
+					uint32_t *clause = allocator_allocate((operands_count + 1) * sizeof(*clause));
+					if (clause == NULL) {
+						solver->out_of_memory = true;
+						return literal;
+					}
+					clause[0] = literal;
+					for (size_t i = 0; i < operands_count; i++) {
+						uint32_t operand = expression_encode_(&operands[i], solver, variables) ^
+										   flips[i == 0 ? 0 : 1];
+
+						uint32_t implication[2] = { literal ^ 1U, operand };
+						(void)sat_solver_add_clause(solver, implication, 2);
+						clause[i + 1] = operand ^ 1U;
+					}
+					(void)sat_solver_add_clause(solver, clause, operands_count + 1);
+					allocator_free(clause);
+
+					return literal ^ flips[2];
+				}
+				case operation_type_negation: {
+					return expression_encode_(&operands[0], solver, variables) ^ 1U;
+				}
+				default: assert(false);
+			}
+		} break;
+		default: assert(false);
+	}
+}
+
+static int minterms_compare_(const void *minterm_1, const void *minterm_2) {
+	uint64_t value_1 = *(const uint64_t *)minterm_1;
+	uint64_t value_2 = *(const uint64_t *)minterm_2;
+	return (value_1 > value_2) - (value_1 < value_2);
+}
+// enumerates the minterms with a sat solver and blocking clauses, fails if there are too many
+static bool minterms_enumerate_(struct minterms *minterms, const struct expression *expression) {
+	assert(minterms != NULL && expression != NULL);
+
+	struct sat_solver solver = sat_solver_new();
+
+	const char *names = variables_const_elements(&minterms->variables);
+	size_t variables[VARIABLES_COUNT];
+	for (size_t i = 0; i < minterms->variables.length; i++) {
+		variables[environment_variable_index(names[i])] = sat_solver_new_variable(&solver);
+	}
+
+	uint32_t root = expression_encode_(expression, &solver, variables);
+	(void)sat_solver_add_clause(&solver, &root, 1);
+
+	uint32_t *blocking_clause =
+		allocator_allocate(minterms->variables.length * sizeof(*blocking_clause));
+	if (blocking_clause == NULL) {
+		sat_solver_drop(&solver);
+		return false;
+	}
+
+	size_t capacity = 0;
+	minterms->data = NULL;
+	minterms->length = 0;
+
+	bool enumerated = true;
+	while (sat_solver_solve(&solver)) {
+		if (minterms->length == MINTERMS_SPARSE_LIMIT || budget_exceeded(minterms->length)) {
+			enumerated = false;
+			break;
+		}
+
+		uint64_t minterm = 0;
+		for (size_t i = 0; i < minterms->variables.length; i++) {
+			size_t variable = variables[environment_variable_index(names[i])];
+			bool value = sat_solver_value(&solver, variable);
+			minterm = (minterm << 1U) | value;
+			blocking_clause[i] = sat_literal(variable, value);
+		}
+
+		if (minterms->length == capacity) {
+			capacity = capacity == 0 ? 16 : 2 * capacity;
+			uint64_t *data = allocator_reallocate(minterms->data, capacity * sizeof(*data));
+			if (data == NULL) {
+				enumerated = false;
+				break;
+			}
+			minterms->data = data;
+		}
+		minterms->data[minterms->length++] = minterm;
+
+		if (!sat_solver_add_clause(&solver, blocking_clause, minterms->variables.length)) {
+			break;
+		}
+	}
+	if (solver.out_of_memory) {
+		enumerated = false;
+	}
+
+	allocator_free(blocking_clause);
+	sat_solver_drop(&solver);
+
+	if (!enumerated) {
+		allocator_free(minterms->data);
+		minterms->data = NULL;
+		minterms->length = 0;
+		return false;
+	}
+
+	qsort(minterms->data, minterms->length, sizeof(*minterms->data), minterms_compare_);
+
+	return true;
+}
+
+struct minterms minterms_from_expression(const struct expression *expression) {
+	assert(expression != NULL);
+
+	struct stats_span span = stats_begin(stats_stage_enumeration);
+
+	struct minterms minterms = {
+		.variables = variables_from_expression(expression),
+		.data = NULL,
+		.length = 0,
+	};
+
+	struct expression simplified_expression = expression_clone(expression);
+	expression_simplify(&simplified_expression, NULL);
+
+	// walking every environment of a wide function that is rarely true is wasteful, so its
+	// minterms are enumerated directly instead
+	if (minterms.variables.length >= MINTERMS_SPARSE_VARIABLES &&
+		expression_sparse_(&simplified_expression) &&
+		minterms_enumerate_(&minterms, &simplified_expression)) {
+		expression_drop(&simplified_expression);
+		stats_end(span);
+		return minterms;
+	}
+
+	uint64_t *table = truth_table_data_(&simplified_expression, &minterms.variables);
+	if (table == NULL) {
+		expression_drop(&simplified_expression);
+		stats_end(span);
+		return minterms;
+	}
+	size_t words =
+		minterms.variables.length <= 6 ? 1 : (size_t)1 << (minterms.variables.length - 6);
+
+	size_t length = 0;
+	for (size_t i = 0; i < words; i++) {
+		length += (size_t)__builtin_popcountll(table[i]);
+	}
+
+	// a part of the on-set is a different function, so there are no minterms at all if the budget
+	// is exceeded
+	if (budget_exceeded(length)) {
+		allocator_free(table);
+		expression_drop(&simplified_expression);
+		stats_end(span);
+		return minterms;
+	}
+
+	minterms.data = allocator_allocate((length != 0 ? length : 1) * sizeof(*minterms.data));
+	minterms.length = 0;
+	for (size_t i = 0; i < words && minterms.data != NULL; i++) {
+		for (uint64_t word = table[i]; word != 0; word &= word - 1) {
+			minterms.data[minterms.length++] = i * 64 + (uint64_t)__builtin_ctzll(word);
+		}
+	}
+
+	allocator_free(table);
+	expression_drop(&simplified_expression);
+
+	stats_end(span);
+
+	return minterms;
+}
+
+static const char *minterms_skip_spaces_(const char *string) {
+	assert(string != NULL);
+
+	while (isspace((unsigned char)*string)) {
+		string++;
+	}
+	return string;
+}
+// parses the variables of `f(a, b, c) = `, leaves `string` untouched if there are none
+static enum minterms_status minterms_from_string_variables_(
+	const char **string,
+	struct variables *variables
+) {
+	assert(string != NULL && *string != NULL && variables != NULL);
+
+	const char *current = *string;
+	while (isalpha((unsigned char)*current)) {
+		current++;
+	}
+	if (current == *string) {
+		return minterms_status_absent;
+	}
+	current = minterms_skip_spaces_(current);
+	if (*current != '(') {
+		return minterms_status_absent;
+	}
+	current = minterms_skip_spaces_(current + 1);
+
+	struct environment environment = environment_new();
+	size_t length = 0;
+	char names[VARIABLES_COUNT];
+	char repeated = '\0';
+	while (isalpha((unsigned char)*current) && !isalpha((unsigned char)current[1])) {
+		if (environment_get_variable(&environment, *current)) {
+			repeated = repeated != '\0' ? repeated : *current;
+		} else {
+			environment_set_variable(&environment, *current, true);
+			names[length++] = *current;
+		}
+
+		current = minterms_skip_spaces_(current + 1);
+		if (*current == ',') {
+			current = minterms_skip_spaces_(current + 1);
+		} else {
+			break;
+		}
+	}
+	if (*current != ')') {
+		return minterms_status_absent;
+	}
+	current = minterms_skip_spaces_(current + 1);
+	if (*current != '=') {
+		return minterms_status_absent;
+	}
+
+	// only now is it known that the string defines a function, which a variable can't be given
+	// twice to
+	if (repeated != '\0') {
+		expression_parse_fail_("Error", "variable %c is given more than once", repeated);
+		return minterms_status_invalid;
+	}
+	if (!variables_append(variables, names, length)) {
+		return minterms_status_absent;
+	}
+
+	*string = current + 1;
+	return minterms_status_parsed;
+}
+// parses the minterms of `m(1, 3, 5)`, without their variables
+static bool minterms_from_string_list_(const char *string, struct minterms *minterms) {
+	assert(string != NULL && minterms != NULL);
+
+	if (strncmp(string, "Σ", strlen("Σ")) == 0) {
+		string += strlen("Σ");
+	}
+	if (*string != 'm') {
+		return false;
+	}
+	string = minterms_skip_spaces_(string + 1);
+	if (*string != '(') {
+		return false;
+	}
+	string = minterms_skip_spaces_(string + 1);
+
+	size_t capacity = 0;
+	minterms->data = NULL;
+	minterms->length = 0;
+	while (*string != ')') {
+		if (!isdigit((unsigned char)*string)) {
+			allocator_free(minterms->data);
+			return false;
+		}
+
+		char *end = NULL;
+		errno = 0;
+		unsigned long long minterm = strtoull(string, &end, 10);
+		if (errno != 0) {
+			allocator_free(minterms->data);
+			return false;
+		}
+
+		if (minterms->length == capacity) {
+			capacity = capacity == 0 ? 16 : 2 * capacity;
+			uint64_t *data = allocator_reallocate(minterms->data, capacity * sizeof(*data));
+			if (data == NULL) {
+				allocator_free(minterms->data);
+				return false;
+			}
+			minterms->data = data;
+		}
+		minterms->data[minterms->length++] = (uint64_t)minterm;
+
+		string = minterms_skip_spaces_(end);
+		if (*string == ',') {
+			string = minterms_skip_spaces_(string + 1);
+		} else if (*string != ')') {
+			allocator_free(minterms->data);
+			return false;
+		}
+	}
+	if (*minterms_skip_spaces_(string + 1) != '\0') {
+		allocator_free(minterms->data);
+		return false;
+	}
+
+	// the minterms may be listed in any order and more than once
+	if (minterms->length != 0) {
+		qsort(minterms->data, minterms->length, sizeof(*minterms->data), minterms_compare_);
+		size_t length = 1;
+		for (size_t i = 1; i < minterms->length; i++) {
+			if (minterms->data[i] != minterms->data[length - 1]) {
+				minterms->data[length++] = minterms->data[i];
+			}
+		}
+		minterms->length = length;
+	}
+
+	return true;
+}
+// parses the minterms of a truth table, `0xE8` or `0b11101000`, and the number of its variables,
+// the table of a function of `given` variables may be a single padded hexadecimal digit if it has
+// fewer than 4 bits
+static bool minterms_from_string_table_(
+	const char *string,
+	size_t given,
+	struct minterms *minterms,
+	size_t *variables_count
+) {
+	assert(string != NULL && minterms != NULL && variables_count != NULL);
+
+	if (string[0] != '0' || (string[1] != 'x' && string[1] != 'b')) {
+		return false;
+	}
+	unsigned digit_bits = string[1] == 'x' ? 4 : 1;
+	string += 2;
+
+	size_t digits_count = 0;
+	size_t ones_count = 0;
+	unsigned last_value = 0;
+	while (digit_bits == 4 ? isxdigit((unsigned char)string[digits_count])
+						   : (string[digits_count] == '0' || string[digits_count] == '1')) {
+		char digit = string[digits_count++];
+		last_value = isdigit((unsigned char)digit)
+						 ? (unsigned)(digit - '0')
+						 : (unsigned)(tolower((unsigned char)digit) - 'a' + 10);
+		ones_count += (size_t)__builtin_popcount(last_value);
+	}
+	if (*minterms_skip_spaces_(&string[digits_count]) != '\0') {
+		return false;
+	}
+
+	// the table must hold the values of a whole number of variables
+	size_t bits_count = digits_count * digit_bits;
+	if (digit_bits == 4 && digits_count == 1 && given < 2 && last_value >> (1U << given) == 0) {
+		*variables_count = given;
+	} else if (bits_count != 0 && (bits_count & (bits_count - 1)) == 0) {
+		*variables_count = (size_t)__builtin_ctzll(bits_count);
+	} else {
+		return false;
+	}
+
+	minterms->data =
+		allocator_allocate((ones_count != 0 ? ones_count : 1) * sizeof(*minterms->data));
+	if (minterms->data == NULL) {
+		return false;
+	}
+	minterms->length = 0;
+
+	// the last digit holds the smallest minterms
+	for (size_t i = digits_count; i > 0; i--) {
+		char digit = string[i - 1];
+		unsigned value = isdigit((unsigned char)digit)
+							 ? (unsigned)(digit - '0')
+							 : (unsigned)(tolower((unsigned char)digit) - 'a' + 10);
+		for (unsigned j = 0; j < digit_bits; j++) {
+			if ((value >> j) & 1U) {
+				minterms->data[minterms->length++] = (digits_count - i) * digit_bits + j;
+			}
+		}
+	}
+
+	return true;
+}
+enum minterms_status minterms_from_string(const char *string, struct minterms *minterms) {
+	assert(string != NULL && minterms != NULL);
+
+	// without the variables the string may be an expression, which is parsed on its own
+	expression_parse_error_[0] = '\0';
+	struct variables variables = variables_new();
+	string = minterms_skip_spaces_(string);
+	enum minterms_status status = minterms_from_string_variables_(&string, &variables);
+	if (status != minterms_status_parsed) {
+		variables_drop(&variables);
+		return status;
+	}
+
+	struct stats_span span = stats_begin(stats_stage_parse);
+
+	string = minterms_skip_spaces_(string);
+
+	size_t variables_count = 0;
+	bool tabulated = false;
+	if (minterms_from_string_list_(string, minterms)) {
+		uint64_t largest = minterms->length != 0 ? minterms->data[minterms->length - 1] : 0;
+		variables_count = largest != 0 ? 64 - (size_t)__builtin_clzll(largest) : 0;
+	} else if (minterms_from_string_table_(string, variables.length, minterms, &variables_count)) {
+		tabulated = true;
+	} else {
+		expression_parse_fail_("Error", "expected minterms or a truth table after \"=\"");
+		variables_drop(&variables);
+		stats_end(span);
+		return minterms_status_invalid;
+	}
+
+	// a list only needs its largest minterm to fit, a table must be as long as its variables need
+	bool fits = variables_count == variables.length ||
+		(variables_count < variables.length && !tabulated);
+	if (!fits) {
+		expression_parse_fail_(
+			"Error",
+			"function needs %zu variables but %zu are given",
+			variables_count,
+			variables.length
+		);
+		allocator_free(minterms->data);
+		variables_drop(&variables);
+		stats_end(span);
+		return minterms_status_invalid;
+	}
+	minterms->variables = variables;
+
+	stats_end(span);
+
+	return minterms_status_parsed;
+}
+
+// returns the operation that computes the negation of an operation of type `type`, or `type` itself
+// if there is none
+static enum operation_type operation_type_complement_(enum operation_type type) {
+	switch (type) {
+		case operation_type_conjunction: return operation_type_alternative_denial;
+		case operation_type_alternative_denial: return operation_type_conjunction;
+		case operation_type_disjunction: return operation_type_joint_denial;
+		case operation_type_joint_denial: return operation_type_disjunction;
+		case operation_type_exclusive_disjunction: return operation_type_biconditional;
+		case operation_type_biconditional: return operation_type_exclusive_disjunction;
+		case operation_type_negation:
+		case operation_type_implication: return type;
+		default: assert(false);
+	}
+}
+// checks whether two expressions are syntactically each other's complements
+static bool expression_complements_(
+	const struct expression *expression_1,
+	const struct expression *expression_2
+) {
+	assert(expression_1 != NULL && expression_2 != NULL);
+
+	if (expression_1->type == expression_type_operation &&
+		expression_1->operation.type == operation_type_negation &&
+		expression_equals(&expression_1->operation.operands[0], expression_2)) {
+		return true;
+	}
+	if (expression_2->type == expression_type_operation &&
+		expression_2->operation.type == operation_type_negation &&
+		expression_equals(&expression_2->operation.operands[0], expression_1)) {
+		return true;
+	}
+
+	// x * y and x ~& y
+	if (expression_1->type != expression_type_operation ||
+		expression_2->type != expression_type_operation) {
+		return false;
+	}
+	enum operation_type type = expression_1->operation.type;
+	if (type == operation_type_complement_(type) ||
+		expression_2->operation.type != operation_type_complement_(type)) {
+		return false;
+	}
+	if (expression_1->operation.operands_count != expression_2->operation.operands_count) {
+		return false;
+	}
+	for (size_t i = 0; i < expression_1->operation.operands_count; i++) {
+		if (!expression_equals(
+				&expression_1->operation.operands[i],
+				&expression_2->operation.operands[i]
+			)) {
+			return false;
+		}
+	}
+	return true;
+}
+// checks whether every operand of `subset` is an operand of `superset`, both of which are treated
+// as operations of type `type` with a single operand if they aren't operations of that type
+static bool expression_operands_include_(
+	const struct expression *superset,
+	enum operation_type type,
+	const struct expression *subset
+) {
+	assert(superset != NULL && subset != NULL);
+
+	const struct expression *superset_operands = superset;
+	size_t superset_operands_count = 1;
+	if (superset->type == expression_type_operation && superset->operation.type == type) {
+		superset_operands = superset->operation.operands;
+		superset_operands_count = superset->operation.operands_count;
+	}
+
+	const struct expression *subset_operands = subset;
+	size_t subset_operands_count = 1;
+	if (subset->type == expression_type_operation && subset->operation.type == type) {
+		subset_operands = subset->operation.operands;
+		subset_operands_count = subset->operation.operands_count;
+	}
+
+	for (size_t i = 0; i < subset_operands_count; i++) {
+		bool included = false;
+		for (size_t j = 0; j < superset_operands_count && !included; j++) {
+			included = expression_equals(&superset_operands[j], &subset_operands[i]);
+		}
+		if (!included) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// replaces an operation with its `i`th operand, dropping the others
+static void expression_replace_with_operand_(struct expression *expression, size_t i) {
+	assert(expression != NULL && expression->type == expression_type_operation);
+
+	struct expression *operands = expression->operation.operands;
+	for (size_t j = 0; j < expression->operation.operands_count; j++) {
+		if (j != i) {
+			expression_drop(&operands[j]);
+		}
+	}
+	*expression = operands[i];
+	allocator_free(operands);
+}
+// replaces a binary operation with the negation of its `i`th operand, dropping the other one
+static void expression_replace_with_negated_operand_(struct expression *expression, size_t i) {
+	assert(expression != NULL && expression->type == expression_type_operation);
+	assert(expression->operation.operands_count == 2);
+
+	struct expression *operands = expression->operation.operands;
+	expression_drop(&operands[1 - i]);
+	operands[0] = operands[i];
+	expression->operation.type = operation_type_negation;
+	expression->operation.operands_count = 1;
+}
+// replaces the `i`th operand of a variadic operation, which is an operation of the same type, with
+// its own operands, fails if there's no memory for them
+static bool expression_flatten_operand_(struct expression *expression, size_t i) {
+	assert(expression != NULL && expression->type == expression_type_operation);
+
+	struct operation *operation = &expression->operation;
+	struct operation inner_operation = operation->operands[i].operation;
+	size_t operands_count = operation->operands_count - 1 + inner_operation.operands_count;
+
+	struct expression *operands =
+		allocator_reallocate(operation->operands, operands_count * sizeof(*operands));
+	if (operands == NULL) {
+		return false;
+	}
+	operation->operands = operands;
+	memmove(
+		&operation->operands[i + inner_operation.operands_count],
+		&operation->operands[i + 1],
+		(operation->operands_count - i - 1) * sizeof(*operation->operands)
+	);
+	memcpy(
+		&operation->operands[i],
+		inner_operation.operands,
+		inner_operation.operands_count * sizeof(*operation->operands)
+	);
+	operation->operands_count = operands_count;
+
+	allocator_free(inner_operation.operands);
+
+	return true;
+}
+// removes the negation of an operand of an operation, x' becomes x
+static void expression_strip_negation_(struct expression *operand) {
+	assert(operand != NULL && operand->type == expression_type_operation);
+	assert(operand->operation.type == operation_type_negation);
+
+	struct expression *negation_operands = operand->operation.operands;
+	*operand = negation_operands[0];
+	allocator_free(negation_operands);
+}
+
+// applies a single rewrite rule to the root of an expression whose operands are already simplified
+static bool expression_rewrite_(struct expression *expression) {
+	assert(expression != NULL);
+
+	if (expression->type != expression_type_operation) {
+		return false;
+	}
+
+	struct expression *operands = expression->operation.operands;
+	switch (expression->operation.type) {
+		case operation_type_conjunction:
+		case operation_type_disjunction: {
+			enum operation_type type = expression->operation.type;
+			enum operation_type dual_type = type == operation_type_conjunction
+												? operation_type_disjunction
+												: operation_type_conjunction;
+			// the value that absorbs the operation, false for conjunctions, true for disjunctions
+			bool absorbing = type == operation_type_disjunction;
+			size_t operands_count = expression->operation.operands_count;
+
+			// flattening, x * (y * z) = x * y * z
+			for (size_t i = 0; i < operands_count; i++) {
+				if (operands[i].type == expression_type_operation &&
+					operands[i].operation.type == type &&
+					expression_flatten_operand_(expression, i)) {
+					return true;
+				}
+			}
+
+			for (size_t i = 0; i < operands_count; i++) {
+				if (operands[i].type == expression_type_constant &&
+					operands[i].constant.value == absorbing) {
+					expression_drop(expression);
+					*expression = expression_constant(absorbing);
+					return true;
+				}
+			}
+
+			// complementation, x * x' = 0
+			for (size_t i = 0; i < operands_count; i++) {
+				for (size_t j = i + 1; j < operands_count; j++) {
+					if (expression_complements_(&operands[i], &operands[j])) {
+						expression_drop(expression);
+						*expression = expression_constant(absorbing);
+						return true;
+					}
+				}
+			}
+
+			// drops every operand that is redundant next to another one, an operand is only
+			// compared with the ones that were kept so far and the ones that weren't checked yet
+			size_t kept_count = 0;
+			for (size_t j = 0; j < operands_count; j++) {
+				// identity, x * 1 = x
+				bool redundant = operands[j].type == expression_type_constant;
+				for (size_t i = 0; i < operands_count && !redundant; i++) {
+					if (i >= kept_count && i <= j) {
+						continue;
+					}
+
+					// idempotence, x * x = x
+					if (i < kept_count && expression_equals(&operands[i], &operands[j])) {
+						redundant = true;
+					}
+
+					// absorption, x * (x + y) = x
+					if (operands[j].type == expression_type_operation &&
+						operands[j].operation.type == dual_type &&
+						expression_operands_include_(&operands[j], dual_type, &operands[i])) {
+						redundant = true;
+					}
+				}
+
+				if (redundant) {
+					expression_drop(&operands[j]);
+				} else {
+					operands[kept_count++] = operands[j];
+				}
+			}
+			if (kept_count != operands_count) {
+				expression->operation.operands_count = kept_count;
+				if (kept_count == 0) {
+					allocator_free(operands);
+					*expression = expression_constant(!absorbing);
+				} else if (kept_count == 1) {
+					expression_replace_with_operand_(expression, 0);
+				}
+				return true;
+			}
+
+			// de morgan, x' * y' = x ~| y
+			if (operands_count == 2 && operands[0].type == expression_type_operation &&
+				operands[0].operation.type == operation_type_negation &&
+				operands[1].type == expression_type_operation &&
+				operands[1].operation.type == operation_type_negation) {
+				expression_strip_negation_(&operands[0]);
+				expression_strip_negation_(&operands[1]);
+				expression->operation.type = type == operation_type_conjunction
+												 ? operation_type_joint_denial
+												 : operation_type_alternative_denial;
+				return true;
+			}
+		} break;
+		case operation_type_exclusive_disjunction:
+		case operation_type_biconditional: {
+			// the value that makes the operation an identity, false for exclusive disjunctions,
+			// true for biconditionals
+			bool identity = expression->operation.type == operation_type_biconditional;
+
+			for (size_t i = 0; i < 2; i++) {
+				if (operands[i].type == expression_type_constant) {
+					if (operands[i].constant.value == identity) {
+						expression_replace_with_operand_(expression, 1 - i);
+					} else {
+						expression_replace_with_negated_operand_(expression, 1 - i);
+					}
+					return true;
+				}
+			}
+
+			// x ^ x = 0
+			if (expression_equals(&operands[0], &operands[1])) {
+				expression_drop(expression);
+				*expression = expression_constant(identity);
+				return true;
+			}
+
+			// x ^ x' = 1
+			if (expression_complements_(&operands[0], &operands[1])) {
+				expression_drop(expression);
+				*expression = expression_constant(!identity);
+				return true;
+			}
+
+			// x' ^ y = x ~^ y
+			for (size_t i = 0; i < 2; i++) {
+				if (operands[i].type == expression_type_operation &&
+					operands[i].operation.type == operation_type_negation) {
+					expression_strip_negation_(&operands[i]);
+					expression->operation.type =
+						operation_type_complement_(expression->operation.type);
+					return true;
+				}
+			}
+		} break;
+		case operation_type_alternative_denial:
+		case operation_type_joint_denial: {
+			enum operation_type type = expression->operation.type;
+			// the value that absorbs the operation, false for alternative denials, true for joint
+			// denials
+			bool absorbing = type == operation_type_joint_denial;
+
+			for (size_t i = 0; i < 2; i++) {
+				if (operands[i].type == expression_type_constant) {
+					if (operands[i].constant.value == absorbing) {
+						expression_drop(expression);
+						*expression = expression_constant(!absorbing);
+					} else {
+						expression_replace_with_negated_operand_(expression, 1 - i);
+					}
+					return true;
+				}
+			}
+
+			// x ~& x = x'
+			if (expression_equals(&operands[0], &operands[1])) {
+				expression_replace_with_negated_operand_(expression, 0);
+				return true;
+			}
+
+			// x ~& x' = 1
+			if (expression_complements_(&operands[0], &operands[1])) {
+				expression_drop(expression);
+				*expression = expression_constant(!absorbing);
+				return true;
+			}
+
+			// de morgan, x' ~& y' = x + y
+			if (operands[0].type == expression_type_operation &&
+				operands[0].operation.type == operation_type_negation &&
+				operands[1].type == expression_type_operation &&
+				operands[1].operation.type == operation_type_negation) {
+				expression_strip_negation_(&operands[0]);
+				expression_strip_negation_(&operands[1]);
+				expression->operation.type = type == operation_type_alternative_denial
+												 ? operation_type_disjunction
+												 : operation_type_conjunction;
+				return true;
+			}
+		} break;
+		case operation_type_implication: {
+			if (operands[0].type == expression_type_constant) {
+				// 0 -> x = 1, 1 -> x = x
+				if (operands[0].constant.value) {
+					expression_replace_with_operand_(expression, 1);
+				} else {
+					expression_drop(expression);
+					*expression = expression_constant(true);
+				}
+				return true;
+			}
+			if (operands[1].type == expression_type_constant) {
+				// x -> 1 = 1, x -> 0 = x'
+				if (operands[1].constant.value) {
+					expression_drop(expression);
+					*expression = expression_constant(true);
+				} else {
+					expression_replace_with_negated_operand_(expression, 0);
+				}
+				return true;
+			}
+
+			// x -> x = 1
+			if (expression_equals(&operands[0], &operands[1])) {
+				expression_drop(expression);
+				*expression = expression_constant(true);
+				return true;
+			}
+
+			// x -> x' = x', x' -> x = x
+			if (expression_complements_(&operands[0], &operands[1])) {
+				expression_replace_with_operand_(expression, 1);
+				return true;
+			}
+
+			// x' -> y = x + y
+			if (operands[0].type == expression_type_operation &&
+				operands[0].operation.type == operation_type_negation) {
+				expression_strip_negation_(&operands[0]);
+				expression->operation.type = operation_type_disjunction;
+				return true;
+			}
+		} break;
+		case operation_type_negation: {
+			if (operands[0].type == expression_type_constant) {
+				*expression = expression_constant(!operands[0].constant.value);
+				allocator_free(operands);
+				return true;
+			}
+
+			// involution, x'' = x
+			if (operands[0].type == expression_type_operation &&
+				operands[0].operation.type == operation_type_negation) {
+				struct expression *inner_operands = operands[0].operation.operands;
+				*expression = inner_operands[0];
+				allocator_free(inner_operands);
+				allocator_free(operands);
+				return true;
+			}
+
+			// (x * y)' = x ~& y, which reuses the operand's storage
+			if (operands[0].type == expression_type_operation &&
+				operands[0].operation.operands_count == 2 &&
+				operation_type_complement_(operands[0].operation.type) !=
+					operands[0].operation.type) {
+				*expression = operands[0];
+				expression->operation.type = operation_type_complement_(expression->operation.type);
+				allocator_free(operands);
+				return true;
+			}
+		} break;
+		default: assert(false);
+	}
+
+	return false;
+}
+
+void expression_simplify(struct expression *expression, const struct environment *environment) {
+	assert(expression != NULL);
+
+	// the worklist visits the expression in post-order, so that rules are only applied to
+	// operations whose operands are already simplified
+	struct {
+		struct expression *expression;
+		bool visited;
+	} *worklist = NULL;
+	size_t worklist_length = 0;
+	size_t worklist_capacity = 0;
+	// the expression is valid after every rewrite, so if there's no memory left it's simplified
+	// partially
+	bool exhausted = false;
+
+#define push(expression_, visited_)                                                                \
+	do {                                                                                           \
+		if (worklist_length == worklist_capacity) {                                                \
+			size_t capacity_ = worklist_capacity == 0 ? 16 : 2 * worklist_capacity;                \
+			void *worklist_ = allocator_reallocate(worklist, capacity_ * sizeof(*worklist));       \
+			if (worklist_ == NULL) {                                                               \
+				exhausted = true;                                                                  \
+				break;                                                                             \
+			}                                                                                      \
+			worklist = worklist_;                                                                  \
+			worklist_capacity = capacity_;                                                         \
+		}                                                                                          \
+		worklist[worklist_length].expression = (expression_);                                      \
+		worklist[worklist_length].visited = (visited_);                                            \
+		worklist_length++;                                                                         \
+	} while (0)
+
+	push(expression, false);
+	while (worklist_length != 0 && !exhausted) {
+		worklist_length--;
+		struct expression *current = worklist[worklist_length].expression;
+
+		switch (current->type) {
+			case expression_type_constant: break;
+			case expression_type_variable: {
+				if (environment != NULL) {
+					*current = expression_constant(
+						environment_get_variable(environment, current->variable.name)
+					);
+				}
+			} break;
+			case expression_type_operation: {
+				if (!worklist[worklist_length].visited) {
+					push(current, true);
+					for (size_t i = current->operation.operands_count; i > 0; i--) {
+						push(&current->operation.operands[i - 1], false);
+					}
+					break;
+				}
+
+				// rewrite until a fixed point is reached, every rule only rewrites the root and
+				// leaves its operands simplified
+				if (expression_rewrite_(current)) {
+					push(current, true);
+				}
+			} break;
+			default: assert(false);
+		}
+	}
+
+#undef push
+
+	allocator_free(worklist);
+}
+
+static struct expression expression_cofactor_(
+	const struct expression *expression,
+	const struct environment *environment,
+	uint64_t mask
+) {
+	assert(expression != NULL && environment != NULL);
+
+	switch (expression->type) {
+		case expression_type_constant: return *expression;
+		case expression_type_variable: {
+			if ((mask >> environment_variable_index(expression->variable.name)) & 1U) {
+				return expression_constant(
+					environment_get_variable(environment, expression->variable.name)
+				);
+			}
+			return *expression;
+		}
+		case expression_type_operation: {
+			size_t operands_count = expression->operation.operands_count;
+			struct expression *operands = allocator_allocate(operands_count * sizeof(*operands));
+			if (operands == NULL) {
+				return expression_constant(false);
+			}
+			for (size_t i = 0; i < operands_count; i++) {
+				operands[i] =
+					expression_cofactor_(&expression->operation.operands[i], environment, mask);
+			}
+			return (struct expression){
+				.type = expression_type_operation,
+				.operation = {
+					.type = expression->operation.type,
+					.operands_count = operands_count,
+					.operands = operands,
+				},
+			};
+		}
+		default: assert(false);
+	}
+
+	return (struct expression){ 0 };
+}
+struct expression expression_cofactor(
+	const struct expression *expression,
+	const struct environment *environment,
+	uint64_t mask
+) {
+	assert(expression != NULL && environment != NULL);
+
+	struct expression cofactor = expression_cofactor_(expression, environment, mask);
+	expression_simplify(&cofactor, NULL);
+
+	return cofactor;
+}
+
+void expression_print(const struct expression *expression) {
+	assert(expression != 0);
+
+	char *string = expression_to_string(expression);
+
+	printf("%s", string);
+
+	allocator_free(string);
+}
+
+void expression_debug_print(const struct expression *expression) {
+	assert(expression != 0);
+
+	switch (expression->type) {
+		case expression_type_constant: printf("constant(%d)", expression->constant.value); break;
+		case expression_type_variable: printf("variable(%c)", expression->variable.name); break;
+		case expression_type_operation: {
+			printf("operation(");
+			switch (expression->operation.type) {
+				case operation_type_conjunction: printf("conjunction("); break;
+				case operation_type_disjunction: printf("disjunction("); break;
+				case operation_type_negation: printf("negation("); break;
+				case operation_type_exclusive_disjunction: printf("exclusive_disjunction("); break;
+				case operation_type_biconditional: printf("biconditional("); break;
+				case operation_type_alternative_denial: printf("alternative_denial("); break;
+				case operation_type_joint_denial: printf("joint_denial("); break;
+				case operation_type_implication: printf("implication("); break;
+				default: assert(false);
+			}
+			for (size_t i = 0; i < expression->operation.operands_count; i++) {
+				if (i != 0) {
+					printf(", ");
+				}
+				expression_debug_print(&expression->operation.operands[i]);
+			}
+			printf("))");
+		} break;
+		default: assert(false);
+	}
+}
+
+bool expression_evaluate(
+	const struct expression *expression,
+	const struct environment *environment
+) {
+	assert(expression != NULL);
+
+	switch (expression->type) {
+		case expression_type_constant: return expression->constant.value;
+		case expression_type_variable: {
+			if (environment == NULL) {
+				return false;
+			}
+
+			return environment_get_variable(environment, expression->variable.name);
 		} break;
 		case expression_type_operation: {
 			switch (expression->operation.type) {
-				case operation_type_conjunction: {
+				case operation_type_conjunction:
+				case operation_type_disjunction: {
+					// the value that short circuits the operation, false for conjunctions, true
+					// for disjunctions
+					bool absorbing = expression->operation.type == operation_type_disjunction;
+					for (size_t i = 0; i < expression->operation.operands_count; i++) {
+						if (expression_evaluate(&expression->operation.operands[i], environment) ==
+							absorbing) {
+							return absorbing;
+						}
+					}
+					return !absorbing;
+				}
+				case operation_type_negation: {
+					return !expression_evaluate(&expression->operation.operands[0], environment);
+				}
+				case operation_type_exclusive_disjunction: {
+					return expression_evaluate(&expression->operation.operands[0], environment) !=
+						   expression_evaluate(&expression->operation.operands[1], environment);
+				}
+				case operation_type_biconditional: {
+					return expression_evaluate(&expression->operation.operands[0], environment) ==
+						   expression_evaluate(&expression->operation.operands[1], environment);
+				}
+				case operation_type_alternative_denial: {
 					bool value =
 						expression_evaluate(&expression->operation.operands[0], environment);
 					if (!value) {
-						return false;
+						return true;
 					}
-					return expression_evaluate(&expression->operation.operands[1], environment);
+					return !expression_evaluate(&expression->operation.operands[1], environment);
 				}
-				case operation_type_disjunction: {
+				case operation_type_joint_denial: {
 					bool value =
 						expression_evaluate(&expression->operation.operands[0], environment);
 					if (value) {
+						return false;
+					}
+					return !expression_evaluate(&expression->operation.operands[1], environment);
+				}
+				case operation_type_implication: {
+					bool value =
+						expression_evaluate(&expression->operation.operands[0], environment);
+					if (!value) {
 						return true;
 					}
 					return expression_evaluate(&expression->operation.operands[1], environment);
 				}
+				default: assert(false);
+			}
+		} break;
+		default: assert(false);
+	}
+}
+
+uint64_t expression_evaluate_parallel(
+	const struct expression *expression,
+	const uint64_t *variables
+) {
+	assert(expression != NULL && variables != NULL);
+
+	switch (expression->type) {
+		case expression_type_constant: return expression->constant.value ? UINT64_MAX : 0;
+		case expression_type_variable: {
+			return variables[environment_variable_index(expression->variable.name)];
+		} break;
+		case expression_type_operation: {
+			const struct expression *operands = expression->operation.operands;
+			switch (expression->operation.type) {
+				case operation_type_conjunction: {
+					uint64_t values = UINT64_MAX;
+					for (size_t i = 0; i < expression->operation.operands_count && values != 0;
+						 i++) {
+						values &= expression_evaluate_parallel(&operands[i], variables);
+					}
+					return values;
+				}
+				case operation_type_disjunction: {
+					uint64_t values = 0;
+					for (size_t i = 0;
+						 i < expression->operation.operands_count && values != UINT64_MAX;
+						 i++) {
+						values |= expression_evaluate_parallel(&operands[i], variables);
+					}
+					return values;
+				}
 				case operation_type_negation: {
-					return !expression_evaluate(&expression->operation.operands[0], environment);
+					return ~expression_evaluate_parallel(&operands[0], variables);
+				}
+				case operation_type_exclusive_disjunction: {
+					return expression_evaluate_parallel(&operands[0], variables) ^
+						   expression_evaluate_parallel(&operands[1], variables);
+				}
+				case operation_type_biconditional: {
+					return ~(expression_evaluate_parallel(&operands[0], variables) ^
+							 expression_evaluate_parallel(&operands[1], variables));
+				}
+				case operation_type_alternative_denial: {
+					uint64_t values = expression_evaluate_parallel(&operands[0], variables);
+					if (values == 0) {
+						return UINT64_MAX;
+					}
+					return ~(values & expression_evaluate_parallel(&operands[1], variables));
+				}
+				case operation_type_joint_denial: {
+					uint64_t values = expression_evaluate_parallel(&operands[0], variables);
+					if (values == UINT64_MAX) {
+						return 0;
+					}
+					return ~(values | expression_evaluate_parallel(&operands[1], variables));
+				}
+				case operation_type_implication: {
+					uint64_t values = expression_evaluate_parallel(&operands[0], variables);
+					if (values == 0) {
+						return UINT64_MAX;
+					}
+					return ~values | expression_evaluate_parallel(&operands[1], variables);
 				}
 				default: assert(false);
 			}
@@ -642,6 +2323,199 @@ bool expression_evaluate(
 	}
 }
 
+// exhaustively searches the support 64 environments at a time for one the expressions differ in
+static bool expression_distinguish_parallel_(
+	const struct expression *expression_1,
+	const struct expression *expression_2,
+	uint64_t support,
+	struct environment *environment
+) {
+	static const uint64_t patterns[] = {
+		UINT64_C(0xAAAAAAAAAAAAAAAA), UINT64_C(0xCCCCCCCCCCCCCCCC), UINT64_C(0xF0F0F0F0F0F0F0F0),
+		UINT64_C(0xFF00FF00FF00FF00), UINT64_C(0xFFFF0000FFFF0000), UINT64_C(0xFFFFFFFF00000000),
+	};
+
+	size_t indices[VARIABLES_COUNT];
+	size_t indices_count = 0;
+	for (size_t i = 0; i < VARIABLES_COUNT; i++) {
+		if ((support >> i) & 1U) {
+			indices[indices_count++] = i;
+		}
+	}
+	assert(indices_count <= EXPRESSION_PARALLEL_SUPPORT);
+
+	// the first variables vary across the bits of a word, the rest are constant within a block
+	size_t lanes_count = indices_count < 6 ? indices_count : 6;
+
+	uint64_t variables[VARIABLES_COUNT] = { 0 };
+	for (size_t i = 0; i < lanes_count; i++) {
+		variables[indices[i]] = patterns[i];
+	}
+
+	for (uint64_t block = 0; block < (UINT64_C(1) << (indices_count - lanes_count)); block++) {
+		for (size_t i = lanes_count; i < indices_count; i++) {
+			variables[indices[i]] = ((block >> (i - lanes_count)) & 1U) ? UINT64_MAX : 0;
+		}
+
+		uint64_t differences = expression_evaluate_parallel(expression_1, variables) ^
+							   expression_evaluate_parallel(expression_2, variables);
+		if (differences != 0) {
+			int lane = __builtin_ctzll(differences);
+			for (size_t i = 0; i < indices_count; i++) {
+				environment_set_variable(
+					environment,
+					environment_variable_name(indices[i]),
+					(variables[indices[i]] >> lane) & 1U
+				);
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+// searches for an environment the expressions differ in with a sat solver, by encoding their miter,
+// which is true exactly where they differ, sets `out_of_memory` if memory ran out
+static bool expression_distinguish_satisfiability_(
+	const struct expression *expression_1,
+	const struct expression *expression_2,
+	uint64_t support,
+	struct environment *environment,
+	bool *out_of_memory
+) {
+	struct sat_solver solver = sat_solver_new();
+
+	size_t variables[VARIABLES_COUNT];
+	for (size_t i = 0; i < VARIABLES_COUNT; i++) {
+		if ((support >> i) & 1U) {
+			variables[i] = sat_solver_new_variable(&solver);
+		}
+	}
+
+	uint32_t literal_1 = expression_encode_(expression_1, &solver, variables);
+	uint32_t literal_2 = expression_encode_(expression_2, &solver, variables);
+	uint32_t miter[2][2] = {
+		{ literal_1, literal_2 },
+		{ literal_1 ^ 1U, literal_2 ^ 1U },
+	};
+	for (size_t i = 0; i < 2; i++) {
+		(void)sat_solver_add_clause(&solver, miter[i], 2);
+	}
+
+	bool distinguished = sat_solver_solve(&solver);
+	if (distinguished) {
+		for (size_t i = 0; i < VARIABLES_COUNT; i++) {
+			if ((support >> i) & 1U) {
+				environment_set_variable(
+					environment,
+					environment_variable_name(i),
+					sat_solver_value(&solver, variables[i])
+				);
+			}
+		}
+	}
+	*out_of_memory = solver.out_of_memory;
+
+	sat_solver_drop(&solver);
+
+	return distinguished;
+}
+// searches for an environment the expressions differ in, assigning variables in `environment`
+static bool expression_distinguish_(
+	const struct expression *expression_1,
+	const struct expression *expression_2,
+	struct environment *environment
+) {
+	assert(expression_1 != NULL && expression_2 != NULL && environment != NULL);
+
+	if (expression_equals(expression_1, expression_2)) {
+		return false;
+	}
+
+	struct environment support = environment_new();
+	expression_variables_(expression_1, &support);
+	expression_variables_(expression_2, &support);
+
+	if (__builtin_popcountll(support.variables) <= EXPRESSION_PARALLEL_SUPPORT) {
+		return expression_distinguish_parallel_(
+			expression_1,
+			expression_2,
+			support.variables,
+			environment
+		);
+	}
+
+	bool out_of_memory = false;
+	bool differ = expression_distinguish_satisfiability_(
+		expression_1,
+		expression_2,
+		support.variables,
+		environment,
+		&out_of_memory
+	);
+	if (!out_of_memory) {
+		return differ;
+	}
+
+	// without the memory for the solver, the search splits on a variable instead, each cofactor is
+	// simplified so that identical halves are pruned early
+	size_t index = (size_t)__builtin_ctzll(support.variables);
+	for (int value = 0; value <= 1; value++) {
+		environment_set_variable(environment, environment_variable_name(index), value);
+
+		struct expression cofactor_1 =
+			expression_cofactor(expression_1, environment, UINT64_C(1) << index);
+		struct expression cofactor_2 =
+			expression_cofactor(expression_2, environment, UINT64_C(1) << index);
+
+		bool distinguished = expression_distinguish_(&cofactor_1, &cofactor_2, environment);
+
+		expression_drop(&cofactor_1);
+		expression_drop(&cofactor_2);
+
+		if (distinguished) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool expression_equivalent(
+	const struct expression *expression_1,
+	const struct expression *expression_2,
+	struct environment *counterexample
+) {
+	assert(expression_1 != NULL && expression_2 != NULL);
+
+	struct environment environment = environment_new();
+	if (expression_distinguish_(expression_1, expression_2, &environment)) {
+		if (counterexample != NULL) {
+			*counterexample = environment;
+		}
+		return false;
+	}
+
+	return true;
+}
+
+bool expression_is_tautology(
+	const struct expression *expression,
+	struct environment *counterexample
+) {
+	assert(expression != NULL);
+
+	struct expression true_expression = expression_constant(true);
+	return expression_equivalent(expression, &true_expression, counterexample);
+}
+
+bool expression_is_satisfiable(const struct expression *expression, struct environment *witness) {
+	assert(expression != NULL);
+
+	struct expression false_expression = expression_constant(false);
+	return !expression_equivalent(expression, &false_expression, witness);
+}
+
 bool implicant_combinable(struct implicant implicant_1, struct implicant implicant_2) {
 	// two implicants can possibly be combined if their masks are equal
 	if (implicant_1.mask != implicant_2.mask) {
@@ -664,36 +2538,12 @@ struct implicant implicant_combine(struct implicant implicant_1, struct implican
 	};
 }
 
-struct implicants implicants_new(void) {
-	return (struct implicants){
-		.data = NULL,
-		.length = 0,
-		.capacity = 0,
-	};
-}
-
-void implicants_drop(struct implicants *implicants) {
-	assert(implicants != NULL);
-
-	free(implicants->data);
-}
+VECTOR_DEFINE(implicants)
 
-void implicants_add(struct implicants *implicants, struct implicant implicant) {
+bool implicants_add(struct implicants *implicants, struct implicant implicant) {
 	assert(implicants != NULL);
 
-	if (implicants->length == implicants->capacity) {
-		if (implicants->capacity == 0) {
-			implicants->capacity = 1;
-		} else {
-			assert(implicants->capacity < SIZE_MAX / 2);
-			implicants->capacity *= 2;
-		}
-		implicants->data =
-			realloc(implicants->data, implicants->capacity * sizeof(*implicants->data));
-		assert(implicants->data != NULL);
-	}
-
-	implicants->data[implicants->length++] = implicant;
+	return implicants_append(implicants, &implicant, 1);
 }
 
 struct expression expression_from_implicant(
@@ -702,33 +2552,40 @@ struct expression expression_from_implicant(
 ) {
 	assert(variables != NULL);
 
-	size_t i = 0;
-	while (i < variables->length && ((implicant.mask >> (variables->length - i - 1)) & 1U) == 0) {
-		i++;
+	size_t literals_count = 0;
+	for (size_t i = 0; i < variables->length; i++) {
+		literals_count += (implicant.mask >> (variables->length - i - 1)) & 1U;
 	}
 
-	if (i >= variables->length) {
+	if (literals_count == 0) {
 		return expression_constant(true);
 	}
 
-	struct expression expression = expression_variable(variables->data[i]);
-	if (((implicant.value >> (variables->length - i - 1)) & 1U) == 0) {
-		expression = expression_operation(operation_type_negation, expression);
+	struct expression *literals = allocator_allocate(literals_count * sizeof(*literals));
+	if (literals == NULL) {
+		return expression_constant(false);
 	}
-	for (i++; i < variables->length; i++) {
+
+	size_t j = 0;
+	for (size_t i = 0; i < variables->length; i++) {
 		if (((implicant.mask >> (variables->length - i - 1)) & 1U) == 0) {
 			continue;
 		}
 
-		struct expression expression_ = expression_variable(variables->data[i]);
+		literals[j] = expression_variable(variables_const_elements(variables)[i]);
 		if (((implicant.value >> (variables->length - i - 1)) & 1U) == 0) {
-			expression_ = expression_operation(operation_type_negation, expression_);
+			literals[j] = expression_operation(operation_type_negation, literals[j]);
 		}
+		j++;
+	}
 
-		expression = expression_operation(operation_type_conjunction, expression, expression_);
+	if (literals_count == 1) {
+		struct expression literal = literals[0];
+		allocator_free(literals);
+		return literal;
 	}
 
-	return expression;
+	return expression_operation_from_operands(operation_type_conjunction, literals, literals_count);
 }
 struct expression implicants_to_expression(
 	const struct implicants *implicants,
@@ -739,44 +2596,51 @@ struct expression implicants_to_expression(
 	if (implicants->length == 0) {
 		return expression_constant(false);
 	}
+	const struct implicant *elements = implicants_const_elements(implicants);
+	if (implicants->length == 1) {
+		return expression_from_implicant(elements[0], variables);
+	}
 
-	struct expression expression = expression_from_implicant(implicants->data[0], variables);
-	for (size_t i = 1; i < implicants->length; i++) {
-		expression = expression_operation(
-			operation_type_disjunction,
-			expression,
-			expression_from_implicant(implicants->data[i], variables)
-		);
+	struct expression *products = allocator_allocate(implicants->length * sizeof(*products));
+	if (products == NULL) {
+		return expression_constant(false);
+	}
+	for (size_t i = 0; i < implicants->length; i++) {
+		products[i] = expression_from_implicant(elements[i], variables);
 	}
 
-	return expression;
+	return expression_operation_from_operands(
+		operation_type_disjunction,
+		products,
+		implicants->length
+	);
 }
 
 #define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
 
+struct term {
+	struct implicant implicant;
+	bool combined;
+};
+// most groups only ever hold a few terms, which are then kept inline
+VECTOR_DECLARE(group, struct term, 4)
+VECTOR_DEFINE(group)
+
 struct table {
-	struct group {
-		struct term {
-			struct implicant implicant;
-			bool combined;
-		} *terms;
-		size_t terms_count;
-		size_t terms_capacity;
-	} *groups;
+	struct group *groups;
 	size_t groups_count;
 };
 struct table table_new(size_t groups_count) {
 	struct table table = {
-		.groups = malloc(groups_count * sizeof(*table.groups)),
+		.groups = allocator_allocate(groups_count * sizeof(*table.groups)),
 		.groups_count = groups_count,
 	};
+	if (table.groups == NULL) {
+		table.groups_count = 0;
+	}
 
-	for (size_t j = 0; j < groups_count; j++) {
-		table.groups[j] = (struct group){
-			.terms = NULL,
-			.terms_count = 0,
-			.terms_capacity = 0,
-		};
+	for (size_t j = 0; j < table.groups_count; j++) {
+		table.groups[j] = group_new();
 	}
 
 	return table;
@@ -785,55 +2649,122 @@ void table_drop(struct table *table) {
 	assert(table != NULL);
 
 	for (size_t i = 0; i < table->groups_count; i++) {
-		free(table->groups[i].terms);
+		group_drop(&table->groups[i]);
 	}
-	free(table->groups);
+	allocator_free(table->groups);
 }
-void table_add_implicant(struct table *table, struct implicant implicant) {
+bool table_add_implicant(struct table *table, struct implicant implicant) {
 	assert(table != NULL);
 
 	int ones_count = __builtin_popcountll((implicant.value & implicant.mask));
 	assert(0 <= ones_count && (size_t)ones_count < table->groups_count);
 
 	// if implicant is already in group, then don't add it
+	struct group *group = &table->groups[ones_count];
+	const struct term *terms = group_const_elements(group);
 	bool is_duplicate = false;
-	for (size_t i = 0; i < table->groups[ones_count].terms_count; i++) {
-		if (table->groups[ones_count].terms[i].implicant.mask == implicant.mask &&
-			table->groups[ones_count].terms[i].implicant.value == implicant.value) {
+	for (size_t i = 0; i < group->length; i++) {
+		if (terms[i].implicant.mask == implicant.mask &&
+			terms[i].implicant.value == implicant.value) {
 			is_duplicate = true;
 			break;
 		}
 	}
-	if (!is_duplicate) {
-		// if there isn't enough space for a new term, reallocate.
-		if (table->groups[ones_count].terms_count == table->groups[ones_count].terms_capacity) {
-			if (table->groups[ones_count].terms_capacity == 0) {
-				table->groups[ones_count].terms_capacity = 1;
-			} else {
-				assert(table->groups[ones_count].terms_capacity < SIZE_MAX / 2);
-				table->groups[ones_count].terms_capacity *= 2;
+	if (is_duplicate) {
+		stats_count_duplicate();
+		return true;
+	}
+
+	struct term term = {
+		.implicant = implicant,
+		.combined = false,
+	};
+	return group_append(group, &term, 1);
+}
+
+static size_t table_terms_count_(const struct table *table) {
+	assert(table != NULL);
+
+	size_t terms_count = 0;
+	for (size_t i = 0; i < table->groups_count; i++) {
+		terms_count += table->groups[i].length;
+	}
+	return terms_count;
+}
+
+// computes the prime implicants implicitly, returns `false` if memory ran out or the budget was
+// exceeded
+static bool minterms_to_prime_implicants_zdd_(
+	const struct minterms *minterms,
+	struct implicants *prime_implicants
+) {
+	assert(minterms != NULL && prime_implicants != NULL);
+
+	struct zdd zdd = zdd_new(minterms->variables.length);
+	uint32_t primes = zdd_prime_implicants(&zdd, zdd_from_minterms(&zdd, minterms));
+	bool succeeded = primes != ZDD_NONE && zdd_to_implicants(&zdd, primes, prime_implicants);
+	zdd_drop(&zdd);
+
+	return succeeded;
+}
+
+// returns the minterms themselves as implicants, which cover the function without combining any of
+// them, or as many of them as memory allows
+static struct implicants minterms_to_implicants_(const struct minterms *minterms) {
+	assert(minterms != NULL);
+
+	struct implicants implicants = implicants_new();
+	for (size_t i = 0; i < minterms->length; i++) {
+		bool added = implicants_add(
+			&implicants,
+			(struct implicant){
+				.value = minterms->data[i],
+				.mask = (UINT64_C(1) << minterms->variables.length) - 1U,
 			}
-			table->groups[ones_count].terms = realloc(
-				table->groups[ones_count].terms,
-				table->groups[ones_count].terms_capacity * sizeof(*table->groups[ones_count].terms)
-			);
-			assert(table->groups[ones_count].terms != NULL);
+		);
+		if (!added) {
+			break;
 		}
-		table->groups[ones_count].terms[table->groups[ones_count].terms_count++] = (struct term){
-			.implicant = implicant,
-			.combined = false,
-		};
 	}
+	return implicants;
 }
 
 struct implicants minterms_to_prime_implicants(const struct minterms *minterms) {
 	assert(minterms != NULL);
 
+	struct stats_span span = stats_begin(stats_stage_prime_implicants);
+
+	if (minterms->variables.length >= PRIME_IMPLICANTS_ZDD_VARIABLES) {
+		struct implicants prime_implicants = implicants_new();
+		if (minterms_to_prime_implicants_zdd_(minterms, &prime_implicants)) {
+			stats_end(span);
+			return prime_implicants;
+		}
+		implicants_drop(&prime_implicants);
+
+		// an exceeded budget stays exceeded, so the tabular method isn't started only to be stopped
+		if (budget_exceeded(minterms->length)) {
+			stats_end(span);
+			return minterms_to_implicants_(minterms);
+		}
+	}
+
 	struct table input_table = table_new(minterms->variables.length + 1);
 	struct table output_table = table_new(minterms->variables.length + 1);
 
-	for (size_t i = 0; i < minterms->length; i++) {
-		table_add_implicant(
+	// if memory runs out, the prime implicants that were found so far are returned
+	bool failed = input_table.groups == NULL || output_table.groups == NULL;
+
+	for (size_t i = 0; i < minterms->length && !failed; i++) {
+		// filling the table takes a while for many minterms, each one is looked for in its group
+		if (i % 64 == 0 && budget_exceeded(i)) {
+			table_drop(&input_table);
+			table_drop(&output_table);
+			stats_end(span);
+			return minterms_to_implicants_(minterms);
+		}
+
+		failed = !table_add_implicant(
 			&input_table,
 			(struct implicant){
 				.value = minterms->data[i],
@@ -845,122 +2776,289 @@ struct implicants minterms_to_prime_implicants(const struct minterms *minterms)
 	struct implicants prime_implicants = implicants_new();
 
 	bool minimized = true;
+	bool exceeded = false;
+	size_t pass = 0;
 	do {
 		minimized = true;
 
-		for (size_t i = 0; i < input_table.groups_count; i++) {
-			for (size_t j = 0; j < input_table.groups[i].terms_count; j++) {
+		struct stats_span pass_span = stats_begin(stats_stage_prime_implicants);
+		size_t primes_count = prime_implicants.length;
+
+		for (size_t i = 0; i < input_table.groups_count && !exceeded; i++) {
+			// only the output table grows during a pass, so the terms stay where they are
+			struct term *terms = group_elements(&input_table.groups[i]);
+			for (size_t j = 0; j < input_table.groups[i].length; j++) {
+				if (j % 64 == 0 &&
+					budget_exceeded(
+						table_terms_count_(&input_table) + table_terms_count_(&output_table) +
+						prime_implicants.length
+					)) {
+					exceeded = true;
+					break;
+				}
+
 				if (i != input_table.groups_count - 1) {
-					for (size_t k = 0; k < input_table.groups[i + 1].terms_count; k++) {
+					struct term *next_terms = group_elements(&input_table.groups[i + 1]);
+					for (size_t k = 0; k < input_table.groups[i + 1].length; k++) {
 						// two implicants can be combined if their masks are equal
-						if (implicant_combinable(
-								input_table.groups[i].terms[j].implicant,
-								input_table.groups[i + 1].terms[k].implicant
-							)) {
-
-							input_table.groups[i].terms[j].combined = true;
-							input_table.groups[i + 1].terms[k].combined = true;
+						if (implicant_combinable(terms[j].implicant, next_terms[k].implicant)) {
+							terms[j].combined = true;
+							next_terms[k].combined = true;
 
 							minimized = false;
 
-							table_add_implicant(
-								&output_table,
-								implicant_combine(
-									input_table.groups[i].terms[j].implicant,
-									input_table.groups[i + 1].terms[k].implicant
-								)
-							);
+							if (!table_add_implicant(
+									&output_table,
+									implicant_combine(terms[j].implicant, next_terms[k].implicant)
+								)) {
+								failed = true;
+							}
 						}
 					}
 				}
 
-				if (!input_table.groups[i].terms[j].combined) {
-					implicants_add(&prime_implicants, input_table.groups[i].terms[j].implicant);
+				if (!terms[j].combined) {
+					if (!implicants_add(&prime_implicants, terms[j].implicant)) {
+						failed = true;
+					}
+				}
+			}
+		}
+
+		// the implicants of the pass together with the prime implicants found before it cover every
+		// minterm, so they are returned instead of continuing
+		if (exceeded) {
+			prime_implicants.length = primes_count;
+			for (size_t i = 0; i < input_table.groups_count; i++) {
+				const struct term *terms = group_const_elements(&input_table.groups[i]);
+				for (size_t j = 0; j < input_table.groups[i].length; j++) {
+					if (!implicants_add(&prime_implicants, terms[j].implicant)) {
+						failed = true;
+					}
 				}
 			}
 		}
 
+		if (stats_enabled) {
+			stats_end_pass(
+				pass_span,
+				pass,
+				table_terms_count_(&input_table),
+				table_terms_count_(&output_table),
+				prime_implicants.length - primes_count
+			);
+		}
+		pass++;
+
 		struct table table = input_table;
 		input_table = output_table;
 		output_table = table;
 		for (size_t i = 0; i < output_table.groups_count; i++) {
-			output_table.groups[i].terms_count = 0;
+			output_table.groups[i].length = 0;
 		}
-	} while (!minimized);
+	} while (!minimized && !failed && !exceeded);
 
 	table_drop(&input_table);
 	table_drop(&output_table);
 
+	stats_end(span);
+
 	return prime_implicants;
 }
 
-void implicants_minimalize(struct implicants *implicants, const struct minterms *minterms) {
-	assert(implicants != NULL && minterms != NULL);
+// fills the row of the prime implicant chart of an implicant, the minterms must be sorted if
+// `sorted` is set and none of them has a bit outside of `width`
+static void implicants_chart_row_(
+	struct implicant implicant,
+	const struct minterms *minterms,
+	bool sorted,
+	uint64_t width,
+	uint64_t *row
+) {
+	uint64_t free = ~implicant.mask & width;
+	if ((implicant.value & implicant.mask & ~width) != 0) {
+		return;
+	}
+
+	// a small implicant is cheaper to enumerate, looking each of its points up among the sorted
+	// minterms, than testing it against every minterm
+	size_t free_count = (size_t)__builtin_popcountll(free);
+	if (!sorted || free_count >= 64 || (UINT64_C(1) << free_count) > minterms->length / 16) {
+		for (size_t i = 0; i < minterms->length; i++) {
+			uint64_t covers = ((implicant.value ^ minterms->data[i]) & implicant.mask) == 0;
+			row[i / 64] |= covers << (i % 64);
+		}
+		return;
+	}
 
-	struct {
-		size_t *data;
-		size_t length;
-	} *factors = malloc(minterms->length * sizeof(*factors));
-	assert(factors != NULL);
+	// the subsets of the free bits are enumerated in increasing order, so every point is searched
+	// for after the previous one
+	uint64_t base = implicant.value & implicant.mask;
+	size_t low = 0;
+	uint64_t subset = 0;
+	do {
+		uint64_t point = base | subset;
+		size_t high = minterms->length;
+		while (low < high) {
+			size_t middle = low + (high - low) / 2;
+			if (minterms->data[middle] < point) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		if (low < minterms->length && minterms->data[low] == point) {
+			row[low / 64] |= UINT64_C(1) << (low % 64);
+		}
 
-	size_t *frequencies = malloc(implicants->length * sizeof(*frequencies));
-	memset(frequencies, 0, implicants->length * sizeof(*frequencies));
+		subset = (subset - free) & free;
+	} while (subset != 0);
+}
 
+bool implicants_minimalize(struct implicants *implicants, const struct minterms *minterms) {
+	assert(implicants != NULL && minterms != NULL && implicants->length <= UINT32_MAX);
+
+	struct stats_span span = stats_begin(stats_stage_minimalize);
+
+	// the prime implicant chart has a row of bits per implicant with a bit per minterm, so that the
+	// minterms an implicant covers are counted and marked as covered a word at a time, and the
+	// implicants of every minterm are listed by column for the selection
+	size_t words_count = (minterms->length + 63) / 64;
+	uint64_t *rows = allocator_allocate_zeroed(implicants->length, words_count * sizeof(*rows));
+	uint64_t *covered = allocator_allocate_zeroed(words_count, sizeof(*covered));
+	size_t *uncovered = allocator_allocate_zeroed(implicants->length, sizeof(*uncovered));
+	size_t *columns_starts =
+		allocator_allocate_zeroed(minterms->length + 1, sizeof(*columns_starts));
+	uint32_t *columns = NULL;
+	bool *minimal = allocator_allocate_zeroed(implicants->length, sizeof(*minimal));
+
+	bool sorted = true;
+	uint64_t width = 0;
 	for (size_t i = 0; i < minterms->length; i++) {
-		factors[i].data = malloc(implicants->length * sizeof(*factors[i].data));
-		assert(factors[i].data != NULL);
-		factors[i].length = 0;
+		sorted = sorted && (i == 0 || minterms->data[i - 1] < minterms->data[i]);
+		width |= minterms->data[i];
+	}
+	width = width != 0 ? UINT64_MAX >> __builtin_clzll(width) : 0;
+
+	bool allocated = rows != NULL && covered != NULL && uncovered != NULL &&
+					 columns_starts != NULL && minimal != NULL;
+	bool exceeded = false;
+	for (size_t j = 0; allocated && j < implicants->length; j++) {
+		if (j % 64 == 0 && budget_exceeded(implicants->length)) {
+			exceeded = true;
+			break;
+		}
 
-		for (size_t j = 0; j < implicants->length; j++) {
-			if (((implicants->data[j].value ^ minterms->data[i]) & implicants->data[j].mask) == 0) {
-				factors[i].data[factors[i].length++] = j;
-				frequencies[j]++;
+		uint64_t *row = &rows[j * words_count];
+		implicants_chart_row_(implicants_elements(implicants)[j], minterms, sorted, width, row);
+		for (size_t k = 0; k < words_count; k++) {
+			uncovered[j] += (size_t)__builtin_popcountll(row[k]);
+			for (uint64_t bits = row[k]; bits != 0; bits &= bits - 1) {
+				columns_starts[k * 64 + (size_t)__builtin_ctzll(bits) + 1]++;
 			}
 		}
 	}
 
-	bool *minimal = malloc(implicants->length * sizeof(*minimal));
-	memset(minimal, false, implicants->length * sizeof(*minimal));
-	for (size_t i = 0; i < minterms->length; i++) {
-		bool absorbed = false;
-		for (size_t j = 0; j < factors[i].length; j++) {
-			if (minimal[factors[i].data[j]]) {
-				absorbed = true;
-				break;
-			}
+	if (allocated && !exceeded) {
+		for (size_t i = 0; i < minterms->length; i++) {
+			columns_starts[i + 1] += columns_starts[i];
 		}
-		if (!absorbed) {
-			size_t most_frequent = factors[i].data[0];
-			for (size_t j = 1; j < factors[i].length; j++) {
-				if (frequencies[factors[i].data[j]] > frequencies[most_frequent]) {
-					most_frequent = factors[i].data[j];
-				}
+		columns = allocator_allocate_zeroed(columns_starts[minterms->length], sizeof(*columns));
+		allocated = columns != NULL;
+	}
+
+	// if memory runs out or the budget is exceeded before the chart is complete, the implicants
+	// are left as they are, together they still cover the minterms
+	if (!allocated || exceeded) {
+		allocator_free(rows);
+		allocator_free(covered);
+		allocator_free(uncovered);
+		allocator_free(columns_starts);
+		allocator_free(columns);
+		allocator_free(minimal);
+		stats_end(span);
+		return false;
+	}
+
+	// the starts are advanced while the columns are filled, and shifted back afterwards
+	for (size_t j = 0; j < implicants->length; j++) {
+		const uint64_t *row = &rows[j * words_count];
+		for (size_t k = 0; k < words_count; k++) {
+			for (uint64_t bits = row[k]; bits != 0; bits &= bits - 1) {
+				size_t i = k * 64 + (size_t)__builtin_ctzll(bits);
+				columns[columns_starts[i]++] = (uint32_t)j;
 			}
-			minimal[most_frequent] = true;
 		}
+	}
+	for (size_t i = minterms->length; i > 0; i--) {
+		columns_starts[i] = columns_starts[i - 1];
+	}
+	columns_starts[0] = 0;
 
-		for (size_t j = 0; j < factors[i].length; j++) {
-			frequencies[factors[i].data[j]]--;
+	for (size_t word = 0; word < words_count; word++) {
+		// once the budget is exceeded, the rest of the minterms are covered by their first
+		// implicant instead of the one that covers the most uncovered minterms
+		if (!exceeded) {
+			exceeded = budget_exceeded(implicants->length);
 		}
-	}
 
-	free(frequencies);
+		uint64_t pending = ~covered[word];
+		if (word == words_count - 1 && minterms->length % 64 != 0) {
+			pending &= (UINT64_C(1) << (minterms->length % 64)) - 1;
+		}
+		while (pending != 0) {
+			size_t i = word * 64 + (size_t)__builtin_ctzll(pending);
+			pending &= pending - 1;
+
+			// a minterm might not be covered by any implicant if they are incomplete
+			if (columns_starts[i] == columns_starts[i + 1]) {
+				continue;
+			}
 
-	for (size_t i = 0; i < minterms->length; i++) {
-		free(factors[i].data);
+			size_t most_covering = columns[columns_starts[i]];
+			for (size_t j = columns_starts[i] + 1; j < columns_starts[i + 1] && !exceeded; j++) {
+				if (uncovered[columns[j]] > uncovered[most_covering]) {
+					most_covering = columns[j];
+				}
+			}
+			minimal[most_covering] = true;
+
+			// the minterms before this one are all covered already, so the cover is only updated
+			// from this word on, and the implicants of the newly covered minterms lose them
+			const uint64_t *row = &rows[most_covering * words_count];
+			for (size_t k = word; k < words_count; k++) {
+				uint64_t newly_covered = row[k] & ~covered[k];
+				covered[k] |= row[k];
+				for (; newly_covered != 0; newly_covered &= newly_covered - 1) {
+					size_t l = k * 64 + (size_t)__builtin_ctzll(newly_covered);
+					for (size_t m = columns_starts[l]; m < columns_starts[l + 1]; m++) {
+						uncovered[columns[m]]--;
+					}
+				}
+			}
+			pending &= ~row[word];
+		}
 	}
-	free(factors);
 
-	for (ptrdiff_t i = (ptrdiff_t)implicants->length - 1; i >= 0; i--) {
-		if (!minimal[i]) {
-			memmove(
-				&implicants->data[i],
-				&implicants->data[i + 1],
-				(implicants->length - (size_t)i - 1) * sizeof(*implicants->data)
-			);
-			implicants->length--;
+	allocator_free(rows);
+	allocator_free(covered);
+	allocator_free(uncovered);
+	allocator_free(columns_starts);
+	allocator_free(columns);
+
+	// the minimal implicants are moved to the front in order
+	struct implicant *elements = implicants_elements(implicants);
+	size_t length = 0;
+	for (size_t j = 0; j < implicants->length; j++) {
+		if (minimal[j]) {
+			elements[length++] = elements[j];
 		}
 	}
+	implicants->length = length;
+
+	allocator_free(minimal);
+
+	stats_end(span);
 
-	free(minimal);
+	return true;
 }
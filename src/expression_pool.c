@@ -0,0 +1,1568 @@
+#include <expression_pool.h>
+
+#include <allocator.h>
+#include <budget.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// grows an array to `capacity` elements, if memory runs out `failed` is set and the array is left
+// as it was
+#define EXPRESSION_POOL_REALLOCATE(pointer, capacity, failed)                                      \
+	do {                                                                                           \
+		void *pointer_ = allocator_reallocate((pointer), (capacity) * sizeof(*(pointer)));         \
+		if (pointer_ != NULL) {                                                                    \
+			(pointer) = pointer_;                                                                  \
+		} else {                                                                                   \
+			(failed) = true;                                                                       \
+		}                                                                                          \
+	} while (0)
+
+struct expression_pool expression_pool_new(void) {
+	return (struct expression_pool){
+		.length = 0,
+		.capacity = 0,
+		.types = NULL,
+		.values = NULL,
+		.operands_starts = NULL,
+		.operands_counts = NULL,
+		.operands = NULL,
+		.operands_length = 0,
+		.operands_capacity = 0,
+		.buckets = NULL,
+		.buckets_count = 0,
+	};
+}
+
+void expression_pool_drop(struct expression_pool *pool) {
+	assert(pool != NULL);
+
+	allocator_free(pool->types);
+	allocator_free(pool->values);
+	allocator_free(pool->operands_starts);
+	allocator_free(pool->operands_counts);
+	allocator_free(pool->operands);
+	allocator_free(pool->buckets);
+}
+
+static uint64_t expression_pool_hash_(
+	uint8_t type,
+	uint8_t value,
+	const uint32_t *operands,
+	size_t operands_count
+) {
+	uint64_t hash = UINT64_C(14695981039346656037);
+	hash = (hash ^ type) * UINT64_C(1099511628211);
+	hash = (hash ^ value) * UINT64_C(1099511628211);
+	for (size_t i = 0; i < operands_count; i++) {
+		hash = (hash ^ operands[i]) * UINT64_C(1099511628211);
+	}
+
+	hash ^= hash >> 33;
+	hash *= UINT64_C(0xff51afd7ed558ccd);
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+// finds the node with the given contents, sets `bucket` to the bucket it is or would be stored in
+static uint32_t expression_pool_find_(
+	const struct expression_pool *pool,
+	uint8_t type,
+	uint8_t value,
+	const uint32_t *operands,
+	size_t operands_count,
+	size_t *bucket
+) {
+	assert(pool != NULL && pool->buckets_count != 0);
+
+	size_t mask = pool->buckets_count - 1;
+	size_t i = (size_t)expression_pool_hash_(type, value, operands, operands_count) & mask;
+	while (pool->buckets[i] != EXPRESSION_POOL_NONE) {
+		uint32_t node = pool->buckets[i];
+		if (pool->types[node] == type && pool->values[node] == value &&
+			pool->operands_counts[node] == operands_count &&
+			(operands_count == 0 || memcmp(
+										&pool->operands[pool->operands_starts[node]],
+										operands,
+										operands_count * sizeof(*operands)
+									) == 0)) {
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+
+	if (bucket != NULL) {
+		*bucket = i;
+	}
+
+	return pool->buckets[i];
+}
+
+// doubles the number of buckets, returns `false` if memory ran out, in which case they are kept
+static bool expression_pool_rehash_(struct expression_pool *pool) {
+	assert(pool != NULL);
+
+	size_t buckets_count = pool->buckets_count == 0 ? 64 : 2 * pool->buckets_count;
+	uint32_t *buckets = allocator_allocate(buckets_count * sizeof(*buckets));
+	if (buckets == NULL) {
+		return false;
+	}
+	allocator_free(pool->buckets);
+	pool->buckets = buckets;
+	pool->buckets_count = buckets_count;
+	memset(pool->buckets, 0xFF, pool->buckets_count * sizeof(*pool->buckets));
+
+	for (size_t i = 0; i < pool->length; i++) {
+		size_t bucket;
+		(void)expression_pool_find_(
+			pool,
+			pool->types[i],
+			pool->values[i],
+			&pool->operands[pool->operands_starts[i]],
+			pool->operands_counts[i],
+			&bucket
+		);
+		pool->buckets[bucket] = (uint32_t)i;
+	}
+
+	return true;
+}
+
+// adds a node unless an identical one exists, `operands` mustn't point into the pool, returns
+// `EXPRESSION_POOL_NONE` if memory ran out
+static uint32_t expression_pool_add_(
+	struct expression_pool *pool,
+	uint8_t type,
+	uint8_t value,
+	const uint32_t *operands,
+	size_t operands_count
+) {
+	assert(pool != NULL);
+
+	// keep the table at most half full
+	if (2 * (pool->length + 1) > pool->buckets_count && !expression_pool_rehash_(pool)) {
+		return EXPRESSION_POOL_NONE;
+	}
+
+	size_t bucket;
+	uint32_t node = expression_pool_find_(pool, type, value, operands, operands_count, &bucket);
+	if (node != EXPRESSION_POOL_NONE) {
+		return node;
+	}
+
+	assert(pool->length < EXPRESSION_POOL_NONE && operands_count <= UINT32_MAX);
+	assert(pool->operands_length + operands_count <= UINT32_MAX);
+
+	// the arrays that were grown before memory ran out keep their new sizes, which is harmless as
+	// the capacities are only updated once all of them grew
+	bool failed = false;
+	if (pool->length == pool->capacity) {
+		size_t capacity = pool->capacity == 0 ? 64 : 2 * pool->capacity;
+		EXPRESSION_POOL_REALLOCATE(pool->types, capacity, failed);
+		EXPRESSION_POOL_REALLOCATE(pool->values, capacity, failed);
+		EXPRESSION_POOL_REALLOCATE(pool->operands_starts, capacity, failed);
+		EXPRESSION_POOL_REALLOCATE(pool->operands_counts, capacity, failed);
+		if (failed) {
+			return EXPRESSION_POOL_NONE;
+		}
+		pool->capacity = capacity;
+	}
+	if (pool->operands_length + operands_count > pool->operands_capacity) {
+		size_t capacity = pool->operands_capacity;
+		while (pool->operands_length + operands_count > capacity) {
+			capacity = capacity == 0 ? 64 : 2 * capacity;
+		}
+		EXPRESSION_POOL_REALLOCATE(pool->operands, capacity, failed);
+		if (failed) {
+			return EXPRESSION_POOL_NONE;
+		}
+		pool->operands_capacity = capacity;
+	}
+
+	node = (uint32_t)pool->length++;
+	pool->types[node] = type;
+	pool->values[node] = value;
+	pool->operands_starts[node] = (uint32_t)pool->operands_length;
+	pool->operands_counts[node] = (uint32_t)operands_count;
+	if (operands_count != 0) {
+		memcpy(
+			&pool->operands[pool->operands_length],
+			operands,
+			operands_count * sizeof(*operands)
+		);
+		pool->operands_length += operands_count;
+	}
+	pool->buckets[bucket] = node;
+
+	return node;
+}
+
+uint32_t expression_pool_add_constant(struct expression_pool *pool, bool value) {
+	assert(pool != NULL);
+
+	return expression_pool_add_(pool, expression_type_constant, value, NULL, 0);
+}
+
+uint32_t expression_pool_add_variable(struct expression_pool *pool, char name) {
+	assert(pool != NULL && isalpha((unsigned char)name));
+
+	return expression_pool_add_(pool, expression_type_variable, (uint8_t)name, NULL, 0);
+}
+
+uint32_t expression_pool_add_operation(
+	struct expression_pool *pool,
+	enum operation_type type,
+	const uint32_t *operands,
+	size_t operands_count
+) {
+	assert(pool != NULL && operands != NULL);
+	assert(
+		operation_type_is_variadic(type) ? operands_count >= operation_type_arity(type)
+										 : operands_count == operation_type_arity(type)
+	);
+	for (size_t i = 0; i < operands_count; i++) {
+		if (operands[i] == EXPRESSION_POOL_NONE) {
+			return EXPRESSION_POOL_NONE;
+		}
+		assert(operands[i] < pool->length);
+	}
+
+	return expression_pool_add_(
+		pool,
+		expression_type_operation,
+		(uint8_t)type,
+		operands,
+		operands_count
+	);
+}
+
+uint32_t expression_pool_add_expression(
+	struct expression_pool *pool,
+	const struct expression *expression
+) {
+	assert(pool != NULL && expression != NULL);
+
+	// the expressions that are being visited, and the indices of the operands that were added
+	struct {
+		const struct expression *expression;
+		size_t next; ///< Index of the next operand to be visited.
+	} *stack = NULL;
+	size_t stack_length = 0;
+	size_t stack_capacity = 0;
+	uint32_t *nodes = NULL;
+	size_t nodes_length = 0;
+	size_t nodes_capacity = 0;
+	bool failed = false;
+
+#define push(expression_)                                                                          \
+	do {                                                                                           \
+		if (stack_length == stack_capacity) {                                                      \
+			size_t capacity = stack_capacity == 0 ? 16 : 2 * stack_capacity;                       \
+			EXPRESSION_POOL_REALLOCATE(stack, capacity, failed);                                   \
+			if (failed) {                                                                          \
+				break;                                                                             \
+			}                                                                                      \
+			stack_capacity = capacity;                                                             \
+		}                                                                                          \
+		stack[stack_length].expression = (expression_);                                            \
+		stack[stack_length].next = 0;                                                              \
+		stack_length++;                                                                            \
+	} while (0)
+
+	push(expression);
+	while (!failed && stack_length != 0) {
+		const struct expression *current = stack[stack_length - 1].expression;
+		if (current->type == expression_type_operation &&
+			stack[stack_length - 1].next < current->operation.operands_count) {
+			push(&current->operation.operands[stack[stack_length - 1].next++]);
+			continue;
+		}
+		stack_length--;
+
+		uint32_t node = EXPRESSION_POOL_NONE;
+		switch (current->type) {
+			case expression_type_constant: {
+				node = expression_pool_add_constant(pool, current->constant.value);
+			} break;
+			case expression_type_variable: {
+				node = expression_pool_add_variable(pool, current->variable.name);
+			} break;
+			case expression_type_operation: {
+				nodes_length -= current->operation.operands_count;
+				node = expression_pool_add_operation(
+					pool,
+					current->operation.type,
+					&nodes[nodes_length],
+					current->operation.operands_count
+				);
+			} break;
+			default: assert(false);
+		}
+		if (node == EXPRESSION_POOL_NONE) {
+			failed = true;
+			break;
+		}
+
+		if (nodes_length == nodes_capacity) {
+			size_t capacity = nodes_capacity == 0 ? 16 : 2 * nodes_capacity;
+			EXPRESSION_POOL_REALLOCATE(nodes, capacity, failed);
+			if (failed) {
+				break;
+			}
+			nodes_capacity = capacity;
+		}
+		nodes[nodes_length++] = node;
+	}
+
+#undef push
+
+	uint32_t root = !failed ? nodes[0] : EXPRESSION_POOL_NONE;
+
+	allocator_free(stack);
+	allocator_free(nodes);
+
+	return root;
+}
+
+struct expression_pool expression_pool_from_expression(const struct expression *expression) {
+	assert(expression != NULL);
+
+	struct expression_pool pool = expression_pool_new();
+	if (expression_pool_add_expression(&pool, expression) == EXPRESSION_POOL_NONE) {
+		expression_pool_drop(&pool);
+		pool = expression_pool_new();
+	}
+
+	return pool;
+}
+
+struct expression expression_pool_to_expression(const struct expression_pool *pool) {
+	assert(pool != NULL && pool->length != 0);
+
+	struct {
+		uint32_t node;
+		uint32_t next; ///< Index of the next operand to be visited.
+	} *stack = NULL;
+	size_t stack_length = 0;
+	size_t stack_capacity = 0;
+	struct expression *expressions = NULL;
+	size_t expressions_length = 0;
+	size_t expressions_capacity = 0;
+	bool failed = false;
+
+#define push(node_)                                                                                \
+	do {                                                                                           \
+		if (stack_length == stack_capacity) {                                                      \
+			size_t capacity = stack_capacity == 0 ? 16 : 2 * stack_capacity;                       \
+			EXPRESSION_POOL_REALLOCATE(stack, capacity, failed);                                   \
+			if (failed) {                                                                          \
+				break;                                                                             \
+			}                                                                                      \
+			stack_capacity = capacity;                                                             \
+		}                                                                                          \
+		stack[stack_length].node = (node_);                                                        \
+		stack[stack_length].next = 0;                                                              \
+		stack_length++;                                                                            \
+	} while (0)
+
+	push(expression_pool_root(pool));
+	while (!failed && stack_length != 0) {
+		uint32_t node = stack[stack_length - 1].node;
+		if (stack[stack_length - 1].next < pool->operands_counts[node]) {
+			push(pool->operands[pool->operands_starts[node] + stack[stack_length - 1].next++]);
+			continue;
+		}
+		stack_length--;
+
+		struct expression expression;
+		switch (pool->types[node]) {
+			case expression_type_constant: {
+				expression = expression_constant(pool->values[node]);
+			} break;
+			case expression_type_variable: {
+				expression = expression_variable((char)pool->values[node]);
+			} break;
+			case expression_type_operation: {
+				size_t operands_count = pool->operands_counts[node];
+				struct expression *operands =
+					allocator_allocate(operands_count * sizeof(*operands));
+				if (operands == NULL) {
+					failed = true;
+					break;
+				}
+				expressions_length -= operands_count;
+				memcpy(
+					operands,
+					&expressions[expressions_length],
+					operands_count * sizeof(*operands)
+				);
+				expression = expression_operation_from_operands(
+					(enum operation_type)pool->values[node],
+					operands,
+					operands_count
+				);
+			} break;
+			default: assert(false);
+		}
+		if (failed) {
+			break;
+		}
+
+		if (expressions_length == expressions_capacity) {
+			size_t capacity = expressions_capacity == 0 ? 16 : 2 * expressions_capacity;
+			EXPRESSION_POOL_REALLOCATE(expressions, capacity, failed);
+			if (failed) {
+				expression_drop(&expression);
+				break;
+			}
+			expressions_capacity = capacity;
+		}
+		expressions[expressions_length++] = expression;
+	}
+
+#undef push
+
+	// the expressions that were built before memory ran out are dropped
+	struct expression expression = expression_constant(false);
+	if (!failed) {
+		expression = expressions[0];
+	} else {
+		for (size_t i = 0; i < expressions_length; i++) {
+			expression_drop(&expressions[i]);
+		}
+	}
+
+	allocator_free(stack);
+	allocator_free(expressions);
+
+	return expression;
+}
+
+// evaluates the nodes up to and including `root` 64 environments at a time
+// evaluates a node for 64 environments, its operands must already be evaluated
+static uint64_t expression_pool_evaluate_node_(
+	const struct expression_pool *pool,
+	const uint64_t *values,
+	const uint64_t *variables,
+	size_t node
+) {
+	assert(pool != NULL && values != NULL && variables != NULL && node < pool->length);
+
+	switch (pool->types[node]) {
+		case expression_type_constant: return pool->values[node] ? UINT64_MAX : 0;
+		case expression_type_variable: {
+			return variables[environment_variable_index((char)pool->values[node])];
+		}
+		case expression_type_operation: {
+			const uint32_t *operands = &pool->operands[pool->operands_starts[node]];
+			size_t operands_count = pool->operands_counts[node];
+			switch ((enum operation_type)pool->values[node]) {
+				case operation_type_conjunction: {
+					uint64_t value = UINT64_MAX;
+					for (size_t j = 0; j < operands_count; j++) {
+						value &= values[operands[j]];
+					}
+					return value;
+				}
+				case operation_type_disjunction: {
+					uint64_t value = 0;
+					for (size_t j = 0; j < operands_count; j++) {
+						value |= values[operands[j]];
+					}
+					return value;
+				}
+				case operation_type_negation: return ~values[operands[0]];
+				case operation_type_exclusive_disjunction: {
+					return values[operands[0]] ^ values[operands[1]];
+				}
+				case operation_type_biconditional: {
+					return ~(values[operands[0]] ^ values[operands[1]]);
+				}
+				case operation_type_alternative_denial: {
+					return ~(values[operands[0]] & values[operands[1]]);
+				}
+				case operation_type_joint_denial: {
+					return ~(values[operands[0]] | values[operands[1]]);
+				}
+				case operation_type_implication: {
+					return ~values[operands[0]] | values[operands[1]];
+				}
+				default: assert(false);
+			}
+		} break;
+		default: assert(false);
+	}
+
+	return 0;
+}
+
+// evaluates a node for 64 environments by recursing into its operands, which needs no memory but
+// evaluates shared nodes once for every use
+static uint64_t expression_pool_evaluate_recursive_(
+	const struct expression_pool *pool,
+	uint32_t node,
+	const uint64_t *variables
+) {
+	assert(pool != NULL && node < pool->length && variables != NULL);
+
+	switch (pool->types[node]) {
+		case expression_type_constant: return pool->values[node] ? UINT64_MAX : 0;
+		case expression_type_variable: {
+			return variables[environment_variable_index((char)pool->values[node])];
+		}
+		case expression_type_operation: {
+			const uint32_t *operands = &pool->operands[pool->operands_starts[node]];
+			size_t operands_count = pool->operands_counts[node];
+			uint64_t first = expression_pool_evaluate_recursive_(pool, operands[0], variables);
+			switch ((enum operation_type)pool->values[node]) {
+				case operation_type_conjunction: {
+					for (size_t j = 1; j < operands_count; j++) {
+						first &= expression_pool_evaluate_recursive_(pool, operands[j], variables);
+					}
+					return first;
+				}
+				case operation_type_disjunction: {
+					for (size_t j = 1; j < operands_count; j++) {
+						first |= expression_pool_evaluate_recursive_(pool, operands[j], variables);
+					}
+					return first;
+				}
+				case operation_type_negation: return ~first;
+				default: break;
+			}
+
+			uint64_t second = expression_pool_evaluate_recursive_(pool, operands[1], variables);
+			switch ((enum operation_type)pool->values[node]) {
+				case operation_type_exclusive_disjunction: return first ^ second;
+				case operation_type_biconditional: return ~(first ^ second);
+				case operation_type_alternative_denial: return ~(first & second);
+				case operation_type_joint_denial: return ~(first | second);
+				case operation_type_implication: return ~first | second;
+				default: assert(false);
+			}
+		} break;
+		default: assert(false);
+	}
+
+	return 0;
+}
+
+static uint64_t expression_pool_evaluate_(
+	const struct expression_pool *pool,
+	uint32_t root,
+	const uint64_t *variables
+) {
+	assert(pool != NULL && root < pool->length && variables != NULL);
+
+	uint64_t *values = allocator_allocate(((size_t)root + 1) * sizeof(*values));
+	if (values == NULL) {
+		return expression_pool_evaluate_recursive_(pool, root, variables);
+	}
+
+	for (size_t i = 0; i <= root; i++) {
+		values[i] = expression_pool_evaluate_node_(pool, values, variables, i);
+	}
+
+	uint64_t value = values[root];
+
+	allocator_free(values);
+
+	return value;
+}
+
+bool expression_pool_evaluate(
+	const struct expression_pool *pool,
+	const struct environment *environment
+) {
+	assert(pool != NULL && pool->length != 0);
+
+	// every environment of the parallel evaluation is the given one
+	uint64_t variables[VARIABLES_COUNT];
+	for (size_t i = 0; i < VARIABLES_COUNT; i++) {
+		variables[i] = environment != NULL && ((environment->variables >> i) & 1U) ? UINT64_MAX : 0;
+	}
+
+	return expression_pool_evaluate_(pool, expression_pool_root(pool), variables) & 1U;
+}
+
+uint64_t expression_pool_evaluate_parallel(
+	const struct expression_pool *pool,
+	const uint64_t *variables
+) {
+	assert(pool != NULL && pool->length != 0 && variables != NULL);
+
+	return expression_pool_evaluate_(pool, expression_pool_root(pool), variables);
+}
+
+bool expression_pool_evaluate_table(
+	const struct expression_pool *pool,
+	const struct variables *variables,
+	uint64_t *table
+) {
+	assert(pool != NULL && pool->length != 0 && variables != NULL && table != NULL);
+
+	static const uint64_t patterns[] = {
+		UINT64_C(0xAAAAAAAAAAAAAAAA), UINT64_C(0xCCCCCCCCCCCCCCCC),
+		UINT64_C(0xF0F0F0F0F0F0F0F0), UINT64_C(0xFF00FF00FF00FF00),
+		UINT64_C(0xFFFF0000FFFF0000), UINT64_C(0xFFFFFFFF00000000),
+	};
+
+	const char *names = variables_const_elements(variables);
+	size_t length = variables->length;
+	size_t high = length <= 6 ? 0 : length - 6;
+	uint32_t root = expression_pool_root(pool);
+
+	// the last 6 variables take every value within a word, the others start false
+	uint64_t words[VARIABLES_COUNT] = { 0 };
+	for (size_t i = 0; i < length - high; i++) {
+		words[environment_variable_index(names[length - i - 1])] = patterns[i];
+	}
+
+	uint64_t *values = allocator_allocate(pool->length * sizeof(*values));
+	// bit `j` of a node's support is set if it depends on the variable of bit `j` of a word's index
+	uint64_t *supports = allocator_allocate(pool->length * sizeof(*supports));
+	uint32_t *cones_starts = allocator_allocate_zeroed(high + 1, sizeof(*cones_starts));
+	if (values == NULL || supports == NULL || cones_starts == NULL) {
+		allocator_free(values);
+		allocator_free(supports);
+		allocator_free(cones_starts);
+		return false;
+	}
+
+	size_t cones_length = 0;
+	for (size_t i = 0; i < pool->length; i++) {
+		values[i] = expression_pool_evaluate_node_(pool, values, words, i);
+
+		supports[i] = 0;
+		if (pool->types[i] == expression_type_variable) {
+			for (size_t j = 0; j < high; j++) {
+				if (names[high - j - 1] == (char)pool->values[i]) {
+					supports[i] = UINT64_C(1) << j;
+				}
+			}
+		} else if (pool->types[i] == expression_type_operation) {
+			for (size_t j = 0; j < pool->operands_counts[i]; j++) {
+				supports[i] |= supports[pool->operands[pool->operands_starts[i] + j]];
+			}
+		}
+		cones_length += (size_t)__builtin_popcountll(supports[i]);
+	}
+	table[0] = values[root];
+	if (length < 6) {
+		table[0] &= (UINT64_C(1) << (1U << length)) - 1U;
+	}
+
+	// the cone of a variable is every node that depends on it, in topological order
+	uint32_t *cones = allocator_allocate((cones_length + 1) * sizeof(*cones));
+	if (cones == NULL) {
+		allocator_free(values);
+		allocator_free(supports);
+		allocator_free(cones_starts);
+		return false;
+	}
+	for (size_t i = 0; i < pool->length; i++) {
+		for (uint64_t support = supports[i]; support != 0; support &= support - 1) {
+			cones_starts[__builtin_ctzll(support) + 1]++;
+		}
+	}
+	for (size_t j = 0; j < high; j++) {
+		cones_starts[j + 1] += cones_starts[j];
+	}
+	// the starts are moved to the ends of the cones while filling them, and back afterwards
+	for (size_t i = 0; i < pool->length; i++) {
+		for (uint64_t support = supports[i]; support != 0; support &= support - 1) {
+			cones[cones_starts[__builtin_ctzll(support)]++] = (uint32_t)i;
+		}
+	}
+	for (size_t j = high; j > 0; j--) {
+		cones_starts[j] = cones_starts[j - 1];
+	}
+	cones_starts[0] = 0;
+	allocator_free(supports);
+
+	// consecutive indices of the Gray code differ in a single bit, so every step only flips one
+	// variable and only its cone has to be evaluated again
+	bool evaluated = true;
+	for (size_t step = 1; step < ((size_t)1 << high); step++) {
+		if (step % 64 == 0 && budget_exceeded(0)) {
+			evaluated = false;
+			break;
+		}
+
+		size_t bit = (size_t)__builtin_ctzll(step);
+		words[environment_variable_index(names[high - bit - 1])] ^= UINT64_MAX;
+		for (size_t i = cones_starts[bit]; i < cones_starts[bit + 1]; i++) {
+			values[cones[i]] = expression_pool_evaluate_node_(pool, values, words, cones[i]);
+		}
+
+		table[step ^ (step >> 1)] = values[root];
+	}
+
+	allocator_free(values);
+	allocator_free(cones);
+	allocator_free(cones_starts);
+
+	return evaluated;
+}
+
+bool expression_pool_evaluate_block(
+	const struct expression_pool *pool,
+	const uint64_t *variables,
+	size_t words,
+	uint64_t *results
+) {
+	assert(pool != NULL && pool->length != 0 && variables != NULL && results != NULL);
+
+	uint64_t *values = allocator_allocate(pool->length * words * sizeof(*values));
+	if (values == NULL) {
+		return false;
+	}
+
+// applies `statement` to every word `k` of the block
+#define EXPRESSION_POOL_BLOCK_(statement)    \
+	do {                                     \
+		for (size_t k = 0; k < words; k++) { \
+			statement;                       \
+		}                                    \
+	} while (false)
+
+	for (size_t i = 0; i < pool->length; i++) {
+		uint64_t *value = &values[i * words];
+		switch (pool->types[i]) {
+			case expression_type_constant: {
+				uint64_t constant = pool->values[i] ? UINT64_MAX : 0;
+				EXPRESSION_POOL_BLOCK_(value[k] = constant);
+			} break;
+			case expression_type_variable: {
+				const uint64_t *variable =
+					&variables[environment_variable_index((char)pool->values[i]) * words];
+				EXPRESSION_POOL_BLOCK_(value[k] = variable[k]);
+			} break;
+			case expression_type_operation: {
+				const uint32_t *operands = &pool->operands[pool->operands_starts[i]];
+				size_t operands_count = pool->operands_counts[i];
+				const uint64_t *first =
+					operands_count > 0 ? &values[(size_t)operands[0] * words] : NULL;
+				const uint64_t *second =
+					operands_count > 1 ? &values[(size_t)operands[1] * words] : NULL;
+				switch ((enum operation_type)pool->values[i]) {
+					case operation_type_conjunction: {
+						EXPRESSION_POOL_BLOCK_(value[k] = UINT64_MAX);
+						for (size_t j = 0; j < operands_count; j++) {
+							const uint64_t *operand = &values[(size_t)operands[j] * words];
+							EXPRESSION_POOL_BLOCK_(value[k] &= operand[k]);
+						}
+					} break;
+					case operation_type_disjunction: {
+						EXPRESSION_POOL_BLOCK_(value[k] = 0);
+						for (size_t j = 0; j < operands_count; j++) {
+							const uint64_t *operand = &values[(size_t)operands[j] * words];
+							EXPRESSION_POOL_BLOCK_(value[k] |= operand[k]);
+						}
+					} break;
+					case operation_type_negation: {
+						EXPRESSION_POOL_BLOCK_(value[k] = ~first[k]);
+					} break;
+					case operation_type_exclusive_disjunction: {
+						EXPRESSION_POOL_BLOCK_(value[k] = first[k] ^ second[k]);
+					} break;
+					case operation_type_biconditional: {
+						EXPRESSION_POOL_BLOCK_(value[k] = ~(first[k] ^ second[k]));
+					} break;
+					case operation_type_alternative_denial: {
+						EXPRESSION_POOL_BLOCK_(value[k] = ~(first[k] & second[k]));
+					} break;
+					case operation_type_joint_denial: {
+						EXPRESSION_POOL_BLOCK_(value[k] = ~(first[k] | second[k]));
+					} break;
+					case operation_type_implication: {
+						EXPRESSION_POOL_BLOCK_(value[k] = ~first[k] | second[k]);
+					} break;
+					default: assert(false);
+				}
+			} break;
+			default: assert(false);
+		}
+	}
+
+#undef EXPRESSION_POOL_BLOCK_
+
+	memcpy(results, &values[(pool->length - 1) * words], words * sizeof(*results));
+
+	allocator_free(values);
+
+	return true;
+}
+
+// returns the operand of a negation, or `EXPRESSION_POOL_NONE` if the node isn't one
+static uint32_t expression_pool_negated_(const struct expression_pool *pool, uint32_t node) {
+	assert(pool != NULL && node < pool->length);
+
+	if (pool->types[node] != expression_type_operation ||
+		pool->values[node] != operation_type_negation) {
+		return EXPRESSION_POOL_NONE;
+	}
+
+	return pool->operands[pool->operands_starts[node]];
+}
+
+// checks whether a node is an operation of the given type
+static bool expression_pool_is_operation_(
+	const struct expression_pool *pool,
+	uint32_t node,
+	enum operation_type type
+) {
+	assert(pool != NULL && node < pool->length);
+
+	return pool->types[node] == expression_type_operation && pool->values[node] == type;
+}
+
+// returns the operation that computes the negation of an operation of type `type`, or `type` itself
+// if there is none
+static enum operation_type expression_pool_complement_type_(enum operation_type type) {
+	switch (type) {
+		case operation_type_conjunction: return operation_type_alternative_denial;
+		case operation_type_alternative_denial: return operation_type_conjunction;
+		case operation_type_disjunction: return operation_type_joint_denial;
+		case operation_type_joint_denial: return operation_type_disjunction;
+		case operation_type_exclusive_disjunction: return operation_type_biconditional;
+		case operation_type_biconditional: return operation_type_exclusive_disjunction;
+		case operation_type_negation:
+		case operation_type_implication: return type;
+		default: assert(false);
+	}
+}
+
+// returns the node that computes the negation of `node` if the pool already contains it
+static uint32_t expression_pool_find_complement_(
+	const struct expression_pool *pool,
+	uint32_t node
+) {
+	assert(pool != NULL && node < pool->length);
+
+	uint32_t complement = expression_pool_negated_(pool, node);
+	if (complement != EXPRESSION_POOL_NONE) {
+		return complement;
+	}
+
+	complement = expression_pool_find_(
+		pool,
+		expression_type_operation,
+		operation_type_negation,
+		&node,
+		1,
+		NULL
+	);
+	if (complement != EXPRESSION_POOL_NONE || pool->types[node] != expression_type_operation ||
+		pool->operands_counts[node] != 2) {
+		return complement;
+	}
+
+	// x * y and x ~& y
+	enum operation_type type = (enum operation_type)pool->values[node];
+	if (expression_pool_complement_type_(type) == type) {
+		return EXPRESSION_POOL_NONE;
+	}
+	return expression_pool_find_(
+		pool,
+		expression_type_operation,
+		(uint8_t)expression_pool_complement_type_(type),
+		&pool->operands[pool->operands_starts[node]],
+		2,
+		NULL
+	);
+}
+
+// scratch space of the simplification
+struct expression_pool_scratch {
+	uint32_t *operands; ///< Operands of the variadic operation that is being simplified.
+	uint32_t *sorted;	///< The same operands sorted by index.
+	uint8_t *flags;		///< Flags of the sorted operands.
+	size_t capacity;	///< Number of operands that each of the arrays can hold.
+};
+
+static int expression_pool_compare_(const void *node_1, const void *node_2) {
+	uint32_t value_1 = *(const uint32_t *)node_1;
+	uint32_t value_2 = *(const uint32_t *)node_2;
+	return (value_1 > value_2) - (value_1 < value_2);
+}
+
+// finds a node in a sorted array of nodes
+static size_t expression_pool_search_(const uint32_t *nodes, size_t length, uint32_t node) {
+	const uint32_t *found = bsearch(&node, nodes, length, sizeof(*nodes), expression_pool_compare_);
+	return found == NULL ? SIZE_MAX : (size_t)(found - nodes);
+}
+
+// checks whether every operand of `subset` is an operand of `superset`, both of which are
+// operations of the same type
+static bool expression_pool_operands_include_(
+	const struct expression_pool *pool,
+	uint32_t superset,
+	uint32_t subset
+) {
+	assert(pool != NULL && superset < pool->length && subset < pool->length);
+
+	const uint32_t *superset_operands = &pool->operands[pool->operands_starts[superset]];
+	const uint32_t *subset_operands = &pool->operands[pool->operands_starts[subset]];
+	for (size_t i = 0; i < pool->operands_counts[subset]; i++) {
+		bool included = false;
+		for (size_t j = 0; j < pool->operands_counts[superset] && !included; j++) {
+			included = superset_operands[j] == subset_operands[i];
+		}
+		if (!included) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static uint32_t expression_pool_rewrite_(
+	struct expression_pool *pool,
+	struct expression_pool_scratch *scratch,
+	enum operation_type type,
+	const uint32_t *operands,
+	size_t operands_count
+);
+
+// simplifies a conjunction or a disjunction whose operands are already simplified
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+static uint32_t expression_pool_rewrite_variadic_(
+	struct expression_pool *pool,
+	struct expression_pool_scratch *scratch,
+	enum operation_type type,
+	const uint32_t *operands,
+	size_t operands_count
+) {
+	assert(pool != NULL && scratch != NULL && operands != NULL);
+
+	enum operation_type dual_type = type == operation_type_conjunction
+										? operation_type_disjunction
+										: operation_type_conjunction;
+	// the value that absorbs the operation, false for conjunctions, true for disjunctions
+	bool absorbing = type == operation_type_disjunction;
+
+	// flattening, x * (y * z) = x * y * z, and constant folding
+	size_t length = 0;
+	for (size_t i = 0; i < operands_count; i++) {
+		const uint32_t *operand_operands = &operands[i];
+		size_t operand_operands_count = 1;
+		if (expression_pool_is_operation_(pool, operands[i], type)) {
+			operand_operands = &pool->operands[pool->operands_starts[operands[i]]];
+			operand_operands_count = pool->operands_counts[operands[i]];
+		}
+
+		if (length + operand_operands_count > scratch->capacity) {
+			size_t capacity = scratch->capacity;
+			while (length + operand_operands_count > capacity) {
+				capacity = capacity == 0 ? 64 : 2 * capacity;
+			}
+			bool failed = false;
+			EXPRESSION_POOL_REALLOCATE(scratch->operands, capacity, failed);
+			EXPRESSION_POOL_REALLOCATE(scratch->sorted, capacity, failed);
+			EXPRESSION_POOL_REALLOCATE(scratch->flags, capacity, failed);
+			if (failed) {
+				return EXPRESSION_POOL_NONE;
+			}
+			scratch->capacity = capacity;
+		}
+
+		for (size_t j = 0; j < operand_operands_count; j++) {
+			uint32_t operand = operand_operands[j];
+			if (pool->types[operand] == expression_type_constant) {
+				if (pool->values[operand] == absorbing) {
+					return expression_pool_add_constant(pool, absorbing);
+				}
+				// identity, x * 1 = x
+				continue;
+			}
+			scratch->operands[length++] = operand;
+		}
+	}
+
+	// idempotence, x * x = x, keeps the first occurrence of every operand
+	memcpy(scratch->sorted, scratch->operands, length * sizeof(*scratch->sorted));
+	qsort(scratch->sorted, length, sizeof(*scratch->sorted), expression_pool_compare_);
+	size_t unique_length = 0;
+	for (size_t i = 0; i < length; i++) {
+		if (unique_length == 0 || scratch->sorted[unique_length - 1] != scratch->sorted[i]) {
+			scratch->sorted[unique_length++] = scratch->sorted[i];
+		}
+	}
+	memset(scratch->flags, 0, unique_length);
+	size_t kept_length = 0;
+	for (size_t i = 0; i < length; i++) {
+		size_t position =
+			expression_pool_search_(scratch->sorted, unique_length, scratch->operands[i]);
+		if (!scratch->flags[position]) {
+			scratch->flags[position] = 1;
+			scratch->operands[kept_length++] = scratch->operands[i];
+		}
+	}
+	length = kept_length;
+
+	for (size_t i = 0; i < length; i++) {
+		uint32_t operand = scratch->operands[i];
+
+		// complementation, x * x' = 0
+		uint32_t complement = expression_pool_find_complement_(pool, operand);
+		if (complement != EXPRESSION_POOL_NONE &&
+			expression_pool_search_(scratch->sorted, unique_length, complement) != SIZE_MAX) {
+			return expression_pool_add_constant(pool, absorbing);
+		}
+	}
+
+	// absorption, x * (x + y) = x, the flags now mark the absorbed operands
+	memset(scratch->flags, 0, unique_length);
+	for (size_t i = 0; i < length; i++) {
+		uint32_t operand = scratch->operands[i];
+		if (!expression_pool_is_operation_(pool, operand, dual_type)) {
+			continue;
+		}
+
+		const uint32_t *operand_operands = &pool->operands[pool->operands_starts[operand]];
+		bool absorbed = false;
+		for (size_t j = 0; j < pool->operands_counts[operand] && !absorbed; j++) {
+			absorbed =
+				expression_pool_search_(scratch->sorted, unique_length, operand_operands[j]) !=
+				SIZE_MAX;
+		}
+		for (size_t j = 0; j < length && !absorbed; j++) {
+			uint32_t other = scratch->operands[j];
+			if (j == i || !expression_pool_is_operation_(pool, other, dual_type) ||
+				scratch->flags[expression_pool_search_(scratch->sorted, unique_length, other)]) {
+				continue;
+			}
+			// operations with the same operands in different orders only absorb the later one
+			absorbed = (pool->operands_counts[other] < pool->operands_counts[operand] || j < i) &&
+					   expression_pool_operands_include_(pool, operand, other);
+		}
+
+		if (absorbed) {
+			scratch->flags[expression_pool_search_(scratch->sorted, unique_length, operand)] = 1;
+		}
+	}
+	kept_length = 0;
+	for (size_t i = 0; i < length; i++) {
+		uint32_t operand = scratch->operands[i];
+		if (!scratch->flags[expression_pool_search_(scratch->sorted, unique_length, operand)]) {
+			scratch->operands[kept_length++] = operand;
+		}
+	}
+	length = kept_length;
+
+	if (length == 0) {
+		return expression_pool_add_constant(pool, !absorbing);
+	}
+	if (length == 1) {
+		return scratch->operands[0];
+	}
+
+	// de morgan, x' * y' = x ~| y
+	if (length == 2) {
+		uint32_t negated_operands[2] = {
+			expression_pool_negated_(pool, scratch->operands[0]),
+			expression_pool_negated_(pool, scratch->operands[1]),
+		};
+		if (negated_operands[0] != EXPRESSION_POOL_NONE &&
+			negated_operands[1] != EXPRESSION_POOL_NONE) {
+			return expression_pool_rewrite_(
+				pool,
+				scratch,
+				type == operation_type_conjunction ? operation_type_joint_denial
+												   : operation_type_alternative_denial,
+				negated_operands,
+				2
+			);
+		}
+	}
+
+	return expression_pool_add_operation(pool, type, scratch->operands, length);
+}
+
+// simplifies an operation whose operands are already simplified and returns the resulting node
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+static uint32_t expression_pool_rewrite_(
+	struct expression_pool *pool,
+	struct expression_pool_scratch *scratch,
+	enum operation_type type,
+	const uint32_t *operands,
+	size_t operands_count
+) {
+	assert(pool != NULL && scratch != NULL && operands != NULL);
+
+	if (operation_type_is_variadic(type)) {
+		return expression_pool_rewrite_variadic_(pool, scratch, type, operands, operands_count);
+	}
+
+	if (type == operation_type_negation) {
+		uint32_t operand = operands[0];
+		if (pool->types[operand] == expression_type_constant) {
+			return expression_pool_add_constant(pool, !pool->values[operand]);
+		}
+
+		// involution, x'' = x
+		uint32_t negated_operand = expression_pool_negated_(pool, operand);
+		if (negated_operand != EXPRESSION_POOL_NONE) {
+			return negated_operand;
+		}
+
+		// (x * y)' = x ~& y
+		if (pool->types[operand] == expression_type_operation &&
+			pool->operands_counts[operand] == 2) {
+			enum operation_type operand_type = (enum operation_type)pool->values[operand];
+			if (expression_pool_complement_type_(operand_type) != operand_type) {
+				uint32_t operand_operands[2];
+				memcpy(
+					operand_operands,
+					&pool->operands[pool->operands_starts[operand]],
+					sizeof(operand_operands)
+				);
+				return expression_pool_rewrite_(
+					pool,
+					scratch,
+					expression_pool_complement_type_(operand_type),
+					operand_operands,
+					2
+				);
+			}
+		}
+
+		return expression_pool_add_operation(pool, type, operands, 1);
+	}
+
+	uint32_t operand_1 = operands[0];
+	uint32_t operand_2 = operands[1];
+	bool constant_1 = pool->types[operand_1] == expression_type_constant;
+	bool constant_2 = pool->types[operand_2] == expression_type_constant;
+	bool complements = expression_pool_find_complement_(pool, operand_1) == operand_2;
+	uint32_t negated_operands[2] = {
+		expression_pool_negated_(pool, operand_1),
+		expression_pool_negated_(pool, operand_2),
+	};
+
+	switch (type) {
+		case operation_type_exclusive_disjunction:
+		case operation_type_biconditional: {
+			// the value that makes the operation an identity, false for exclusive disjunctions,
+			// true for biconditionals
+			bool identity = type == operation_type_biconditional;
+
+			if (constant_1 || constant_2) {
+				uint32_t constant = constant_1 ? operand_1 : operand_2;
+				uint32_t other = constant_1 ? operand_2 : operand_1;
+				if (pool->values[constant] == identity) {
+					return other;
+				}
+				return expression_pool_rewrite_(pool, scratch, operation_type_negation, &other, 1);
+			}
+
+			// x ^ x = 0, x ^ x' = 1
+			if (operand_1 == operand_2 || complements) {
+				return expression_pool_add_constant(pool, (operand_1 == operand_2) == identity);
+			}
+
+			// x' ^ y = x ~^ y
+			for (size_t i = 0; i < 2; i++) {
+				if (negated_operands[i] != EXPRESSION_POOL_NONE) {
+					uint32_t stripped_operands[2] = { operand_1, operand_2 };
+					stripped_operands[i] = negated_operands[i];
+					return expression_pool_rewrite_(
+						pool,
+						scratch,
+						expression_pool_complement_type_(type),
+						stripped_operands,
+						2
+					);
+				}
+			}
+		} break;
+		case operation_type_alternative_denial:
+		case operation_type_joint_denial: {
+			// the value that absorbs the operation, false for alternative denials, true for joint
+			// denials
+			bool absorbing = type == operation_type_joint_denial;
+
+			if (constant_1 || constant_2) {
+				uint32_t constant = constant_1 ? operand_1 : operand_2;
+				uint32_t other = constant_1 ? operand_2 : operand_1;
+				if (pool->values[constant] == absorbing) {
+					return expression_pool_add_constant(pool, !absorbing);
+				}
+				return expression_pool_rewrite_(pool, scratch, operation_type_negation, &other, 1);
+			}
+
+			// x ~& x = x'
+			if (operand_1 == operand_2) {
+				return expression_pool_rewrite_(
+					pool,
+					scratch,
+					operation_type_negation,
+					&operand_1,
+					1
+				);
+			}
+
+			// x ~& x' = 1
+			if (complements) {
+				return expression_pool_add_constant(pool, !absorbing);
+			}
+
+			// de morgan, x' ~& y' = x + y
+			if (negated_operands[0] != EXPRESSION_POOL_NONE &&
+				negated_operands[1] != EXPRESSION_POOL_NONE) {
+				return expression_pool_rewrite_(
+					pool,
+					scratch,
+					type == operation_type_alternative_denial ? operation_type_disjunction
+															  : operation_type_conjunction,
+					negated_operands,
+					2
+				);
+			}
+		} break;
+		case operation_type_implication: {
+			// 0 -> x = 1, 1 -> x = x
+			if (constant_1) {
+				if (pool->values[operand_1]) {
+					return operand_2;
+				}
+				return expression_pool_add_constant(pool, true);
+			}
+			// x -> 1 = 1, x -> 0 = x'
+			if (constant_2) {
+				if (pool->values[operand_2]) {
+					return operand_2;
+				}
+				return expression_pool_rewrite_(
+					pool,
+					scratch,
+					operation_type_negation,
+					&operand_1,
+					1
+				);
+			}
+
+			// x -> x = 1
+			if (operand_1 == operand_2) {
+				return expression_pool_add_constant(pool, true);
+			}
+
+			// x -> x' = x', x' -> x = x
+			if (complements) {
+				return operand_2;
+			}
+
+			// x' -> y = x + y
+			if (negated_operands[0] != EXPRESSION_POOL_NONE) {
+				uint32_t disjunction_operands[2] = { negated_operands[0], operand_2 };
+				return expression_pool_rewrite_(
+					pool,
+					scratch,
+					operation_type_disjunction,
+					disjunction_operands,
+					2
+				);
+			}
+		} break;
+		default: assert(false);
+	}
+
+	return expression_pool_add_operation(pool, type, operands, operands_count);
+}
+
+// rebuilds a pool out of the nodes that are reachable from `root`, which becomes its last node,
+// returns `false` if memory ran out, in which case the pool is left as it was
+static bool expression_pool_compact_(struct expression_pool *pool, uint32_t root) {
+	assert(pool != NULL && root < pool->length);
+
+	uint8_t *reachable = allocator_allocate_zeroed((size_t)root + 1, sizeof(*reachable));
+	if (reachable == NULL) {
+		return false;
+	}
+	reachable[root] = 1;
+	for (size_t i = root + 1; i > 0; i--) {
+		if (reachable[i - 1]) {
+			const uint32_t *operands = &pool->operands[pool->operands_starts[i - 1]];
+			for (size_t j = 0; j < pool->operands_counts[i - 1]; j++) {
+				reachable[operands[j]] = 1;
+			}
+		}
+	}
+
+	// the nodes of the compacted pool that the reachable nodes became
+	uint32_t *nodes = allocator_allocate(((size_t)root + 1) * sizeof(*nodes));
+	uint32_t *operands = allocator_allocate((pool->operands_length + 1) * sizeof(*operands));
+
+	struct expression_pool compacted = expression_pool_new();
+	bool compacted_all = nodes != NULL && operands != NULL;
+	for (size_t i = 0; i <= root && compacted_all; i++) {
+		if (!reachable[i]) {
+			continue;
+		}
+
+		size_t operands_count = pool->operands_counts[i];
+		for (size_t j = 0; j < operands_count; j++) {
+			operands[j] = nodes[pool->operands[pool->operands_starts[i] + j]];
+		}
+		nodes[i] = expression_pool_add_(
+			&compacted,
+			pool->types[i],
+			pool->values[i],
+			operands,
+			operands_count
+		);
+		compacted_all = nodes[i] != EXPRESSION_POOL_NONE;
+	}
+
+	allocator_free(reachable);
+	allocator_free(nodes);
+	allocator_free(operands);
+
+	if (!compacted_all) {
+		expression_pool_drop(&compacted);
+		return false;
+	}
+
+	expression_pool_drop(pool);
+	*pool = compacted;
+
+	return true;
+}
+
+void expression_pool_simplify(
+	struct expression_pool *pool,
+	const struct environment *environment
+) {
+	assert(pool != NULL && pool->length != 0);
+
+	// the nodes of the simplified pool that the nodes of the original pool became
+	uint32_t *nodes = allocator_allocate(pool->length * sizeof(*nodes));
+	uint32_t *operands = allocator_allocate((pool->operands_length + 1) * sizeof(*operands));
+
+	struct expression_pool_scratch scratch = {
+		.operands = NULL,
+		.sorted = NULL,
+		.flags = NULL,
+		.capacity = 0,
+	};
+
+	// the pool is only replaced once all of its nodes were simplified
+	struct expression_pool simplified = expression_pool_new();
+	bool simplified_all = nodes != NULL && operands != NULL;
+	for (size_t i = 0; i < pool->length && simplified_all; i++) {
+		switch (pool->types[i]) {
+			case expression_type_constant: {
+				nodes[i] = expression_pool_add_constant(&simplified, pool->values[i]);
+			} break;
+			case expression_type_variable: {
+				char name = (char)pool->values[i];
+				nodes[i] = environment != NULL
+							   ? expression_pool_add_constant(
+									 &simplified,
+									 environment_get_variable(environment, name)
+								 )
+							   : expression_pool_add_variable(&simplified, name);
+			} break;
+			case expression_type_operation: {
+				size_t operands_count = pool->operands_counts[i];
+				for (size_t j = 0; j < operands_count; j++) {
+					operands[j] = nodes[pool->operands[pool->operands_starts[i] + j]];
+				}
+				nodes[i] = expression_pool_rewrite_(
+					&simplified,
+					&scratch,
+					(enum operation_type)pool->values[i],
+					operands,
+					operands_count
+				);
+			} break;
+			default: assert(false);
+		}
+		simplified_all = nodes[i] != EXPRESSION_POOL_NONE;
+	}
+
+	uint32_t root = simplified_all ? nodes[expression_pool_root(pool)] : EXPRESSION_POOL_NONE;
+
+	allocator_free(nodes);
+	allocator_free(operands);
+	allocator_free(scratch.operands);
+	allocator_free(scratch.sorted);
+	allocator_free(scratch.flags);
+
+	if (!simplified_all || !expression_pool_compact_(&simplified, root)) {
+		expression_pool_drop(&simplified);
+		return;
+	}
+
+	expression_pool_drop(pool);
+	*pool = simplified;
+}
+
+// a growable string
+struct expression_pool_string {
+	char *data;
+	size_t length;
+	size_t capacity;
+	bool failed; ///< Whether memory ran out, after which nothing is appended.
+};
+
+static void expression_pool_string_append_(
+	struct expression_pool_string *string,
+	const char *text
+) {
+	assert(string != NULL && text != NULL);
+
+	if (string->failed) {
+		return;
+	}
+
+	size_t length = strlen(text);
+	if (string->length + length + 1 > string->capacity) {
+		size_t capacity = string->capacity;
+		while (string->length + length + 1 > capacity) {
+			capacity = capacity == 0 ? 64 : 2 * capacity;
+		}
+		EXPRESSION_POOL_REALLOCATE(string->data, capacity, string->failed);
+		if (string->failed) {
+			return;
+		}
+		string->capacity = capacity;
+	}
+	memcpy(&string->data[string->length], text, length + 1);
+	string->length += length;
+}
+
+// checks whether the `i`th operand of a node is printed in parentheses
+static bool expression_pool_parenthesized_(
+	const struct expression_pool *pool,
+	uint32_t node,
+	size_t i
+) {
+	assert(pool != NULL && node < pool->length && i < pool->operands_counts[node]);
+
+	uint32_t operand = pool->operands[pool->operands_starts[node] + i];
+	if (pool->types[operand] != expression_type_operation) {
+		return false;
+	}
+
+	enum operation_type type = (enum operation_type)pool->values[node];
+	enum operation_type operand_type = (enum operation_type)pool->values[operand];
+	size_t precedence = operation_type_precedence(type);
+	if (operation_type_precedence(operand_type) != precedence) {
+		return operation_type_precedence(operand_type) < precedence;
+	}
+
+	// implication is right associative and the rest are left associative, an alternative denial
+	// also has to be parenthesized before a juxtaposition
+	bool right_associative = type == operation_type_implication;
+	if (i == 0) {
+		return right_associative || (type == operation_type_conjunction &&
+									 operand_type == operation_type_alternative_denial);
+	}
+	return !right_associative;
+}
+
+char *expression_pool_to_string(const struct expression_pool *pool) {
+	assert(pool != NULL && pool->length != 0);
+
+	static const char *const separators[] = {
+		[operation_type_disjunction] = " + ",
+		[operation_type_exclusive_disjunction] = " ^ ",
+		[operation_type_biconditional] = " ~^ ",
+		[operation_type_alternative_denial] = " ~& ",
+		[operation_type_joint_denial] = " ~| ",
+		[operation_type_implication] = " -> ",
+	};
+
+	struct expression_pool_string string = {
+		.data = NULL,
+		.length = 0,
+		.capacity = 0,
+		.failed = false,
+	};
+	expression_pool_string_append_(&string, "");
+
+	struct {
+		uint32_t node;
+		uint32_t next;		///< Index of the next operand to be printed.
+		bool parenthesized; ///< Whether the node is printed in parentheses.
+	} *stack = NULL;
+	size_t stack_length = 0;
+	size_t stack_capacity = 0;
+
+#define push(node_, parenthesized_)                                                                \
+	do {                                                                                           \
+		if (stack_length == stack_capacity) {                                                      \
+			size_t capacity = stack_capacity == 0 ? 16 : 2 * stack_capacity;                       \
+			EXPRESSION_POOL_REALLOCATE(stack, capacity, string.failed);                            \
+			if (string.failed) {                                                                   \
+				break;                                                                             \
+			}                                                                                      \
+			stack_capacity = capacity;                                                             \
+		}                                                                                          \
+		stack[stack_length].node = (node_);                                                        \
+		stack[stack_length].next = 0;                                                              \
+		stack[stack_length].parenthesized = (parenthesized_);                                      \
+		stack_length++;                                                                            \
+		if (parenthesized_) {                                                                      \
+			expression_pool_string_append_(&string, "(");                                          \
+		}                                                                                          \
+	} while (0)
+
+	push(expression_pool_root(pool), false);
+	while (!string.failed && stack_length != 0) {
+		uint32_t node = stack[stack_length - 1].node;
+		uint32_t next = stack[stack_length - 1].next;
+		const uint32_t *operands = &pool->operands[pool->operands_starts[node]];
+
+		switch (pool->types[node]) {
+			case expression_type_constant: {
+				expression_pool_string_append_(&string, pool->values[node] ? "1" : "0");
+			} break;
+			case expression_type_variable: {
+				char name[2] = { (char)pool->values[node], '\0' };
+				expression_pool_string_append_(&string, name);
+			} break;
+			case expression_type_operation: {
+				enum operation_type type = (enum operation_type)pool->values[node];
+				if (next == pool->operands_counts[node]) {
+					if (type == operation_type_negation) {
+						expression_pool_string_append_(&string, "'");
+					}
+					break;
+				}
+
+				if (next != 0 && type != operation_type_conjunction) {
+					expression_pool_string_append_(&string, separators[type]);
+				} else if (next != 0 &&
+						   (pool->types[operands[next - 1]] == expression_type_constant ||
+							pool->types[operands[next]] == expression_type_constant)) {
+					expression_pool_string_append_(&string, " * ");
+				}
+
+				stack[stack_length - 1].next++;
+				push(operands[next], expression_pool_parenthesized_(pool, node, next));
+				continue;
+			}
+			default: assert(false);
+		}
+
+		stack_length--;
+		if (stack[stack_length].parenthesized) {
+			expression_pool_string_append_(&string, ")");
+		}
+	}
+
+#undef push
+
+	allocator_free(stack);
+
+	if (string.failed) {
+		allocator_free(string.data);
+		return NULL;
+	}
+
+	return string.data;
+}
@@ -0,0 +1,497 @@
+#include <factor.h>
+
+#include <allocator.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// covers are sets of cubes, a cube being an implicant whose literals are the set bits of its mask,
+// the literal `2 * bit + 1` being the variable of the bit and `2 * bit` its negation
+
+#define FACTOR_LITERALS_COUNT (2 * 64)
+
+static void factor_add_(struct implicants *cover, struct implicant cube) {
+	assert(cover != NULL);
+
+	bool added = implicants_add(cover, cube);
+	assert(added);
+	(void)added;
+}
+
+static struct implicant factor_literal_cube_(size_t literal) {
+	uint64_t bit = UINT64_C(1) << (literal / 2);
+	return (struct implicant){ .value = literal % 2 != 0 ? bit : 0, .mask = bit };
+}
+
+static bool factor_cube_has_literal_(struct implicant cube, size_t literal) {
+	uint64_t bit = UINT64_C(1) << (literal / 2);
+	return (cube.mask & bit) != 0 && ((cube.value & bit) != 0) == (literal % 2 != 0);
+}
+
+// checks whether every literal of `divisor` is one of `cube`
+static bool factor_cube_contains_(struct implicant cube, struct implicant divisor) {
+	return (divisor.mask & ~cube.mask) == 0 && ((cube.value ^ divisor.value) & divisor.mask) == 0;
+}
+
+static struct implicant factor_cube_divide_(struct implicant cube, struct implicant divisor) {
+	return (struct implicant){
+		.value = cube.value & ~divisor.mask,
+		.mask = cube.mask & ~divisor.mask,
+	};
+}
+
+static bool factor_cube_equals_(struct implicant cube_1, struct implicant cube_2) {
+	return cube_1.mask == cube_2.mask && cube_1.value == cube_2.value;
+}
+
+static size_t factor_cube_literals_count_(struct implicant cube) {
+	return (size_t)__builtin_popcountll(cube.mask);
+}
+
+static size_t factor_cover_literals_count_(const struct implicants *cover) {
+	assert(cover != NULL);
+
+	const struct implicant *cubes = implicants_const_elements(cover);
+	size_t literals_count = 0;
+	for (size_t i = 0; i < cover->length; i++) {
+		literals_count += factor_cube_literals_count_(cubes[i]);
+	}
+	return literals_count;
+}
+
+static bool factor_cover_contains_(const struct implicants *cover, struct implicant cube) {
+	assert(cover != NULL);
+
+	const struct implicant *cubes = implicants_const_elements(cover);
+	for (size_t i = 0; i < cover->length; i++) {
+		if (factor_cube_equals_(cubes[i], cube)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// the largest cube that is contained in every cube of a non-empty cover
+static struct implicant factor_common_cube_(const struct implicants *cover) {
+	assert(cover != NULL && cover->length != 0);
+
+	const struct implicant *cubes = implicants_const_elements(cover);
+	struct implicant common = cubes[0];
+	for (size_t i = 1; i < cover->length; i++) {
+		common.mask &= cubes[i].mask & ~(cubes[i].value ^ common.value);
+	}
+	common.value &= common.mask;
+
+	return common;
+}
+
+// counts the cubes every literal occurs in
+static void factor_count_literals_(const struct implicants *cover, size_t *counts) {
+	assert(cover != NULL && counts != NULL);
+
+	for (size_t i = 0; i < FACTOR_LITERALS_COUNT; i++) {
+		counts[i] = 0;
+	}
+	const struct implicant *cubes = implicants_const_elements(cover);
+	for (size_t i = 0; i < cover->length; i++) {
+		for (uint64_t mask = cubes[i].mask; mask != 0; mask &= mask - 1) {
+			size_t bit = (size_t)__builtin_ctzll(mask);
+			counts[2 * bit + ((cubes[i].value >> bit) & 1U)]++;
+		}
+	}
+}
+
+// divides every cube of a cover that contains `divisor` by it, the other cubes are moved to
+// `remainder` if it isn't `NULL`
+static struct implicants factor_divide_by_cube_(
+	const struct implicants *cover,
+	struct implicant divisor,
+	struct implicants *remainder
+) {
+	assert(cover != NULL);
+
+	const struct implicant *cubes = implicants_const_elements(cover);
+	struct implicants quotient = implicants_new();
+	for (size_t i = 0; i < cover->length; i++) {
+		if (factor_cube_contains_(cubes[i], divisor)) {
+			factor_add_(&quotient, factor_cube_divide_(cubes[i], divisor));
+		} else if (remainder != NULL) {
+			factor_add_(remainder, cubes[i]);
+		}
+	}
+	return quotient;
+}
+
+// divides a cover by another one algebraically, so that `cover = quotient * divisor + remainder`
+static struct implicants factor_divide_(
+	const struct implicants *cover,
+	const struct implicants *divisor,
+	struct implicants *remainder
+) {
+	assert(cover != NULL && divisor != NULL && divisor->length != 0);
+
+	const struct implicant *cubes = implicants_const_elements(cover);
+	const struct implicant *divisor_cubes = implicants_const_elements(divisor);
+
+	// the quotient is the intersection of the quotients by every cube of the divisor
+	struct implicants quotient = factor_divide_by_cube_(cover, divisor_cubes[0], NULL);
+	for (size_t i = 1; i < divisor->length && quotient.length != 0; i++) {
+		struct implicants partial = factor_divide_by_cube_(cover, divisor_cubes[i], NULL);
+
+		struct implicant *quotient_cubes = implicants_elements(&quotient);
+		size_t length = 0;
+		for (size_t j = 0; j < quotient.length; j++) {
+			if (factor_cover_contains_(&partial, quotient_cubes[j])) {
+				quotient_cubes[length++] = quotient_cubes[j];
+			}
+		}
+		quotient.length = length;
+
+		implicants_drop(&partial);
+	}
+
+	if (remainder != NULL) {
+		*remainder = implicants_new();
+		for (size_t i = 0; i < cover->length; i++) {
+			bool divided = false;
+			for (size_t j = 0; j < divisor->length && !divided; j++) {
+				if (factor_cube_contains_(cubes[i], divisor_cubes[j])) {
+					struct implicant cube = factor_cube_divide_(cubes[i], divisor_cubes[j]);
+					divided = factor_cover_contains_(&quotient, cube);
+				}
+			}
+			if (!divided) {
+				factor_add_(remainder, cubes[i]);
+			}
+		}
+	}
+
+	return quotient;
+}
+
+struct factor_kernels {
+	struct implicants *data;
+	size_t length;
+	size_t capacity;
+};
+
+// collects the kernels of a cube-free cover whose co-kernels only have literals from `first` on,
+// every kernel is a cube-free quotient of the cover by a cube
+static void factor_kernels_(
+	const struct implicants *cover,
+	size_t first,
+	struct factor_kernels *kernels
+) {
+	assert(cover != NULL && kernels != NULL);
+
+	size_t counts[FACTOR_LITERALS_COUNT];
+	factor_count_literals_(cover, counts);
+
+	for (size_t literal = first;
+		 literal < FACTOR_LITERALS_COUNT && kernels->length < FACTOR_KERNELS_LIMIT;
+		 literal++) {
+		if (counts[literal] < 2) {
+			continue;
+		}
+
+		struct implicants divided =
+			factor_divide_by_cube_(cover, factor_literal_cube_(literal), NULL);
+		struct implicant common = factor_common_cube_(&divided);
+
+		// the kernels of a co-kernel with an earlier literal were found from that literal already
+		bool visited = false;
+		for (size_t earlier = 0; earlier < literal && !visited; earlier++) {
+			visited = factor_cube_has_literal_(common, earlier);
+		}
+		if (!visited) {
+			struct implicants kernel = factor_divide_by_cube_(&divided, common, NULL);
+			factor_kernels_(&kernel, literal + 1, kernels);
+			implicants_drop(&kernel);
+		}
+
+		implicants_drop(&divided);
+	}
+
+	// if memory runs out the kernel is left out, which only makes the factoring worse
+	if (kernels->length < FACTOR_KERNELS_LIMIT) {
+		if (kernels->length == kernels->capacity) {
+			size_t capacity = kernels->capacity == 0 ? 16 : 2 * kernels->capacity;
+			struct implicants *data =
+				allocator_reallocate(kernels->data, capacity * sizeof(*kernels->data));
+			if (data == NULL) {
+				return;
+			}
+			kernels->data = data;
+			kernels->capacity = capacity;
+		}
+
+		struct implicants kernel = implicants_new();
+		if (!implicants_append(&kernel, implicants_const_elements(cover), cover->length)) {
+			implicants_drop(&kernel);
+			return;
+		}
+		kernels->data[kernels->length++] = kernel;
+	}
+}
+
+// finds the kernel of a cube-free cover that saves the most literals when the cover is divided by
+// it, returns `false` if dividing by any kernel saves nothing
+static bool factor_best_kernel_(const struct implicants *cover, struct implicants *best) {
+	assert(cover != NULL && best != NULL);
+
+	struct factor_kernels kernels = { .data = NULL, .length = 0, .capacity = 0 };
+	factor_kernels_(cover, 0, &kernels);
+
+	size_t best_saving = 0;
+	size_t best_index = kernels.length;
+	for (size_t i = 0; i < kernels.length; i++) {
+		const struct implicants *kernel = &kernels.data[i];
+		if (kernel->length < 2 || kernel->length == cover->length) {
+			continue;
+		}
+
+		struct implicants quotient = factor_divide_(cover, kernel, NULL);
+
+		// `quotient * kernel` takes the literals of the quotient and the kernel once instead of
+		// repeating them for every product of their cubes
+		if (quotient.length != 0) {
+			size_t quotient_literals = factor_cover_literals_count_(&quotient);
+			size_t kernel_literals = factor_cover_literals_count_(kernel);
+			size_t saving = kernel->length * quotient_literals +
+				quotient.length * kernel_literals - quotient_literals - kernel_literals;
+			if (saving > best_saving) {
+				best_saving = saving;
+				best_index = i;
+			}
+		}
+
+		implicants_drop(&quotient);
+	}
+
+	for (size_t i = 0; i < kernels.length; i++) {
+		if (i == best_index) {
+			*best = kernels.data[i];
+		} else {
+			implicants_drop(&kernels.data[i]);
+		}
+	}
+	allocator_free(kernels.data);
+
+	return best_index != kernels.length;
+}
+
+// adds an operation to the pool, merging the operands that are operations of the same type
+static uint32_t factor_operation_(
+	struct expression_pool *pool,
+	enum operation_type type,
+	uint32_t operand_1,
+	uint32_t operand_2
+) {
+	assert(pool != NULL);
+
+	if (operand_1 == EXPRESSION_POOL_NONE || operand_2 == EXPRESSION_POOL_NONE) {
+		return EXPRESSION_POOL_NONE;
+	}
+
+	uint32_t operands[2] = { operand_1, operand_2 };
+
+	size_t length = 0;
+	for (size_t i = 0; i < 2; i++) {
+		bool merged = pool->types[operands[i]] == expression_type_operation &&
+			pool->values[operands[i]] == type;
+		length += merged ? pool->operands_counts[operands[i]] : 1;
+	}
+
+	uint32_t *merged_operands = allocator_allocate(length * sizeof(*merged_operands));
+	if (merged_operands == NULL) {
+		return EXPRESSION_POOL_NONE;
+	}
+
+	length = 0;
+	for (size_t i = 0; i < 2; i++) {
+		if (pool->types[operands[i]] == expression_type_operation &&
+			pool->values[operands[i]] == type) {
+			for (size_t j = 0; j < pool->operands_counts[operands[i]]; j++) {
+				merged_operands[length++] = pool->operands[pool->operands_starts[operands[i]] + j];
+			}
+		} else {
+			merged_operands[length++] = operands[i];
+		}
+	}
+
+	uint32_t node = expression_pool_add_operation(pool, type, merged_operands, length);
+
+	allocator_free(merged_operands);
+
+	return node;
+}
+
+// adds the product of the literals of a cube to the pool
+static uint32_t factor_cube_(
+	struct expression_pool *pool,
+	struct implicant cube,
+	const struct variables *variables
+) {
+	assert(pool != NULL && variables != NULL);
+
+	// `EXPRESSION_POOL_NONE` means that memory ran out, so whether a literal was added is tracked
+	// separately
+	uint32_t node = EXPRESSION_POOL_NONE;
+	bool empty = true;
+	for (size_t i = 0; i < variables->length; i++) {
+		uint64_t bit = UINT64_C(1) << (variables->length - i - 1);
+		if ((cube.mask & bit) == 0) {
+			continue;
+		}
+
+		char name = variables_const_elements(variables)[i];
+		uint32_t literal = expression_pool_add_variable(pool, name);
+		if ((cube.value & bit) == 0) {
+			literal = expression_pool_add_operation(pool, operation_type_negation, &literal, 1);
+		}
+		node = empty ? literal : factor_operation_(pool, operation_type_conjunction, node, literal);
+		empty = false;
+	}
+
+	return empty ? expression_pool_add_constant(pool, true) : node;
+}
+
+static uint32_t factor_cover_(
+	struct expression_pool *pool,
+	const struct implicants *cover,
+	const struct variables *variables
+);
+
+// adds `quotient * divisor + remainder` to the pool, factoring each of them
+static uint32_t factor_division_(
+	struct expression_pool *pool,
+	const struct implicants *quotient,
+	const struct implicants *divisor,
+	const struct implicants *remainder,
+	const struct variables *variables
+) {
+	assert(pool != NULL && quotient != NULL && divisor != NULL && remainder != NULL);
+
+	uint32_t node = factor_operation_(
+		pool,
+		operation_type_conjunction,
+		factor_cover_(pool, quotient, variables),
+		factor_cover_(pool, divisor, variables)
+	);
+	if (remainder->length != 0) {
+		node = factor_operation_(
+			pool,
+			operation_type_disjunction,
+			node,
+			factor_cover_(pool, remainder, variables)
+		);
+	}
+
+	return node;
+}
+
+// adds the factored form of a cover to the pool
+static uint32_t factor_cover_(
+	struct expression_pool *pool,
+	const struct implicants *cover,
+	const struct variables *variables
+) {
+	assert(pool != NULL && cover != NULL && variables != NULL);
+
+	if (cover->length == 0) {
+		return expression_pool_add_constant(pool, false);
+	}
+	const struct implicant *cubes = implicants_const_elements(cover);
+	for (size_t i = 0; i < cover->length; i++) {
+		if (cubes[i].mask == 0) {
+			return expression_pool_add_constant(pool, true);
+		}
+	}
+	if (cover->length == 1) {
+		return factor_cube_(pool, cubes[0], variables);
+	}
+
+	struct implicant common = factor_common_cube_(cover);
+	if (common.mask != 0) {
+		struct implicants quotient = factor_divide_by_cube_(cover, common, NULL);
+		uint32_t node = factor_operation_(
+			pool,
+			operation_type_conjunction,
+			factor_cube_(pool, common, variables),
+			factor_cover_(pool, &quotient, variables)
+		);
+		implicants_drop(&quotient);
+		return node;
+	}
+
+	struct implicants kernel;
+	if (factor_best_kernel_(cover, &kernel)) {
+		struct implicants remainder;
+		struct implicants quotient = factor_divide_(cover, &kernel, &remainder);
+		uint32_t node = factor_division_(pool, &quotient, &kernel, &remainder, variables);
+		implicants_drop(&quotient);
+		implicants_drop(&remainder);
+		implicants_drop(&kernel);
+		return node;
+	}
+
+	// without a kernel worth dividing by, the most frequent literal is factored out
+	size_t counts[FACTOR_LITERALS_COUNT];
+	factor_count_literals_(cover, counts);
+	size_t literal = 0;
+	for (size_t i = 1; i < FACTOR_LITERALS_COUNT; i++) {
+		if (counts[i] > counts[literal]) {
+			literal = i;
+		}
+	}
+
+	if (counts[literal] < 2) {
+		uint32_t node = factor_cube_(pool, cubes[0], variables);
+		for (size_t i = 1; i < cover->length; i++) {
+			node = factor_operation_(
+				pool,
+				operation_type_disjunction,
+				node,
+				factor_cube_(pool, cubes[i], variables)
+			);
+		}
+		return node;
+	}
+
+	struct implicants divisor = implicants_new();
+	factor_add_(&divisor, factor_literal_cube_(literal));
+	struct implicants remainder = implicants_new();
+	struct implicants quotient =
+		factor_divide_by_cube_(cover, factor_literal_cube_(literal), &remainder);
+	uint32_t node = factor_division_(pool, &quotient, &divisor, &remainder, variables);
+	implicants_drop(&quotient);
+	implicants_drop(&remainder);
+	implicants_drop(&divisor);
+
+	return node;
+}
+
+uint32_t implicants_factor(
+	const struct implicants *implicants,
+	const struct variables *variables,
+	struct expression_pool *pool
+) {
+	assert(implicants != NULL && variables != NULL && pool != NULL);
+
+	// the literals of a cube are only those of its mask
+	struct implicants cover = implicants_new();
+	const struct implicant *elements = implicants_const_elements(implicants);
+	for (size_t i = 0; i < implicants->length; i++) {
+		struct implicant cube = elements[i];
+		cube.value &= cube.mask;
+		if (!factor_cover_contains_(&cover, cube)) {
+			factor_add_(&cover, cube);
+		}
+	}
+
+	uint32_t node = factor_cover_(pool, &cover, variables);
+
+	implicants_drop(&cover);
+
+	return node;
+}
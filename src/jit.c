@@ -0,0 +1,291 @@
+#include <jit.h>
+
+#include <assert.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+
+// the largest number of bytes the code of a node takes, plus the bytes per operand
+#define JIT_NODE_SIZE (32)
+#define JIT_OPERAND_SIZE (8)
+
+// opcodes of `op rax, r/m64`, and of `mov r/m64, rax`
+#define JIT_LOAD (0x8B)
+#define JIT_AND (0x23)
+#define JIT_OR (0x0B)
+#define JIT_XOR (0x33)
+#define JIT_STORE (0x89)
+
+struct jit_assembler {
+	const struct expression_pool *pool;
+	bool parallel;		 // whether the code evaluates 64 environments or a packed one
+	uint8_t *code;		 // the generated code
+	size_t length;		 // length of the code
+	uint32_t accumulated; // the node whose value is in `rax`, `EXPRESSION_POOL_NONE` if none is
+};
+
+static void jit_emit(struct jit_assembler *assembler, const uint8_t *bytes, size_t count) {
+	assert(assembler != NULL && bytes != NULL);
+
+	memcpy(&assembler->code[assembler->length], bytes, count);
+	assembler->length += count;
+}
+
+static void jit_emit_32(struct jit_assembler *assembler, uint32_t value) {
+	assert(assembler != NULL);
+
+	uint8_t bytes[] = {
+		(uint8_t)value,
+		(uint8_t)(value >> 8),
+		(uint8_t)(value >> 16),
+		(uint8_t)(value >> 24),
+	};
+	jit_emit(assembler, bytes, sizeof(bytes));
+}
+
+// emits `op rax, [value of node]` or `mov [value of node], rax`, the values of the operations are
+// on the stack and in parallel code the values of the variables are read straight from the words
+// pointed to by `rdi`
+static void jit_emit_node(struct jit_assembler *assembler, uint8_t opcode, uint32_t node) {
+	assert(assembler != NULL);
+
+	const struct expression_pool *pool = assembler->pool;
+	if (assembler->parallel && pool->types[node] == expression_type_variable) {
+		uint8_t bytes[] = { 0x48, opcode, 0x87 };
+		jit_emit(assembler, bytes, sizeof(bytes));
+		size_t index = environment_variable_index((char)pool->values[node]);
+		jit_emit_32(assembler, (uint32_t)(index * sizeof(uint64_t)));
+	} else {
+		uint8_t bytes[] = { 0x48, opcode, 0x84, 0x24 };
+		jit_emit(assembler, bytes, sizeof(bytes));
+		jit_emit_32(assembler, node * (uint32_t)sizeof(uint64_t));
+	}
+}
+
+static void jit_emit_not(struct jit_assembler *assembler) {
+	static const uint8_t bytes[] = { 0x48, 0xF7, 0xD0 };
+	jit_emit(assembler, bytes, sizeof(bytes));
+}
+
+// emits the code that leaves the value of a node in `rax`
+static void jit_emit_value(struct jit_assembler *assembler, uint32_t node) {
+	assert(assembler != NULL);
+
+	const struct expression_pool *pool = assembler->pool;
+	switch (pool->types[node]) {
+		case expression_type_constant: {
+			static const uint8_t ones[] = { 0x48, 0xC7, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF };
+			static const uint8_t zeros[] = { 0x31, 0xC0 };
+			if (pool->values[node] != 0) {
+				jit_emit(assembler, ones, sizeof(ones));
+			} else {
+				jit_emit(assembler, zeros, sizeof(zeros));
+			}
+		} break;
+		case expression_type_variable: {
+			if (assembler->parallel) {
+				jit_emit_node(assembler, JIT_LOAD, node);
+				break;
+			}
+
+			// the bit of the variable is spread over the whole word
+			size_t index = environment_variable_index((char)pool->values[node]);
+			uint8_t bytes[] = {
+				0x48, 0x89, 0xF8,				 // mov rax, rdi
+				0x48, 0xC1, 0xE8, (uint8_t)index, // shr rax, index
+				0x83, 0xE0, 0x01,				 // and eax, 1
+				0x48, 0xF7, 0xD8,				 // neg rax
+			};
+			jit_emit(assembler, bytes, sizeof(bytes));
+		} break;
+		case expression_type_operation: {
+			const uint32_t *operands = &pool->operands[pool->operands_starts[node]];
+			size_t operands_count = pool->operands_counts[node];
+
+			if (assembler->accumulated != operands[0]) {
+				jit_emit_node(assembler, JIT_LOAD, operands[0]);
+			}
+			switch ((enum operation_type)pool->values[node]) {
+				case operation_type_conjunction: {
+					for (size_t i = 1; i < operands_count; i++) {
+						jit_emit_node(assembler, JIT_AND, operands[i]);
+					}
+				} break;
+				case operation_type_disjunction: {
+					for (size_t i = 1; i < operands_count; i++) {
+						jit_emit_node(assembler, JIT_OR, operands[i]);
+					}
+				} break;
+				case operation_type_negation: jit_emit_not(assembler); break;
+				case operation_type_exclusive_disjunction: {
+					jit_emit_node(assembler, JIT_XOR, operands[1]);
+				} break;
+				case operation_type_biconditional: {
+					jit_emit_node(assembler, JIT_XOR, operands[1]);
+					jit_emit_not(assembler);
+				} break;
+				case operation_type_alternative_denial: {
+					jit_emit_node(assembler, JIT_AND, operands[1]);
+					jit_emit_not(assembler);
+				} break;
+				case operation_type_joint_denial: {
+					jit_emit_node(assembler, JIT_OR, operands[1]);
+					jit_emit_not(assembler);
+				} break;
+				case operation_type_implication: {
+					jit_emit_not(assembler);
+					jit_emit_node(assembler, JIT_OR, operands[1]);
+				} break;
+				default: assert(false);
+			}
+		} break;
+		default: assert(false);
+	}
+
+	assembler->accumulated = node;
+}
+
+// emits a function that evaluates the pool, every node's value is kept on the stack except for the
+// root's, which is returned in `rax`
+static void jit_emit_function(struct jit_assembler *assembler) {
+	assert(assembler != NULL);
+
+	const struct expression_pool *pool = assembler->pool;
+	uint32_t frame_size = (uint32_t)(pool->length * sizeof(uint64_t));
+
+	static const uint8_t prologue[] = { 0x48, 0x81, 0xEC }; // sub rsp, frame_size
+	jit_emit(assembler, prologue, sizeof(prologue));
+	jit_emit_32(assembler, frame_size);
+
+	assembler->accumulated = EXPRESSION_POOL_NONE;
+	uint32_t root = expression_pool_root(pool);
+	for (uint32_t i = 0; i < pool->length; i++) {
+		// variables of parallel code are read from their words where they are used
+		if (assembler->parallel && pool->types[i] == expression_type_variable && i != root) {
+			continue;
+		}
+
+		jit_emit_value(assembler, i);
+		if (i != root) {
+			jit_emit_node(assembler, JIT_STORE, i);
+		}
+	}
+
+	static const uint8_t epilogue[] = { 0x48, 0x81, 0xC4 }; // add rsp, frame_size
+	jit_emit(assembler, epilogue, sizeof(epilogue));
+	jit_emit_32(assembler, frame_size);
+	static const uint8_t ret[] = { 0xC3 };
+	jit_emit(assembler, ret, sizeof(ret));
+}
+
+// generates the code of both functions in a new mapping, returns `false` if it can't be made
+static bool jit_generate(struct jit *jit) {
+	assert(jit != NULL);
+
+	const struct expression_pool *pool = &jit->pool;
+	if (pool->length > JIT_NODES_LIMIT) {
+		return false;
+	}
+
+	long page_size = sysconf(_SC_PAGESIZE);
+	size_t function_size =
+		16 + pool->length * JIT_NODE_SIZE + pool->operands_length * JIT_OPERAND_SIZE;
+	size_t size = 2 * function_size;
+	if (page_size > 0) {
+		size = (size + (size_t)page_size - 1) / (size_t)page_size * (size_t)page_size;
+	}
+
+	void *code = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (code == MAP_FAILED) {
+		return false;
+	}
+
+	struct jit_assembler assembler = {
+		.pool = pool,
+		.parallel = true,
+		.code = code,
+		.length = 0,
+		.accumulated = EXPRESSION_POOL_NONE,
+	};
+	jit_emit_function(&assembler);
+	assert(assembler.length <= function_size);
+
+	size_t single_start = assembler.length;
+	assembler.parallel = false;
+	jit_emit_function(&assembler);
+	assert(assembler.length <= size);
+
+	if (mprotect(code, size, PROT_READ | PROT_EXEC) != 0) {
+		(void)munmap(code, size);
+		return false;
+	}
+
+	// ISO C has no conversion between object and function pointers, their representations are
+	// copied instead
+	void *single = (uint8_t *)code + single_start;
+	memcpy(&jit->parallel, &code, sizeof(jit->parallel));
+	memcpy(&jit->single, &single, sizeof(jit->single));
+	jit->code = code;
+	jit->code_size = size;
+
+	return true;
+}
+
+#else
+
+static bool jit_generate(struct jit *jit) {
+	(void)jit;
+	return false;
+}
+
+#endif
+
+struct jit jit_compile(const struct expression *expression) {
+	assert(expression != NULL);
+
+	struct jit jit = {
+		.pool = expression_pool_from_expression(expression),
+		.code = NULL,
+		.code_size = 0,
+		.parallel = NULL,
+		.single = NULL,
+	};
+
+	// the pool is interpreted if the code can't be generated, and is empty if memory ran out
+	if (jit.pool.length != 0) {
+		(void)jit_generate(&jit);
+	}
+
+	return jit;
+}
+
+void jit_drop(struct jit *jit) {
+	assert(jit != NULL);
+
+	if (jit->code != NULL) {
+		(void)munmap(jit->code, jit->code_size);
+	}
+	expression_pool_drop(&jit->pool);
+}
+
+bool jit_evaluate(const struct jit *jit, const struct environment *environment) {
+	assert(jit != NULL && environment != NULL);
+
+	if (jit->single != NULL) {
+		return (jit->single(environment->variables) & 1U) != 0;
+	}
+
+	return expression_pool_evaluate(&jit->pool, environment);
+}
+
+uint64_t jit_evaluate_parallel(const struct jit *jit, const uint64_t *variables) {
+	assert(jit != NULL && variables != NULL);
+
+	if (jit->parallel != NULL) {
+		return jit->parallel(variables);
+	}
+
+	return expression_pool_evaluate_parallel(&jit->pool, variables);
+}
@@ -1,28 +1,101 @@
+#include <budget.h>
+#include <ctype.h>
+#include <errno.h>
 #include <expression.h>
+#include <expression_pool.h>
+#include <factor.h>
 #include <inttypes.h>
+#include <pla.h>
+#include <server.h>
+#include <simulation.h>
+#include <stats.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <store.h>
 #include <string.h>
+#include <timing.h>
+#include <trace.h>
+#include <unistd.h>
 
-#define MAXIMUM_INPUT_LENGTH (1023)
+// parses the argument of an option that is a number of bytes or implicants
+static bool parse_size(const char *string, size_t *size) {
+	assert(string != NULL && size != NULL);
 
-int main(void) {
-	char input[MAXIMUM_INPUT_LENGTH + 1];
-	assert(fgets(input, sizeof(input), stdin) != NULL);
-	input[strcspn(input, "\n")] = '\0';
+	char *end = NULL;
+	errno = 0;
+	unsigned long long value = strtoull(string, &end, 10);
+	if (errno != 0 || end == string || *end != '\0' || string[0] == '-' || value > SIZE_MAX) {
+		(void)fprintf(stderr, "Error: \"%s\" is not a valid count\n", string);
+		return false;
+	}
+
+	*size = (size_t)value;
+	return true;
+}
+// parses the argument of an option that is a number of seconds
+static bool parse_seconds(const char *string, double *seconds) {
+	assert(string != NULL && seconds != NULL);
+
+	char *end = NULL;
+	errno = 0;
+	double value = strtod(string, &end);
+	if (errno != 0 || end == string || *end != '\0' || !(value >= 0.0)) {
+		(void)fprintf(stderr, "Error: \"%s\" is not a valid number of seconds\n", string);
+		return false;
+	}
+
+	*seconds = value;
+	return true;
+}
 
-	struct expression expression = expression_from_string(input);
-	expression_print(&expression);
-	printf("\n");
+// minimizes the function of a single line of the input and prints the results, the function is
+// either an expression or its minterms given directly, see `minterms_from_string()`, and the result
+// is either a sum of products or its factored form
+static void minimize(
+	const char *input,
+	struct store *store,
+	const char *store_path,
+	struct budget budget,
+	bool factor
+) {
+	assert(input != NULL && store != NULL);
+
+	uint64_t failures = allocator_usage.failures;
+
+	struct minterms minterms;
+	enum minterms_status parsed = minterms_from_string(input, &minterms);
+	if (parsed == minterms_status_invalid) {
+		return;
+	}
+
+	budget_begin(budget);
+
+	if (parsed == minterms_status_absent) {
+		struct expression expression = expression_from_string(input);
+		expression_print(&expression);
+		printf("\n");
+
+		minterms = minterms_from_expression(&expression);
+		expression_drop(&expression);
+	}
 
-	struct minterms minterms = minterms_from_expression(&expression);
-	expression_drop(&expression);
+	// without the whole on-set there's nothing to minimize
+	if (budget_exceeded(0)) {
+		(void)fprintf(
+			stderr,
+			"Error: exceeded the %s budget while enumerating minterms\n",
+			budget_status_name(budget_end())
+		);
+		minterms_drop(&minterms);
+		return;
+	}
 
 	printf("f(");
 	for (size_t i = 0; i < minterms.variables.length; i++) {
 		if (i != 0) {
 			printf(", ");
 		}
-		printf("%c", minterms.variables.data[i]);
+		printf("%c", variables_const_elements(&minterms.variables)[i]);
 	}
 	printf(")");
 
@@ -35,16 +108,409 @@ int main(void) {
 	}
 	printf(") = ");
 
-	struct implicants prime_implicants = minterms_to_prime_implicants(&minterms);
-	implicants_minimalize(&prime_implicants, &minterms);
+	// implicants found in the store are borrowed from its mapping and mustn't be dropped
+	struct implicants prime_implicants;
+	bool stored = store_path != NULL && store_lookup(store, &minterms, &prime_implicants);
+	if (!stored) {
+		prime_implicants = minterms_to_prime_implicants(&minterms);
+		implicants_minimalize(&prime_implicants, &minterms);
+	}
+
+	enum budget_status status = budget_end();
+
+	// results that fell back to a cheaper cover aren't minimal, so they aren't stored
+	if (!stored && status == budget_status_within && store_path != NULL &&
+		!store_insert(store, &minterms, &prime_implicants)) {
+		(void)fprintf(stderr, "Warning: failed to insert result into store \"%s\"\n", store_path);
+	}
+
+	struct stats_span span = stats_begin(stats_stage_output);
+
+	if (factor) {
+		struct expression_pool pool = expression_pool_new();
+		uint32_t root = implicants_factor(&prime_implicants, &minterms.variables, &pool);
+		assert(root == EXPRESSION_POOL_NONE || root == expression_pool_root(&pool));
+
+		char *string = root != EXPRESSION_POOL_NONE ? expression_pool_to_string(&pool) : NULL;
+		if (string != NULL) {
+			printf("%s\n", string);
+		} else {
+			(void)fprintf(stderr, "Error: ran out of memory while factoring expression\n");
+		}
+
+		allocator_free(string);
+		expression_pool_drop(&pool);
+	} else {
+		struct expression minimal_expression =
+			implicants_to_expression(&prime_implicants, &minterms.variables);
+
+		expression_print(&minimal_expression);
+		printf("\n");
+
+		expression_drop(&minimal_expression);
+	}
 
-	struct expression minimal_expression =
-		implicants_to_expression(&prime_implicants, &minterms.variables);
 	minterms_drop(&minterms);
-	implicants_drop(&prime_implicants);
+	if (!stored) {
+		implicants_drop(&prime_implicants);
+	}
 
-	expression_print(&minimal_expression);
-	printf("\n");
+	stats_end(span);
 
-	expression_drop(&minimal_expression);
+	if (status != budget_status_within) {
+		(void)fprintf(
+			stderr,
+			"Warning: exceeded the %s budget, the result is not minimal\n",
+			budget_status_name(status)
+		);
+	} else if (allocator_usage.failures != failures) {
+		(void)fprintf(stderr, "Warning: ran out of memory, the result is incomplete\n");
+	}
+}
+
+// minimizes every output of a PLA read from `input` and writes them as a PLA to `output`, each
+// output gets its own budget
+static bool minimize_pla(FILE *input, FILE *output, struct budget budget) {
+	assert(input != NULL && output != NULL);
+
+	// cubes are read and written line by line, so larger buffers save system calls
+	(void)setvbuf(input, NULL, _IOFBF, (size_t)1 << 20);
+	(void)setvbuf(output, NULL, _IOFBF, (size_t)1 << 20);
+
+	struct pla_reader reader;
+	if (!pla_reader_open(&reader, input)) {
+		return false;
+	}
+
+	struct minterms *minterms = allocator_allocate(reader.outputs_count * sizeof(*minterms));
+	if (minterms == NULL || !pla_reader_read_minterms(&reader, minterms)) {
+		allocator_free(minterms);
+		pla_reader_close(&reader);
+		return false;
+	}
+
+	struct pla_writer writer;
+	bool written = pla_writer_open(
+		&writer,
+		output,
+		&reader.variables,
+		reader.outputs_count,
+		reader.output_names
+	);
+	for (size_t i = 0; i < reader.outputs_count; i++) {
+		budget_begin(budget);
+
+		struct implicants prime_implicants = minterms_to_prime_implicants(&minterms[i]);
+		implicants_minimalize(&prime_implicants, &minterms[i]);
+
+		enum budget_status status = budget_end();
+		if (status != budget_status_within) {
+			(void)fprintf(
+				stderr,
+				"Warning: exceeded the %s budget, output %zu is not minimal\n",
+				budget_status_name(status),
+				i
+			);
+		}
+
+		if (written) {
+			const struct implicant *elements = implicants_const_elements(&prime_implicants);
+			for (size_t j = 0; j < prime_implicants.length; j++) {
+				pla_writer_write(&writer, elements[j], i);
+			}
+		}
+
+		implicants_drop(&prime_implicants);
+		minterms_drop(&minterms[i]);
+	}
+	allocator_free(minterms);
+	pla_reader_close(&reader);
+
+	if (!pla_writer_close(&writer) || !written) {
+		(void)fprintf(stderr, "Error: failed to write PLA\n");
+		return false;
+	}
+
+	return true;
+}
+
+// simulates the timing of the expressions of the lines of the file at `path`, their inputs change
+// according to the events read from `input`, a line `<tick> <variable> <0 or 1>` per event in
+// order of time, and the waveform and settle time of every output are written to `output`
+static bool simulate_timing(const char *path, FILE *input, FILE *output) {
+	assert(path != NULL && input != NULL && output != NULL);
+
+	FILE *file = fopen(path, "r");
+	if (file == NULL) {
+		(void)fprintf(stderr, "Error: failed to open \"%s\": %s\n", path, strerror(errno));
+		return false;
+	}
+
+	// like an invalid event, an expression that can't be parsed or stored stops the simulation
+	struct expression *expressions = NULL;
+	size_t expressions_count = 0;
+	char *line = NULL;
+	size_t line_capacity = 0;
+	bool parsed = true;
+	for (size_t line_number = 1; parsed && getline(&line, &line_capacity, file) != -1;
+		 line_number++) {
+		line[strcspn(line, "\n")] = '\0';
+		if (line[strspn(line, " \t\r")] == '\0') {
+			continue;
+		}
+
+		struct expression *grown =
+			allocator_reallocate(expressions, (expressions_count + 1) * sizeof(*expressions));
+		if (grown == NULL) {
+			(void)fprintf(stderr, "Error: line %zu of netlist: out of memory\n", line_number);
+			parsed = false;
+		} else {
+			expressions = grown;
+			parsed = expression_from_string_strict(line, &expressions[expressions_count]);
+			if (parsed) {
+				expressions_count++;
+			} else {
+				(void
+				)fprintf(stderr, "Error: line %zu of netlist: invalid expression\n", line_number);
+			}
+		}
+	}
+	(void)fclose(file);
+
+	if (!parsed) {
+		for (size_t i = 0; i < expressions_count; i++) {
+			expression_drop(&expressions[i]);
+		}
+		allocator_free(expressions);
+		free(line);
+		return false;
+	}
+
+	struct timing_netlist netlist = timing_netlist_new(expressions, expressions_count, NULL);
+	for (size_t i = 0; i < expressions_count; i++) {
+		expression_drop(&expressions[i]);
+	}
+	allocator_free(expressions);
+
+	struct timing_simulator simulator = timing_simulator_new(&netlist);
+
+	bool simulated = true;
+	for (size_t line_number = 1; simulated && getline(&line, &line_capacity, input) != -1;
+		 line_number++) {
+		if (line[strspn(line, " \t\r\n")] == '\0') {
+			continue;
+		}
+
+		char *end = NULL;
+		errno = 0;
+		unsigned long long time = strtoull(line, &end, 10);
+		char name = '\0';
+		char value = '\0';
+		char rest = '\0';
+		if (errno != 0 || end == line || line[0] == '-' ||
+			sscanf(end, " %c %c %c", &name, &value, &rest) != 2 ||
+			!isalpha((unsigned char)name) || (value != '0' && value != '1')) {
+			(void)fprintf(stderr, "Error: line %zu of events: invalid event\n", line_number);
+			simulated = false;
+		} else if (time < simulator.time) {
+			(void)fprintf(stderr, "Error: line %zu of events: event out of order\n", line_number);
+			simulated = false;
+		} else if (netlist.inputs[environment_variable_index(name)] == EXPRESSION_POOL_NONE) {
+			(void)fprintf(
+				stderr,
+				"Error: line %zu of events: no gate of the netlist reads %c\n",
+				line_number,
+				name
+			);
+			simulated = false;
+		} else {
+			timing_simulator_set(&simulator, time, name, value == '1');
+		}
+	}
+	// the line is allocated by `getline()`
+	free(line);
+
+	uint64_t settle_time = timing_simulator_settle(&simulator);
+	for (size_t i = 0; i < netlist.outputs_count; i++) {
+		const struct timing_changes *waveform = &simulator.waveforms[i];
+		const struct timing_change *changes = timing_changes_const_elements(waveform);
+
+		(void)fprintf(output, "%zu:", i);
+		for (size_t j = 0; j < waveform->length; j++) {
+			(void)fprintf(output, " %d@%" PRIu64, changes[j].value, changes[j].time);
+		}
+		(void)fprintf(
+			output,
+			" (settles at %" PRIu64 ")\n",
+			changes[waveform->length - 1].time
+		);
+	}
+	(void)fprintf(
+		output,
+		"settled at %" PRIu64 " after %" PRIu64 " events\n",
+		settle_time,
+		simulator.events_count
+	);
+
+	timing_simulator_drop(&simulator);
+	timing_netlist_drop(&netlist);
+
+	return simulated;
+}
+
+int main(int argc, char *argv[]) {
+	const char *store_path = NULL;
+	const char *trace_path = NULL;
+	bool print_stats = false;
+	bool pla = false;
+	bool factor = false;
+	const char *simulated = NULL;
+	const char *timed = NULL;
+	const char *socket_path = NULL;
+	size_t workers_count = 0;
+	struct budget budget = { .seconds = 0.0, .implicants = 0, .bytes = 0 };
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--store") == 0 && i + 1 < argc) {
+			store_path = argv[++i];
+		} else if (strcmp(argv[i], "--stats") == 0) {
+			print_stats = true;
+		} else if (strcmp(argv[i], "--factor") == 0) {
+			factor = true;
+		} else if (strcmp(argv[i], "--pla") == 0) {
+			pla = true;
+		} else if (strcmp(argv[i], "--simulate") == 0 && i + 1 < argc) {
+			simulated = argv[++i];
+		} else if (strcmp(argv[i], "--timing") == 0 && i + 1 < argc) {
+			timed = argv[++i];
+		} else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+			socket_path = argv[++i];
+		} else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+			if (!parse_size(argv[++i], &workers_count)) {
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+			trace_path = argv[++i];
+		} else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+			if (!parse_seconds(argv[++i], &budget.seconds)) {
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--max-implicants") == 0 && i + 1 < argc) {
+			if (!parse_size(argv[++i], &budget.implicants)) {
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--max-bytes") == 0 && i + 1 < argc) {
+			if (!parse_size(argv[++i], &budget.bytes)) {
+				return 1;
+			}
+		} else {
+			(void)fprintf(
+				stderr,
+				"Usage: %s [--store <path>] [--stats] [--factor] [--pla] [--simulate <expression>] "
+				"[--timing <path>] [--serve <path>] [--workers <count>] [--trace <path>] "
+				"[--timeout <seconds>] [--max-implicants <count>] [--max-bytes <count>]\n",
+				argv[0]
+			);
+			return 1;
+		}
+	}
+
+	// the trace is made of the same spans the statistics are collected over
+	stats_enabled = print_stats || trace_path != NULL;
+	if (trace_path != NULL && !trace_open(trace_path)) {
+		return 1;
+	}
+
+	// a server answers requests until it's stopped, with a worker per processor unless told
+	// otherwise
+	if (socket_path != NULL) {
+		if (workers_count == 0) {
+			long processors_count = sysconf(_SC_NPROCESSORS_ONLN);
+			workers_count = processors_count > 0 ? (size_t)processors_count : 1;
+		}
+
+		struct store store;
+		if (store_path != NULL && !store_open(&store, store_path, true)) {
+			return 1;
+		}
+		bool served =
+			server_run(socket_path, workers_count, budget, store_path != NULL ? &store : NULL);
+		if (store_path != NULL) {
+			store_close(&store);
+		}
+
+		trace_close();
+		if (print_stats) {
+			stats_print(stderr);
+		}
+		stats_drop();
+
+		return served ? 0 : 1;
+	}
+
+	// a PLA is a single multi-output function, and vectors and events are inputs of fixed
+	// expressions, rather than a record per line
+	if (pla || simulated != NULL || timed != NULL) {
+		bool succeeded = false;
+		if (pla) {
+			succeeded = minimize_pla(stdin, stdout, budget);
+		} else if (timed != NULL) {
+			succeeded = simulate_timing(timed, stdin, stdout);
+		} else {
+			// like an expression of the netlist, one that can't be parsed stops the simulation
+			struct expression expression;
+			if (expression_from_string_strict(simulated, &expression)) {
+				(void)setvbuf(stdin, NULL, _IOFBF, (size_t)1 << 20);
+				(void)setvbuf(stdout, NULL, _IOFBF, (size_t)1 << 20);
+				succeeded = simulation_run(&expression, stdin, stdout);
+
+				expression_drop(&expression);
+			} else {
+				(void)fprintf(stderr, "Error: invalid expression to simulate\n");
+			}
+		}
+
+		trace_close();
+		if (print_stats) {
+			stats_print(stderr);
+		}
+		stats_drop();
+
+		return succeeded ? 0 : 1;
+	}
+
+	struct store store;
+	if (store_path != NULL && !store_open(&store, store_path, true)) {
+		return 1;
+	}
+
+	// every line of the input is a separate record, with its own budget, lines can be arbitrarily
+	// long as truth tables of many variables are
+	char *input = NULL;
+	size_t input_capacity = 0;
+	for (size_t record = 0; getline(&input, &input_capacity, stdin) != -1; record++) {
+		input[strcspn(input, "\n")] = '\0';
+
+		struct stats_time record_start = { 0 };
+		if (trace_enabled) {
+			record_start = stats_time_now();
+		}
+
+		minimize(input, &store, store_path, budget, factor);
+
+		if (trace_enabled) {
+			trace_span("record", record, record_start, stats_time_now());
+		}
+	}
+
+	free(input);
+
+	if (store_path != NULL) {
+		store_close(&store);
+	}
+
+	trace_close();
+	if (print_stats) {
+		stats_print(stderr);
+	}
+	stats_drop();
 }
@@ -0,0 +1,482 @@
+#include <pla.h>
+
+#include <allocator.h>
+#include <assert.h>
+#include <ctype.h>
+#include <environment.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void pla_reader_error(struct pla_reader *reader, const char *message) {
+	assert(reader != NULL && message != NULL);
+
+	(void)fprintf(stderr, "Error: line %zu of PLA: %s\n", reader->line_number, message);
+	reader->failed = true;
+}
+
+static char *pla_skip_spaces(char *string) {
+	assert(string != NULL);
+
+	while (isspace((unsigned char)*string)) {
+		string++;
+	}
+	return string;
+}
+
+// reads the next line that isn't blank, without its comment and its trailing spaces, which include
+// the newline and the carriage return of files written on windows
+static bool pla_reader_line(struct pla_reader *reader) {
+	assert(reader != NULL);
+
+	while (getline(&reader->line, &reader->line_capacity, reader->file) != -1) {
+		reader->line_number++;
+
+		char *comment = strchr(reader->line, '#');
+		if (comment != NULL) {
+			*comment = '\0';
+		}
+		size_t length = strlen(reader->line);
+		while (length != 0 && isspace((unsigned char)reader->line[length - 1])) {
+			reader->line[--length] = '\0';
+		}
+		if (*pla_skip_spaces(reader->line) != '\0') {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool pla_parse_count(char *string, size_t *count) {
+	assert(string != NULL && count != NULL);
+
+	char *end = NULL;
+	errno = 0;
+	unsigned long long value = strtoull(string, &end, 10);
+	if (errno != 0 || end == string || *pla_skip_spaces(end) != '\0' || value > SIZE_MAX) {
+		return false;
+	}
+
+	*count = (size_t)value;
+	return true;
+}
+
+// names the inputs after the `.ilb` line if they are distinct letters, and `a`, `b`, ... otherwise
+static bool pla_reader_name_inputs(struct pla_reader *reader, char *names) {
+	assert(reader != NULL);
+
+	if (!variables_reserve(&reader->variables, reader->inputs_count)) {
+		pla_reader_error(reader, "out of memory");
+		return false;
+	}
+	reader->variables.length = reader->inputs_count;
+	char *variables = variables_elements(&reader->variables);
+
+	struct environment environment = environment_new();
+	size_t count = 0;
+	char *state = NULL;
+	for (char *name = names != NULL ? strtok_r(names, " \t\r\n", &state) : NULL; name != NULL;
+		 name = strtok_r(NULL, " \t\r\n", &state)) {
+		if (count == reader->inputs_count || !isalpha((unsigned char)name[0]) || name[1] != '\0' ||
+			environment_get_variable(&environment, name[0])) {
+			count = 0;
+			break;
+		}
+		environment_set_variable(&environment, name[0], true);
+		variables[count++] = name[0];
+	}
+
+	if (count != reader->inputs_count) {
+		if (reader->inputs_count > VARIABLES_COUNT) {
+			pla_reader_error(reader, "too many inputs to be named");
+			return false;
+		}
+		for (size_t i = 0; i < reader->inputs_count; i++) {
+			variables[i] = environment_variable_name(i);
+		}
+	}
+
+	return true;
+}
+
+// keeps the names of the `.ob` line
+static bool pla_reader_name_outputs(struct pla_reader *reader, char *names) {
+	assert(reader != NULL && names != NULL);
+
+	reader->output_names = allocator_allocate_zeroed(reader->outputs_count, sizeof(char *));
+	if (reader->output_names == NULL) {
+		pla_reader_error(reader, "out of memory");
+		return false;
+	}
+
+	size_t count = 0;
+	char *state = NULL;
+	for (char *name = strtok_r(names, " \t\r\n", &state); name != NULL;
+		 name = strtok_r(NULL, " \t\r\n", &state)) {
+		if (count == reader->outputs_count) {
+			pla_reader_error(reader, "more output names than outputs");
+			return false;
+		}
+
+		size_t length = strlen(name);
+		reader->output_names[count] = allocator_allocate(length + 1);
+		if (reader->output_names[count] == NULL) {
+			pla_reader_error(reader, "out of memory");
+			return false;
+		}
+		memcpy(reader->output_names[count++], name, length + 1);
+	}
+	if (count != reader->outputs_count) {
+		pla_reader_error(reader, "fewer output names than outputs");
+		return false;
+	}
+
+	return true;
+}
+
+static char *pla_duplicate(const char *string) {
+	assert(string != NULL);
+
+	size_t length = strlen(string);
+	char *duplicate = allocator_allocate(length + 1);
+	if (duplicate != NULL) {
+		memcpy(duplicate, string, length + 1);
+	}
+	return duplicate;
+}
+
+bool pla_reader_open(struct pla_reader *reader, FILE *file) {
+	assert(reader != NULL && file != NULL);
+
+	*reader = (struct pla_reader){
+		.file = file,
+		.line = NULL,
+		.line_capacity = 0,
+		.line_number = 0,
+		.inputs_count = 0,
+		.outputs_count = 1,
+		.output_names = NULL,
+		.variables = variables_new(),
+		.pending = false,
+		.ended = false,
+		.failed = false,
+	};
+
+	// the names may come before the counts, so they are only used once the whole header is read
+	char *input_names = NULL;
+	char *output_names = NULL;
+	bool inputs_given = false;
+	while (!reader->failed && pla_reader_line(reader)) {
+		char *line = pla_skip_spaces(reader->line);
+		if (*line != '.') {
+			reader->pending = true;
+			break;
+		}
+
+		char *keyword = line + 1;
+		char *arguments = keyword;
+		while (*arguments != '\0' && !isspace((unsigned char)*arguments)) {
+			arguments++;
+		}
+		if (*arguments != '\0') {
+			*arguments++ = '\0';
+		}
+		arguments = pla_skip_spaces(arguments);
+
+		if (strcmp(keyword, "i") == 0) {
+			if (!pla_parse_count(arguments, &reader->inputs_count) || reader->inputs_count == 0 ||
+				reader->inputs_count >= 64) {
+				pla_reader_error(reader, "invalid number of inputs");
+			}
+			inputs_given = true;
+		} else if (strcmp(keyword, "o") == 0) {
+			if (!pla_parse_count(arguments, &reader->outputs_count) ||
+				reader->outputs_count == 0) {
+				pla_reader_error(reader, "invalid number of outputs");
+			}
+		} else if (strcmp(keyword, "ilb") == 0 || strcmp(keyword, "ob") == 0) {
+			char **names = keyword[1] == 'l' ? &input_names : &output_names;
+			allocator_free(*names);
+			*names = pla_duplicate(arguments);
+			if (*names == NULL) {
+				pla_reader_error(reader, "out of memory");
+			}
+		} else if (strcmp(keyword, "type") == 0) {
+			if (strcmp(arguments, "f") != 0 && strcmp(arguments, "fd") != 0 &&
+				strcmp(arguments, "fr") != 0 && strcmp(arguments, "fdr") != 0) {
+				pla_reader_error(reader, "unsupported type");
+			}
+		} else if (strcmp(keyword, "e") == 0 || strcmp(keyword, "end") == 0) {
+			reader->ended = true;
+			break;
+		} else if (strcmp(keyword, "p") != 0) {
+			pla_reader_error(reader, "unsupported keyword");
+		}
+	}
+
+	if (!reader->failed && !inputs_given) {
+		pla_reader_error(reader, "missing number of inputs");
+	}
+	if (!reader->failed) {
+		(void)(pla_reader_name_inputs(reader, input_names) &&
+			   (output_names == NULL || pla_reader_name_outputs(reader, output_names)));
+	}
+
+	allocator_free(input_names);
+	allocator_free(output_names);
+
+	if (reader->failed) {
+		pla_reader_close(reader);
+		return false;
+	}
+
+	return true;
+}
+
+void pla_reader_close(struct pla_reader *reader) {
+	assert(reader != NULL);
+
+	// the line is allocated by `getline()`
+	free(reader->line);
+	if (reader->output_names != NULL) {
+		for (size_t i = 0; i < reader->outputs_count; i++) {
+			allocator_free(reader->output_names[i]);
+		}
+		allocator_free(reader->output_names);
+	}
+	variables_drop(&reader->variables);
+
+	reader->line = NULL;
+	reader->output_names = NULL;
+	reader->variables = variables_new();
+}
+
+bool pla_reader_next(struct pla_reader *reader, struct implicant *cube, bool *outputs) {
+	assert(reader != NULL && cube != NULL && outputs != NULL);
+
+	if (reader->failed || reader->ended) {
+		return false;
+	}
+	if (!reader->pending && !pla_reader_line(reader)) {
+		reader->ended = true;
+		return false;
+	}
+	reader->pending = false;
+
+	char *line = pla_skip_spaces(reader->line);
+	if (*line == '.') {
+		if (strncmp(line, ".e", 2) == 0 &&
+			(isspace((unsigned char)line[2]) || line[2] == '\0' || strncmp(line, ".end", 4) == 0)) {
+			reader->ended = true;
+		} else {
+			pla_reader_error(reader, "unexpected keyword after the first cube");
+		}
+		return false;
+	}
+
+	*cube = (struct implicant){ .value = 0, .mask = 0 };
+	for (size_t i = 0; i < reader->inputs_count; i++) {
+		line = pla_skip_spaces(line);
+
+		uint64_t bit = UINT64_C(1) << (reader->inputs_count - i - 1);
+		switch (*line++) {
+			case '0': cube->mask |= bit; break;
+			case '1': {
+				cube->mask |= bit;
+				cube->value |= bit;
+			} break;
+			case '-':
+			case '2': break;
+			default: {
+				pla_reader_error(reader, "invalid input column");
+				return false;
+			}
+		}
+	}
+	for (size_t i = 0; i < reader->outputs_count; i++) {
+		line = pla_skip_spaces(line);
+
+		switch (*line++) {
+			case '1':
+			case '4': outputs[i] = true; break;
+			case '0':
+			case '-':
+			case '~':
+			case '2':
+			case '3': outputs[i] = false; break;
+			default: {
+				pla_reader_error(reader, "invalid output column");
+				return false;
+			}
+		}
+	}
+	if (*pla_skip_spaces(line) != '\0') {
+		pla_reader_error(reader, "trailing columns");
+		return false;
+	}
+
+	return true;
+}
+
+// sets the bits of the minterms covered by a cube, the minterms that only differ in the last 6
+// inputs share a word, so the cube's pattern within a word is built once
+static void pla_mark_cube(uint64_t *table, size_t inputs_count, struct implicant cube) {
+	assert(table != NULL);
+
+	uint64_t dashes = ~cube.mask & ((UINT64_C(1) << inputs_count) - 1U);
+	uint64_t value = cube.value & cube.mask;
+
+	uint64_t low_dashes = dashes & 63U;
+	uint64_t pattern = 0;
+	uint64_t subset = 0;
+	do {
+		pattern |= UINT64_C(1) << ((value & 63U) | subset);
+		subset = (subset - low_dashes) & low_dashes;
+	} while (subset != 0);
+
+	uint64_t high_dashes = dashes & ~UINT64_C(63);
+	subset = 0;
+	do {
+		table[((value & ~UINT64_C(63)) | subset) >> 6U] |= pattern;
+		subset = (subset - high_dashes) & high_dashes;
+	} while (subset != 0);
+}
+
+bool pla_reader_read_minterms(struct pla_reader *reader, struct minterms *minterms) {
+	assert(reader != NULL && minterms != NULL);
+
+	if (reader->inputs_count > PLA_MAXIMUM_INPUTS) {
+		pla_reader_error(reader, "too many inputs");
+		return false;
+	}
+
+	size_t words = reader->inputs_count <= 6 ? 1 : (size_t)1 << (reader->inputs_count - 6);
+	uint64_t *tables = allocator_allocate_zeroed(reader->outputs_count * words, sizeof(*tables));
+	bool *outputs = allocator_allocate(reader->outputs_count * sizeof(*outputs));
+	if (tables == NULL || outputs == NULL) {
+		allocator_free(tables);
+		allocator_free(outputs);
+		pla_reader_error(reader, "out of memory");
+		return false;
+	}
+
+	struct implicant cube;
+	while (pla_reader_next(reader, &cube, outputs)) {
+		for (size_t i = 0; i < reader->outputs_count; i++) {
+			if (outputs[i]) {
+				pla_mark_cube(&tables[i * words], reader->inputs_count, cube);
+			}
+		}
+	}
+	allocator_free(outputs);
+
+	for (size_t i = 0; i < reader->outputs_count && !reader->failed; i++) {
+		const uint64_t *table = &tables[i * words];
+
+		size_t length = 0;
+		for (size_t j = 0; j < words; j++) {
+			length += (size_t)__builtin_popcountll(table[j]);
+		}
+
+		minterms[i] = (struct minterms){
+			.variables = variables_new(),
+			.data = allocator_allocate((length != 0 ? length : 1) * sizeof(*minterms[i].data)),
+			.length = 0,
+		};
+		bool appended = variables_append(
+			&minterms[i].variables,
+			variables_const_elements(&reader->variables),
+			reader->variables.length
+		);
+		if (!appended || minterms[i].data == NULL) {
+			minterms_drop(&minterms[i]);
+			for (size_t j = 0; j < i; j++) {
+				minterms_drop(&minterms[j]);
+			}
+			pla_reader_error(reader, "out of memory");
+			break;
+		}
+		for (size_t j = 0; j < words; j++) {
+			for (uint64_t word = table[j]; word != 0; word &= word - 1) {
+				minterms[i].data[minterms[i].length++] = j * 64 + (uint64_t)__builtin_ctzll(word);
+			}
+		}
+	}
+
+	allocator_free(tables);
+
+	return !reader->failed;
+}
+
+bool pla_writer_open(
+	struct pla_writer *writer,
+	FILE *file,
+	const struct variables *variables,
+	size_t outputs_count,
+	char *const *output_names
+) {
+	assert(writer != NULL && file != NULL && variables != NULL);
+
+	*writer = (struct pla_writer){
+		.file = file,
+		.line = allocator_allocate(variables->length + outputs_count + 3),
+		.inputs_count = variables->length,
+		.outputs_count = outputs_count,
+		.failed = false,
+	};
+	if (writer->line == NULL) {
+		return false;
+	}
+
+	(void)fprintf(file, ".i %zu\n.o %zu\n.ilb", variables->length, outputs_count);
+	for (size_t i = 0; i < variables->length; i++) {
+		(void)fprintf(file, " %c", variables_const_elements(variables)[i]);
+	}
+	(void)fprintf(file, "\n");
+	if (output_names != NULL) {
+		(void)fprintf(file, ".ob");
+		for (size_t i = 0; i < outputs_count; i++) {
+			(void)fprintf(file, " %s", output_names[i]);
+		}
+		(void)fprintf(file, "\n");
+	}
+	(void)fprintf(file, ".type f\n");
+
+	return ferror(file) == 0;
+}
+
+void pla_writer_write(struct pla_writer *writer, struct implicant cube, size_t output) {
+	assert(writer != NULL && output < writer->outputs_count);
+
+	char *line = writer->line;
+	for (size_t i = 0; i < writer->inputs_count; i++) {
+		uint64_t bit = UINT64_C(1) << (writer->inputs_count - i - 1);
+		*line++ = (cube.mask & bit) == 0 ? '-' : (cube.value & bit) != 0 ? '1' : '0';
+	}
+	*line++ = ' ';
+	for (size_t i = 0; i < writer->outputs_count; i++) {
+		*line++ = i == output ? '1' : '0';
+	}
+	*line++ = '\n';
+	*line = '\0';
+
+	if (fputs(writer->line, writer->file) == EOF) {
+		writer->failed = true;
+	}
+}
+
+bool pla_writer_close(struct pla_writer *writer) {
+	assert(writer != NULL);
+
+	(void)fprintf(writer->file, ".e\n");
+	if (fflush(writer->file) != 0 || ferror(writer->file) != 0) {
+		writer->failed = true;
+	}
+
+	allocator_free(writer->line);
+	writer->line = NULL;
+
+	return !writer->failed;
+}
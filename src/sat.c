@@ -0,0 +1,538 @@
+#include <sat.h>
+
+#include <allocator.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAT_RESTART_INTERVAL (100)
+#define SAT_ACTIVITY_DECAY (0.95)
+#define SAT_ACTIVITY_LIMIT (1e100)
+
+static inline size_t sat_literal_variable(uint32_t literal) {
+	return literal >> 1U;
+}
+static inline uint32_t sat_literal_negate(uint32_t literal) {
+	return literal ^ 1U;
+}
+static inline uint8_t sat_literal_value(const struct sat_solver *solver, uint32_t literal) {
+	uint8_t value = solver->values[sat_literal_variable(literal)];
+	if (value == SAT_VALUE_UNASSIGNED) {
+		return value;
+	}
+	return value ^ (uint8_t)(literal & 1U);
+}
+
+// returns the `i`th element of the luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+static uint64_t sat_luby(uint64_t i) {
+	uint64_t size = 1;
+	uint64_t sequence = 0;
+	while (size < i + 1) {
+		sequence++;
+		size = 2 * size + 1;
+	}
+	while (size - 1 != i) {
+		size = (size - 1) / 2;
+		sequence--;
+		i %= size;
+	}
+	return UINT64_C(1) << sequence;
+}
+
+struct sat_solver sat_solver_new(void) {
+	return (struct sat_solver){
+		.variables_count = 0,
+		.variables_capacity = 0,
+		.values = NULL,
+		.polarities = NULL,
+		.levels = NULL,
+		.reasons = NULL,
+		.activities = NULL,
+		.activity_increment = 1.0,
+		.seen = NULL,
+		.heap = NULL,
+		.heap_length = 0,
+		.heap_positions = NULL,
+		.trail = NULL,
+		.trail_length = 0,
+		.propagated = 0,
+		.trail_limits = NULL,
+		.level = 0,
+		.watches = NULL,
+		.clauses = NULL,
+		.clauses_length = 0,
+		.clauses_capacity = 0,
+		.learnt = NULL,
+		.conflicts = 0,
+		.unsatisfiable = false,
+		.out_of_memory = false,
+	};
+}
+
+void sat_solver_drop(struct sat_solver *solver) {
+	assert(solver != NULL);
+
+	for (size_t i = 0; i < 2 * solver->variables_count; i++) {
+		allocator_free(solver->watches[i].data);
+	}
+	allocator_free(solver->watches);
+	allocator_free(solver->values);
+	allocator_free(solver->polarities);
+	allocator_free(solver->levels);
+	allocator_free(solver->reasons);
+	allocator_free(solver->activities);
+	allocator_free(solver->seen);
+	allocator_free(solver->heap);
+	allocator_free(solver->heap_positions);
+	allocator_free(solver->trail);
+	allocator_free(solver->trail_limits);
+	allocator_free(solver->clauses);
+	allocator_free(solver->learnt);
+}
+
+static bool sat_heap_less(const struct sat_solver *solver, size_t variable_1, size_t variable_2) {
+	return solver->activities[variable_1] > solver->activities[variable_2];
+}
+static void sat_heap_up(struct sat_solver *solver, size_t position) {
+	size_t variable = solver->heap[position];
+	while (position != 0 && sat_heap_less(solver, variable, solver->heap[(position - 1) / 2])) {
+		solver->heap[position] = solver->heap[(position - 1) / 2];
+		solver->heap_positions[solver->heap[position]] = position;
+		position = (position - 1) / 2;
+	}
+	solver->heap[position] = variable;
+	solver->heap_positions[variable] = position;
+}
+static void sat_heap_down(struct sat_solver *solver, size_t position) {
+	size_t variable = solver->heap[position];
+	while (2 * position + 1 < solver->heap_length) {
+		size_t child = 2 * position + 1;
+		if (child + 1 < solver->heap_length &&
+			sat_heap_less(solver, solver->heap[child + 1], solver->heap[child])) {
+			child++;
+		}
+		if (!sat_heap_less(solver, solver->heap[child], variable)) {
+			break;
+		}
+		solver->heap[position] = solver->heap[child];
+		solver->heap_positions[solver->heap[position]] = position;
+		position = child;
+	}
+	solver->heap[position] = variable;
+	solver->heap_positions[variable] = position;
+}
+static void sat_heap_insert(struct sat_solver *solver, size_t variable) {
+	if (solver->heap_positions[variable] != SIZE_MAX) {
+		return;
+	}
+	solver->heap[solver->heap_length] = variable;
+	sat_heap_up(solver, solver->heap_length++);
+}
+static size_t sat_heap_pop(struct sat_solver *solver) {
+	assert(solver->heap_length != 0);
+
+	size_t variable = solver->heap[0];
+	solver->heap_positions[variable] = SIZE_MAX;
+	if (--solver->heap_length != 0) {
+		solver->heap[0] = solver->heap[solver->heap_length];
+		sat_heap_down(solver, 0);
+	}
+	return variable;
+}
+
+// grows an array to `count` elements, if memory runs out `failed` is set and the array is left as
+// it was
+#define SAT_REALLOCATE(array, count, failed)                                                       \
+	do {                                                                                           \
+		void *array_ = allocator_reallocate((array), (count) * sizeof(*(array)));                  \
+		if (array_ != NULL) {                                                                      \
+			(array) = array_;                                                                      \
+		} else {                                                                                   \
+			(failed) = true;                                                                       \
+		}                                                                                          \
+	} while (0)
+
+size_t sat_solver_new_variable(struct sat_solver *solver) {
+	assert(solver != NULL);
+
+	if (solver->out_of_memory) {
+		return 0;
+	}
+
+	if (solver->variables_count == solver->variables_capacity) {
+		size_t capacity = solver->variables_capacity == 0 ? 16 : 2 * solver->variables_capacity;
+		assert(capacity <= UINT32_MAX / 2);
+
+		// the arrays that did grow keep their new size, they are only ever used up to the capacity
+		bool failed = false;
+		SAT_REALLOCATE(solver->values, capacity, failed);
+		SAT_REALLOCATE(solver->polarities, capacity, failed);
+		SAT_REALLOCATE(solver->levels, capacity, failed);
+		SAT_REALLOCATE(solver->reasons, capacity, failed);
+		SAT_REALLOCATE(solver->activities, capacity, failed);
+		SAT_REALLOCATE(solver->seen, capacity, failed);
+		SAT_REALLOCATE(solver->heap, capacity, failed);
+		SAT_REALLOCATE(solver->heap_positions, capacity, failed);
+		SAT_REALLOCATE(solver->trail, capacity, failed);
+		SAT_REALLOCATE(solver->trail_limits, capacity + 1, failed);
+		SAT_REALLOCATE(solver->learnt, capacity, failed);
+		SAT_REALLOCATE(solver->watches, 2 * capacity, failed);
+		if (failed) {
+			solver->out_of_memory = true;
+			return 0;
+		}
+
+		solver->variables_capacity = capacity;
+	}
+
+	size_t variable = solver->variables_count++;
+	solver->values[variable] = SAT_VALUE_UNASSIGNED;
+	solver->polarities[variable] = SAT_VALUE_FALSE;
+	solver->levels[variable] = 0;
+	solver->reasons[variable] = SAT_REASON_NONE;
+	solver->activities[variable] = 0.0;
+	solver->seen[variable] = false;
+	solver->heap_positions[variable] = SIZE_MAX;
+	for (size_t i = 0; i < 2; i++) {
+		solver->watches[2 * variable + i] = (struct sat_watches){
+			.data = NULL,
+			.length = 0,
+			.capacity = 0,
+		};
+	}
+	sat_heap_insert(solver, variable);
+
+	return variable;
+}
+
+// returns `false` if memory ran out
+static bool sat_watch(struct sat_solver *solver, uint32_t literal, size_t clause) {
+	struct sat_watches *watches = &solver->watches[sat_literal_negate(literal)];
+	if (watches->length == watches->capacity) {
+		size_t capacity = watches->capacity == 0 ? 4 : 2 * watches->capacity;
+		SAT_REALLOCATE(watches->data, capacity, solver->out_of_memory);
+		if (solver->out_of_memory) {
+			return false;
+		}
+		watches->capacity = capacity;
+	}
+	watches->data[watches->length++] = clause;
+	return true;
+}
+
+// returns the clause, or `SAT_REASON_NONE` if memory ran out
+static size_t sat_clause_allocate(
+	struct sat_solver *solver,
+	const uint32_t *literals,
+	size_t length
+) {
+	assert(length >= 2 && length <= UINT32_MAX);
+
+	if (solver->clauses_capacity - solver->clauses_length < length + 1) {
+		size_t capacity = solver->clauses_capacity == 0 ? 1024 : 2 * solver->clauses_capacity;
+		while (capacity - solver->clauses_length < length + 1) {
+			capacity *= 2;
+		}
+		SAT_REALLOCATE(solver->clauses, capacity, solver->out_of_memory);
+		if (solver->out_of_memory) {
+			return SAT_REASON_NONE;
+		}
+		solver->clauses_capacity = capacity;
+	}
+
+	size_t clause = solver->clauses_length;
+	solver->clauses[clause] = (uint32_t)length;
+	memcpy(&solver->clauses[clause + 1], literals, length * sizeof(*literals));
+
+	if (!sat_watch(solver, literals[0], clause)) {
+		return SAT_REASON_NONE;
+	}
+	if (!sat_watch(solver, literals[1], clause)) {
+		solver->watches[sat_literal_negate(literals[0])].length--;
+		return SAT_REASON_NONE;
+	}
+	solver->clauses_length += length + 1;
+
+	return clause;
+}
+
+static void sat_enqueue(struct sat_solver *solver, uint32_t literal, size_t reason) {
+	assert(sat_literal_value(solver, literal) == SAT_VALUE_UNASSIGNED);
+
+	size_t variable = sat_literal_variable(literal);
+	solver->values[variable] = (uint8_t)(~literal & 1U);
+	solver->levels[variable] = solver->level;
+	solver->reasons[variable] = reason;
+	solver->trail[solver->trail_length++] = literal;
+}
+
+static void sat_cancel_until(struct sat_solver *solver, size_t level) {
+	if (solver->level <= level) {
+		return;
+	}
+
+	for (size_t i = solver->trail_length; i > solver->trail_limits[level]; i--) {
+		size_t variable = sat_literal_variable(solver->trail[i - 1]);
+		solver->polarities[variable] = solver->values[variable];
+		solver->values[variable] = SAT_VALUE_UNASSIGNED;
+		solver->reasons[variable] = SAT_REASON_NONE;
+		sat_heap_insert(solver, variable);
+	}
+	solver->trail_length = solver->trail_limits[level];
+	solver->propagated = solver->trail_length;
+	solver->level = level;
+}
+
+// returns the clause that became conflicting, or `SAT_REASON_NONE`
+static size_t sat_propagate(struct sat_solver *solver) {
+	while (solver->propagated < solver->trail_length) {
+		uint32_t literal = solver->trail[solver->propagated++];
+		uint32_t false_literal = sat_literal_negate(literal);
+		struct sat_watches *watches = &solver->watches[literal];
+
+		size_t i = 0;
+		size_t j = 0;
+		while (i < watches->length) {
+			size_t clause = watches->data[i++];
+			uint32_t length = solver->clauses[clause];
+			uint32_t *literals = &solver->clauses[clause + 1];
+
+			// keep the falsified watch in the second position
+			if (literals[0] == false_literal) {
+				literals[0] = literals[1];
+				literals[1] = false_literal;
+			}
+
+			if (sat_literal_value(solver, literals[0]) == SAT_VALUE_TRUE) {
+				watches->data[j++] = clause;
+				continue;
+			}
+
+			bool moved = false;
+			for (uint32_t k = 2; k < length; k++) {
+				if (sat_literal_value(solver, literals[k]) != SAT_VALUE_FALSE) {
+					if (sat_watch(solver, literals[k], clause)) {
+						literals[1] = literals[k];
+						literals[k] = false_literal;
+						moved = true;
+					}
+					break;
+				}
+			}
+			if (moved) {
+				continue;
+			}
+
+			// if memory ran out the clause keeps its watch and the propagation stops
+			watches->data[j++] = clause;
+			if (solver->out_of_memory ||
+				sat_literal_value(solver, literals[0]) == SAT_VALUE_FALSE) {
+				while (i < watches->length) {
+					watches->data[j++] = watches->data[i++];
+				}
+				watches->length = j;
+				return solver->out_of_memory ? SAT_REASON_NONE : clause;
+			}
+			sat_enqueue(solver, literals[0], clause);
+		}
+		watches->length = j;
+	}
+
+	return SAT_REASON_NONE;
+}
+
+static void sat_bump(struct sat_solver *solver, size_t variable) {
+	solver->activities[variable] += solver->activity_increment;
+	if (solver->activities[variable] > SAT_ACTIVITY_LIMIT) {
+		for (size_t i = 0; i < solver->variables_count; i++) {
+			solver->activities[i] /= SAT_ACTIVITY_LIMIT;
+		}
+		solver->activity_increment /= SAT_ACTIVITY_LIMIT;
+	}
+	if (solver->heap_positions[variable] != SIZE_MAX) {
+		sat_heap_up(solver, solver->heap_positions[variable]);
+	}
+}
+
+// derives the first unique implication point clause into `solver->learnt`, returns its length and
+// sets `level` to the level it becomes asserting at
+static size_t sat_analyze(struct sat_solver *solver, size_t conflict, size_t *level) {
+	size_t length = 1;
+	size_t pending = 0;
+	uint32_t literal = 0;
+	bool resolved = false;
+	size_t index = solver->trail_length;
+
+	do {
+		uint32_t clause_length = solver->clauses[conflict];
+		const uint32_t *literals = &solver->clauses[conflict + 1];
+		// the first literal of a reason clause is the literal it implied
+		for (uint32_t i = resolved ? 1 : 0; i < clause_length; i++) {
+			size_t variable = sat_literal_variable(literals[i]);
+			if (solver->seen[variable] || solver->levels[variable] == 0) {
+				continue;
+			}
+
+			sat_bump(solver, variable);
+			solver->seen[variable] = true;
+			if (solver->levels[variable] == solver->level) {
+				pending++;
+			} else {
+				solver->learnt[length++] = literals[i];
+			}
+		}
+
+		do {
+			literal = solver->trail[--index];
+		} while (!solver->seen[sat_literal_variable(literal)]);
+
+		conflict = solver->reasons[sat_literal_variable(literal)];
+		solver->seen[sat_literal_variable(literal)] = false;
+		resolved = true;
+	} while (--pending != 0);
+
+	solver->learnt[0] = sat_literal_negate(literal);
+
+	// the literal of the highest remaining level is watched along with the asserting one
+	*level = 0;
+	for (size_t i = 1; i < length; i++) {
+		solver->seen[sat_literal_variable(solver->learnt[i])] = false;
+		if (solver->levels[sat_literal_variable(solver->learnt[i])] > *level) {
+			*level = solver->levels[sat_literal_variable(solver->learnt[i])];
+			uint32_t swap = solver->learnt[1];
+			solver->learnt[1] = solver->learnt[i];
+			solver->learnt[i] = swap;
+		}
+	}
+
+	return length;
+}
+
+bool sat_solver_add_clause(struct sat_solver *solver, const uint32_t *literals, size_t length) {
+	assert(solver != NULL && (literals != NULL || length == 0));
+
+	// once memory ran out the variables of the literals may not exist
+	if (solver->unsatisfiable || solver->out_of_memory) {
+		return false;
+	}
+
+	sat_cancel_until(solver, 0);
+
+	// drop literals that are false at the root and clauses that are already satisfied
+	uint32_t *clause = allocator_allocate((length + 1) * sizeof(*clause));
+	if (clause == NULL) {
+		solver->out_of_memory = true;
+		return false;
+	}
+	size_t clause_length = 0;
+	for (size_t i = 0; i < length; i++) {
+		assert(sat_literal_variable(literals[i]) < solver->variables_count);
+
+		uint8_t value = sat_literal_value(solver, literals[i]);
+		bool satisfied = value == SAT_VALUE_TRUE;
+		for (size_t j = 0; j < clause_length && !satisfied; j++) {
+			satisfied = clause[j] == sat_literal_negate(literals[i]);
+		}
+		if (satisfied) {
+			allocator_free(clause);
+			return true;
+		}
+
+		bool duplicate = value == SAT_VALUE_FALSE;
+		for (size_t j = 0; j < clause_length && !duplicate; j++) {
+			duplicate = clause[j] == literals[i];
+		}
+		if (!duplicate) {
+			clause[clause_length++] = literals[i];
+		}
+	}
+
+	if (clause_length == 0) {
+		solver->unsatisfiable = true;
+	} else if (clause_length == 1) {
+		sat_enqueue(solver, clause[0], SAT_REASON_NONE);
+		if (sat_propagate(solver) != SAT_REASON_NONE) {
+			solver->unsatisfiable = true;
+		}
+	} else {
+		(void)sat_clause_allocate(solver, clause, clause_length);
+	}
+
+	allocator_free(clause);
+
+	return !solver->unsatisfiable && !solver->out_of_memory;
+}
+
+bool sat_solver_solve(struct sat_solver *solver) {
+	assert(solver != NULL);
+
+	if (solver->unsatisfiable || solver->out_of_memory) {
+		return false;
+	}
+
+	sat_cancel_until(solver, 0);
+
+	uint64_t restarts = 0;
+	uint64_t conflicts = 0;
+	while (true) {
+		size_t conflict = sat_propagate(solver);
+		if (solver->out_of_memory) {
+			return false;
+		}
+		if (conflict != SAT_REASON_NONE) {
+			solver->conflicts++;
+			conflicts++;
+
+			if (solver->level == 0) {
+				solver->unsatisfiable = true;
+				return false;
+			}
+
+			size_t level = 0;
+			size_t length = sat_analyze(solver, conflict, &level);
+			sat_cancel_until(solver, level);
+			if (length == 1) {
+				sat_enqueue(solver, solver->learnt[0], SAT_REASON_NONE);
+			} else {
+				size_t clause = sat_clause_allocate(solver, solver->learnt, length);
+				if (clause == SAT_REASON_NONE) {
+					return false;
+				}
+				sat_enqueue(solver, solver->learnt[0], clause);
+			}
+
+			solver->activity_increment /= SAT_ACTIVITY_DECAY;
+
+			if (conflicts >= SAT_RESTART_INTERVAL * sat_luby(restarts)) {
+				conflicts = 0;
+				restarts++;
+				sat_cancel_until(solver, 0);
+			}
+		} else {
+			size_t variable = SIZE_MAX;
+			while (solver->heap_length != 0) {
+				variable = sat_heap_pop(solver);
+				if (solver->values[variable] == SAT_VALUE_UNASSIGNED) {
+					break;
+				}
+				variable = SIZE_MAX;
+			}
+			if (variable == SIZE_MAX) {
+				return true;
+			}
+
+			solver->trail_limits[solver->level++] = solver->trail_length;
+			sat_enqueue(
+				solver,
+				sat_literal(variable, solver->polarities[variable] == SAT_VALUE_FALSE),
+				SAT_REASON_NONE
+			);
+		}
+	}
+}
+
+bool sat_solver_value(const struct sat_solver *solver, size_t variable) {
+	assert(solver != NULL && variable < solver->variables_count);
+	assert(solver->values[variable] != SAT_VALUE_UNASSIGNED);
+
+	return solver->values[variable] == SAT_VALUE_TRUE;
+}
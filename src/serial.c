@@ -0,0 +1,584 @@
+#include <serial.h>
+
+#include <allocator.h>
+#include <assert.h>
+#include <ctype.h>
+#include <environment.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SERIAL_MAGIC "DGLBYTES"
+
+// the names of the variables take a multiple of 8 bytes, so that the words after them are aligned
+static size_t serial_variables_size_(size_t variables_count) {
+	return (variables_count + 7) / 8 * 8;
+}
+
+// allocates a buffer with a header and `payload_size` bytes after it
+static void *serial_allocate_(
+	enum serial_kind kind,
+	size_t variables_count,
+	size_t count,
+	size_t payload_size,
+	size_t *size
+) {
+	assert(size != NULL);
+
+	if (payload_size > SIZE_MAX - sizeof(struct serial_header)) {
+		return NULL;
+	}
+	*size = sizeof(struct serial_header) + payload_size;
+
+	struct serial_header *header = allocator_allocate(*size);
+	if (header == NULL) {
+		return NULL;
+	}
+	memcpy(header->magic, SERIAL_MAGIC, sizeof(header->magic));
+	header->version = SERIAL_VERSION;
+	header->kind = kind;
+	header->variables_count = variables_count;
+	header->count = count;
+
+	return header;
+}
+
+// checks the header of a buffer, returns `NULL` if it doesn't hold data of the given kind
+static const struct serial_header *serial_header_(
+	const void *data,
+	size_t size,
+	enum serial_kind kind
+) {
+	assert(data != NULL);
+
+	if ((uintptr_t)data % sizeof(uint64_t) != 0 || size < sizeof(struct serial_header)) {
+		return NULL;
+	}
+
+	const struct serial_header *header = data;
+	if (memcmp(header->magic, SERIAL_MAGIC, sizeof(header->magic)) != 0 ||
+		header->version != SERIAL_VERSION || header->kind != kind) {
+		return NULL;
+	}
+
+	return header;
+}
+
+// counts the nodes of an expression, returns `0` if an operation has too many operands
+static size_t serial_expression_count_(const struct expression *expression) {
+	assert(expression != NULL);
+
+	if (expression->type != expression_type_operation) {
+		return 1;
+	}
+	if (expression->operation.operands_count > UINT32_MAX) {
+		return 0;
+	}
+
+	size_t count = 1;
+	for (size_t i = 0; i < expression->operation.operands_count; i++) {
+		size_t operand_count = serial_expression_count_(&expression->operation.operands[i]);
+		if (operand_count == 0) {
+			return 0;
+		}
+		count += operand_count;
+	}
+	return count;
+}
+
+// writes the nodes of an expression in pre-order, returns the node after them
+static struct serial_node *serial_expression_write_(
+	const struct expression *expression,
+	struct serial_node *node
+) {
+	assert(expression != NULL && node != NULL);
+
+	switch (expression->type) {
+		case expression_type_constant: {
+			*node++ = (struct serial_node){
+				.type = expression_type_constant,
+				.value = expression->constant.value,
+			};
+		} break;
+		case expression_type_variable: {
+			*node++ = (struct serial_node){
+				.type = expression_type_variable,
+				.value = (uint8_t)expression->variable.name,
+			};
+		} break;
+		case expression_type_operation: {
+			*node++ = (struct serial_node){
+				.type = expression_type_operation,
+				.value = (uint8_t)expression->operation.type,
+				.operands_count = (uint32_t)expression->operation.operands_count,
+			};
+			for (size_t i = 0; i < expression->operation.operands_count; i++) {
+				node = serial_expression_write_(&expression->operation.operands[i], node);
+			}
+		} break;
+		default: assert(false);
+	}
+
+	return node;
+}
+
+void *expression_serialize(const struct expression *expression, size_t *size) {
+	assert(expression != NULL && size != NULL);
+
+	size_t count = serial_expression_count_(expression);
+	if (count == 0 || count > SIZE_MAX / sizeof(struct serial_node)) {
+		return NULL;
+	}
+
+	struct serial_header *header = serial_allocate_(
+		serial_kind_expression,
+		0,
+		count,
+		count * sizeof(struct serial_node),
+		size
+	);
+	if (header == NULL) {
+		return NULL;
+	}
+
+	struct serial_node *end = serial_expression_write_(expression, (void *)&header[1]);
+	assert(end == (struct serial_node *)(void *)&header[1] + count);
+	(void)end;
+
+	return header;
+}
+
+// serializes the names of variables followed by `count` elements of `element_size` bytes
+static void *serial_variables_serialize_(
+	enum serial_kind kind,
+	const struct variables *variables,
+	const void *elements,
+	size_t count,
+	size_t element_size,
+	size_t *size
+) {
+	assert(variables != NULL && (elements != NULL || count == 0) && size != NULL);
+
+	size_t variables_size = serial_variables_size_(variables->length);
+	if (count > (SIZE_MAX - variables_size) / element_size) {
+		return NULL;
+	}
+
+	struct serial_header *header = serial_allocate_(
+		kind,
+		variables->length,
+		count,
+		variables_size + count * element_size,
+		size
+	);
+	if (header == NULL) {
+		return NULL;
+	}
+
+	unsigned char *payload = (void *)&header[1];
+	memset(payload, 0, variables_size);
+	memcpy(payload, variables_const_elements(variables), variables->length);
+	if (count != 0) {
+		memcpy(&payload[variables_size], elements, count * element_size);
+	}
+
+	return header;
+}
+
+void *minterms_serialize(const struct minterms *minterms, size_t *size) {
+	assert(minterms != NULL && size != NULL);
+
+	return serial_variables_serialize_(
+		serial_kind_minterms,
+		&minterms->variables,
+		minterms->data,
+		minterms->length,
+		sizeof(*minterms->data),
+		size
+	);
+}
+
+void *implicants_serialize(
+	const struct implicants *implicants,
+	const struct variables *variables,
+	size_t *size
+) {
+	assert(implicants != NULL && variables != NULL && size != NULL);
+
+	return serial_variables_serialize_(
+		serial_kind_implicants,
+		variables,
+		implicants_const_elements(implicants),
+		implicants->length,
+		sizeof(struct implicant),
+		size
+	);
+}
+
+bool serial_expression_view(const void *data, size_t size, struct serial_expression *expression) {
+	assert(data != NULL && expression != NULL);
+
+	const struct serial_header *header = serial_header_(data, size, serial_kind_expression);
+	if (header == NULL || header->count == 0 ||
+		header->count > (size - sizeof(*header)) / sizeof(struct serial_node)) {
+		return false;
+	}
+
+	const struct serial_node *nodes = (const void *)&header[1];
+	size_t length = (size_t)header->count;
+
+	// the nodes are checked backwards, the way they are evaluated, so that every operation takes
+	// the values of its operands and the expression leaves a single value
+	size_t pending = 0;
+	size_t depth = 0;
+	for (size_t i = length; i-- > 0;) {
+		const struct serial_node *node = &nodes[i];
+		if (node->reserved != 0) {
+			return false;
+		}
+
+		switch (node->type) {
+			case expression_type_constant: {
+				if (node->value > 1 || node->operands_count != 0) {
+					return false;
+				}
+			} break;
+			case expression_type_variable: {
+				if (!isalpha(node->value) || node->operands_count != 0) {
+					return false;
+				}
+			} break;
+			case expression_type_operation: {
+				if (node->value > operation_type_implication) {
+					return false;
+				}
+				enum operation_type type = (enum operation_type)node->value;
+				size_t operands_count = node->operands_count;
+				size_t arity = operation_type_arity(type);
+				if (operation_type_is_variadic(type) ? operands_count < arity
+													 : operands_count != arity) {
+					return false;
+				}
+				if (operands_count > pending) {
+					return false;
+				}
+				pending -= operands_count;
+			} break;
+			default: return false;
+		}
+
+		pending++;
+		if (pending > depth) {
+			depth = pending;
+		}
+	}
+	if (pending != 1) {
+		return false;
+	}
+
+	*expression = (struct serial_expression){
+		.nodes = nodes,
+		.length = length,
+		.depth = depth,
+	};
+
+	return true;
+}
+
+bool serial_expression_evaluate_parallel(
+	const struct serial_expression *expression,
+	const uint64_t *variables,
+	uint64_t *values
+) {
+	assert(expression != NULL && variables != NULL && values != NULL);
+
+	uint64_t *stack = allocator_allocate(expression->depth * sizeof(*stack));
+	if (stack == NULL) {
+		return false;
+	}
+
+	// the operands of an operation come after it, so going backwards their values are on top of
+	// the stack when it's reached, the first operand's last
+	size_t top = 0;
+	for (size_t i = expression->length; i-- > 0;) {
+		const struct serial_node *node = &expression->nodes[i];
+		switch (node->type) {
+			case expression_type_constant: {
+				stack[top++] = node->value != 0 ? UINT64_MAX : 0;
+			} break;
+			case expression_type_variable: {
+				stack[top++] = variables[environment_variable_index((char)node->value)];
+			} break;
+			case expression_type_operation: {
+				size_t operands_count = node->operands_count;
+				const uint64_t *operands = &stack[top - operands_count];
+				uint64_t first = stack[top - 1];
+				uint64_t second = operands_count > 1 ? stack[top - 2] : 0;
+
+				uint64_t value = 0;
+				switch ((enum operation_type)node->value) {
+					case operation_type_conjunction: {
+						value = UINT64_MAX;
+						for (size_t j = 0; j < operands_count; j++) {
+							value &= operands[j];
+						}
+					} break;
+					case operation_type_disjunction: {
+						for (size_t j = 0; j < operands_count; j++) {
+							value |= operands[j];
+						}
+					} break;
+					case operation_type_negation: value = ~first; break;
+					case operation_type_exclusive_disjunction: value = first ^ second; break;
+					case operation_type_biconditional: value = ~(first ^ second); break;
+					case operation_type_alternative_denial: value = ~(first & second); break;
+					case operation_type_joint_denial: value = ~(first | second); break;
+					case operation_type_implication: value = ~first | second; break;
+					default: assert(false);
+				}
+
+				top -= operands_count;
+				stack[top++] = value;
+			} break;
+			default: assert(false);
+		}
+	}
+	assert(top == 1);
+
+	*values = stack[0];
+	allocator_free(stack);
+
+	return true;
+}
+
+// rebuilds the sub-expression whose root is at `index`, which is moved past its nodes, if memory
+// runs out `failed` is set and the sub-expressions it ran out for are replaced with constants
+static struct expression serial_expression_to_expression_(
+	const struct serial_node *nodes,
+	size_t *index,
+	bool *failed
+) {
+	assert(nodes != NULL && index != NULL && failed != NULL);
+
+	const struct serial_node *node = &nodes[(*index)++];
+	switch (node->type) {
+		case expression_type_constant: return expression_constant(node->value != 0);
+		case expression_type_variable: return expression_variable((char)node->value);
+		case expression_type_operation: {
+			size_t operands_count = node->operands_count;
+			struct expression *operands = allocator_allocate(operands_count * sizeof(*operands));
+			if (operands == NULL) {
+				for (size_t pending = operands_count; pending != 0; pending--) {
+					pending += nodes[(*index)++].operands_count;
+				}
+				*failed = true;
+				return expression_constant(false);
+			}
+
+			for (size_t i = 0; i < operands_count; i++) {
+				operands[i] = serial_expression_to_expression_(nodes, index, failed);
+			}
+			return (struct expression){
+				.type = expression_type_operation,
+				.operation = {
+					.type = (enum operation_type)node->value,
+					.operands_count = operands_count,
+					.operands = operands,
+				},
+			};
+		} break;
+		default: assert(false);
+	}
+
+	return expression_constant(false);
+}
+
+bool serial_expression_to_expression(
+	const struct serial_expression *expression,
+	struct expression *result
+) {
+	assert(expression != NULL && expression->length != 0 && result != NULL);
+
+	size_t index = 0;
+	bool failed = false;
+	struct expression rebuilt =
+		serial_expression_to_expression_(expression->nodes, &index, &failed);
+	assert(index == expression->length);
+
+	if (failed) {
+		expression_drop(&rebuilt);
+		return false;
+	}
+
+	*result = rebuilt;
+	return true;
+}
+
+// reads the names of the variables of minterms or implicants, returns their elements, or `NULL` if
+// the buffer doesn't hold `count` of them of `element_size` bytes
+static const void *serial_variables_deserialize_(
+	const void *data,
+	size_t size,
+	enum serial_kind kind,
+	size_t element_size,
+	struct variables *variables
+) {
+	assert(data != NULL && variables != NULL);
+
+	const struct serial_header *header = serial_header_(data, size, kind);
+	if (header == NULL || header->variables_count > VARIABLES_COUNT) {
+		return NULL;
+	}
+
+	size_t variables_count = (size_t)header->variables_count;
+	size_t variables_size = serial_variables_size_(variables_count);
+	size_t payload_size = size - sizeof(*header);
+	if (variables_size > payload_size ||
+		header->count > (payload_size - variables_size) / element_size) {
+		return NULL;
+	}
+
+	const char *names = (const void *)&header[1];
+	struct environment environment = environment_new();
+	for (size_t i = 0; i < variables_count; i++) {
+		if (!isalpha((unsigned char)names[i]) || environment_get_variable(&environment, names[i])) {
+			return NULL;
+		}
+		environment_set_variable(&environment, names[i], true);
+	}
+
+	*variables = variables_new();
+	bool appended = variables_append(variables, names, variables_count);
+	assert(appended);
+	(void)appended;
+
+	return &names[variables_size];
+}
+
+bool minterms_deserialize(const void *data, size_t size, struct minterms *minterms) {
+	assert(data != NULL && minterms != NULL);
+
+	struct variables variables;
+	const uint64_t *elements = serial_variables_deserialize_(
+		data,
+		size,
+		serial_kind_minterms,
+		sizeof(*elements),
+		&variables
+	);
+	if (elements == NULL) {
+		return false;
+	}
+
+	size_t length = (size_t)((const struct serial_header *)data)->count;
+	uint64_t *copy = allocator_allocate((length != 0 ? length : 1) * sizeof(*copy));
+	if (copy == NULL) {
+		variables_drop(&variables);
+		return false;
+	}
+	memcpy(copy, elements, length * sizeof(*copy));
+
+	// minterms beyond the variables would be read out of every table built from them
+	uint64_t outside = 0;
+	for (size_t i = 0; i < length; i++) {
+		outside |= copy[i];
+	}
+	if (variables.length < 64 && (outside >> variables.length) != 0) {
+		allocator_free(copy);
+		variables_drop(&variables);
+		return false;
+	}
+
+	*minterms = (struct minterms){
+		.variables = variables,
+		.data = copy,
+		.length = length,
+	};
+
+	return true;
+}
+
+bool implicants_deserialize(
+	const void *data,
+	size_t size,
+	struct implicants *implicants,
+	struct variables *variables
+) {
+	assert(data != NULL && implicants != NULL && variables != NULL);
+
+	const struct implicant *elements = serial_variables_deserialize_(
+		data,
+		size,
+		serial_kind_implicants,
+		sizeof(*elements),
+		variables
+	);
+	if (elements == NULL) {
+		return false;
+	}
+
+	// implicants beyond the variables would be read out of every table built from them
+	size_t length = (size_t)((const struct serial_header *)data)->count;
+	uint64_t outside = 0;
+	for (size_t i = 0; i < length; i++) {
+		outside |= elements[i].value | elements[i].mask;
+	}
+	if (variables->length < 64 && (outside >> variables->length) != 0) {
+		variables_drop(variables);
+		return false;
+	}
+
+	*implicants = implicants_new();
+	if (!implicants_append(implicants, elements, length)) {
+		variables_drop(variables);
+		return false;
+	}
+
+	return true;
+}
+
+bool serial_map(const char *path, void **data, size_t *size) {
+	assert(path != NULL && data != NULL && size != NULL);
+
+	int file_descriptor = open(path, O_RDONLY);
+	if (file_descriptor == -1) {
+		(void)fprintf(stderr, "Error: failed to open \"%s\": %s\n", path, strerror(errno));
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(file_descriptor, &status) != 0) {
+		(void)fprintf(stderr, "Error: failed to open \"%s\": %s\n", path, strerror(errno));
+		(void)close(file_descriptor);
+		return false;
+	}
+	if (status.st_size <= 0) {
+		(void)fprintf(stderr, "Error: \"%s\" is empty\n", path);
+		(void)close(file_descriptor);
+		return false;
+	}
+
+	void *mapping =
+		mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	int error = errno;
+	(void)close(file_descriptor);
+	if (mapping == MAP_FAILED) {
+		(void)fprintf(stderr, "Error: failed to map \"%s\": %s\n", path, strerror(error));
+		return false;
+	}
+
+	*data = mapping;
+	*size = (size_t)status.st_size;
+
+	return true;
+}
+
+void serial_unmap(void *data, size_t size) {
+	assert(data != NULL);
+
+	(void)munmap(data, size);
+}
@@ -0,0 +1,950 @@
+#include <server.h>
+
+#include <allocator.h>
+#include <assert.h>
+#include <ctype.h>
+#include <environment.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <expression.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <store.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <trace.h>
+#include <unistd.h>
+
+// the length of a frame's payload followed by its type or status
+#define SERVER_HEADER_SIZE ((size_t)5)
+
+#define SERVER_EVENTS_COUNT (64)
+
+// the size connections read in, and the amount of buffered input and output past which a
+// connection stops reading and handling requests until its client catches up
+#define SERVER_BUFFER_SIZE ((size_t)1 << 16)
+
+struct server_connection;
+
+// a request and its response, the buffers of a job are handed between threads, so they are
+// allocated with `malloc()` rather than counted against the usage of either thread
+struct server_job {
+	struct server_connection *connection;
+	size_t index;			 // number of the request, for the trace
+	unsigned char type;		 // type of the request
+	unsigned char status;	 // status of the response
+	char *payload;			 // payload of the request, null-terminated
+	size_t payload_length;	 // length of the payload without the terminator
+	char *response;			 // payload of the response
+	size_t response_length;	 // length of the response
+	size_t response_capacity; // capacity of the response
+	bool failed;			 // whether the response ran out of memory
+	struct server_job *next; // next job of the queue
+};
+
+struct server_queue {
+	struct server_job *head;
+	struct server_job **tail;
+};
+
+struct server_connection {
+	int file_descriptor;
+	uint32_t events;		   // the events the connection is watched for, `0` if it isn't
+	unsigned char *input;	   // received bytes that aren't handled yet
+	size_t input_length;	   // length of the input
+	size_t input_capacity;	   // capacity of the input
+	unsigned char *output;	   // responses that aren't sent yet
+	size_t output_start;	   // position of the first byte of the output that isn't sent
+	size_t output_length;	   // length of the output
+	size_t output_capacity;	   // capacity of the output
+	bool busy;				   // whether a request of the connection is being handled
+	bool ended;				   // whether the client finished sending
+	bool failed;			   // whether the connection broke or sent an invalid frame
+	struct server_connection *previous;
+	struct server_connection *next;
+};
+
+struct server {
+	struct budget budget;
+	struct store *store; // the results of earlier minimizations, or `NULL`
+	pthread_mutex_t mutex; // protects the queues and `stopping`
+	pthread_cond_t condition;
+	struct server_queue pending; // requests waiting for a worker
+	struct server_queue done;	 // responses waiting to be sent
+	bool stopping;
+	int notifier; // event file descriptor the workers wake the loop with
+	int epoll;
+	struct server_connection *connections;
+	size_t requests_count;
+};
+
+struct server_cache_entry {
+	uint64_t hash;
+	unsigned char type;
+	unsigned char status;
+	char *payload;
+	size_t payload_length;
+	char *response;
+	size_t response_length;
+};
+
+static void server_queue_push(struct server_queue *queue, struct server_job *job) {
+	assert(queue != NULL && job != NULL);
+
+	job->next = NULL;
+	*queue->tail = job;
+	queue->tail = &job->next;
+}
+
+static struct server_job *server_queue_pop(struct server_queue *queue) {
+	assert(queue != NULL);
+
+	struct server_job *job = queue->head;
+	if (job != NULL) {
+		queue->head = job->next;
+		if (queue->head == NULL) {
+			queue->tail = &queue->head;
+		}
+	}
+	return job;
+}
+
+static void server_job_drop(struct server_job *job) {
+	assert(job != NULL);
+
+	free(job->payload);
+	free(job->response);
+	free(job);
+}
+
+// reserves `length` more bytes at the end of the response of a job
+static char *server_reserve(struct server_job *job, size_t length) {
+	assert(job != NULL);
+
+	if (job->failed) {
+		return NULL;
+	}
+
+	if (length > job->response_capacity - job->response_length) {
+		size_t capacity = job->response_capacity != 0 ? job->response_capacity : 64;
+		while (length > capacity - job->response_length) {
+			assert(capacity < SIZE_MAX / 2);
+			capacity *= 2;
+		}
+		char *response = realloc(job->response, capacity);
+		if (response == NULL) {
+			job->failed = true;
+			return NULL;
+		}
+		job->response = response;
+		job->response_capacity = capacity;
+	}
+
+	char *reserved = &job->response[job->response_length];
+	job->response_length += length;
+	return reserved;
+}
+
+// appends formatted text to the response of a job
+static void server_printf(
+	struct server_job *job,
+	const char *format,
+	...
+) {
+	assert(job != NULL && format != NULL);
+
+	va_list arguments;
+	va_start(arguments, format);
+	int length = vsnprintf(NULL, 0, format, arguments);
+	va_end(arguments);
+	assert(length >= 0);
+
+	// one more byte for the terminator that `vsnprintf()` writes, which isn't part of the response
+	char *reserved = server_reserve(job, (size_t)length + 1);
+	if (reserved == NULL) {
+		return;
+	}
+	va_start(arguments, format);
+	(void)vsnprintf(reserved, (size_t)length + 1, format, arguments);
+	va_end(arguments);
+	job->response_length--;
+}
+
+static enum server_status server_minimize(
+	struct server_job *job,
+	struct budget budget,
+	struct store *store
+) {
+	assert(job != NULL);
+
+	uint64_t failures = allocator_usage.failures;
+
+	struct minterms minterms;
+	enum minterms_status parsed = minterms_from_string(job->payload, &minterms);
+	if (parsed == minterms_status_invalid) {
+		server_printf(job, "invalid minterms: %s", expression_parse_error());
+		return server_status_error;
+	}
+
+	budget_begin(budget);
+
+	if (parsed == minterms_status_absent) {
+		struct expression expression;
+		if (!expression_from_string_strict(job->payload, &expression)) {
+			(void)budget_end();
+			server_printf(job, "invalid expression: %s", expression_parse_error());
+			return server_status_error;
+		}
+		minterms = minterms_from_expression(&expression);
+		expression_drop(&expression);
+	}
+
+	// without the whole on-set there's nothing to minimize
+	if (budget_exceeded(0)) {
+		server_printf(
+			job,
+			"exceeded the %s budget while enumerating minterms",
+			budget_status_name(budget_end())
+		);
+		minterms_drop(&minterms);
+		return server_status_error;
+	}
+
+	// implicants found in the store are borrowed from its mapping and mustn't be dropped
+	struct implicants prime_implicants;
+	bool stored = store != NULL && store_lookup(store, &minterms, &prime_implicants);
+	if (!stored) {
+		prime_implicants = minterms_to_prime_implicants(&minterms);
+		implicants_minimalize(&prime_implicants, &minterms);
+	}
+
+	enum budget_status status = budget_end();
+
+	// results that fell back to a cheaper cover aren't minimal, so they aren't stored, and a result
+	// that can't be stored is still the answer
+	if (!stored && status == budget_status_within && store != NULL) {
+		(void)store_insert(store, &minterms, &prime_implicants);
+	}
+
+	struct expression minimal_expression =
+		implicants_to_expression(&prime_implicants, &minterms.variables);
+	char *string = expression_to_string(&minimal_expression);
+	if (string != NULL) {
+		server_printf(job, "%s", string);
+	} else {
+		job->failed = true;
+	}
+
+	allocator_free(string);
+	expression_drop(&minimal_expression);
+	if (!stored) {
+		implicants_drop(&prime_implicants);
+	}
+	minterms_drop(&minterms);
+
+	return status == budget_status_within && allocator_usage.failures == failures
+			   ? server_status_ok
+			   : server_status_incomplete;
+}
+
+static enum server_status server_evaluate(struct server_job *job) {
+	assert(job != NULL);
+
+	// the names of the true variables follow the expression's terminator
+	size_t expression_length = strlen(job->payload);
+	const char *names = expression_length < job->payload_length
+							? &job->payload[expression_length + 1]
+							: &job->payload[expression_length];
+	size_t names_length = job->payload_length - (size_t)(names - job->payload);
+
+	struct environment environment = environment_new();
+	for (size_t i = 0; i < names_length; i++) {
+		if (!isalpha((unsigned char)names[i])) {
+			server_printf(job, "invalid variable name at position %zu", i);
+			return server_status_error;
+		}
+		environment_set_variable(&environment, names[i], true);
+	}
+
+	struct expression expression;
+	if (!expression_from_string_strict(job->payload, &expression)) {
+		server_printf(job, "invalid expression: %s", expression_parse_error());
+		return server_status_error;
+	}
+	bool value = expression_evaluate(&expression, &environment);
+	expression_drop(&expression);
+
+	server_printf(job, "%d", value);
+
+	return server_status_ok;
+}
+
+static enum server_status server_truth_table(struct server_job *job) {
+	assert(job != NULL);
+
+	struct expression expression;
+	if (!expression_from_string_strict(job->payload, &expression)) {
+		server_printf(job, "invalid expression: %s", expression_parse_error());
+		return server_status_error;
+	}
+
+	// the table takes a hexadecimal digit per 4 minterms, or a binary one per minterm for fewer
+	struct variables variables = variables_from_expression(&expression);
+	size_t variables_count = variables.length;
+	variables_drop(&variables);
+	if (variables_count > 2 && ((size_t)1 << (variables_count - 2)) > SERVER_PAYLOAD_LIMIT) {
+		server_printf(job, "%zu variables are too many for a truth table", variables_count);
+		expression_drop(&expression);
+		return server_status_error;
+	}
+
+	struct truth_table table = truth_table_from_expression(&expression);
+	expression_drop(&expression);
+	if (table.data == NULL) {
+		truth_table_drop(&table);
+		job->failed = true;
+		return server_status_error;
+	}
+
+	server_printf(job, "f(");
+	for (size_t i = 0; i < table.variables.length; i++) {
+		server_printf(job, i != 0 ? ", %c" : "%c", variables_const_elements(&table.variables)[i]);
+	}
+	server_printf(job, ") = ");
+
+	// the digits are written from the last minterm's down to the first's
+	if (table.variables.length < 2) {
+		size_t digits_count = (size_t)1 << table.variables.length;
+		char *digits = server_reserve(job, 2 + digits_count);
+		if (digits != NULL) {
+			digits[0] = '0';
+			digits[1] = 'b';
+			for (size_t i = 0; i < digits_count; i++) {
+				digits[2 + i] = (table.data[0] >> (digits_count - 1 - i)) & 1 ? '1' : '0';
+			}
+		}
+	} else {
+		size_t digits_count = (size_t)1 << (table.variables.length - 2);
+		char *digits = server_reserve(job, 2 + digits_count);
+		if (digits != NULL) {
+			digits[0] = '0';
+			digits[1] = 'x';
+			for (size_t i = 0; i < digits_count; i++) {
+				size_t digit = digits_count - 1 - i;
+				uint64_t nibble = (table.data[digit / 16] >> (digit % 16 * 4)) & 0xF;
+				digits[2 + i] = "0123456789ABCDEF"[nibble];
+			}
+		}
+	}
+
+	truth_table_drop(&table);
+
+	return server_status_ok;
+}
+
+static uint64_t server_hash(const struct server_job *job) {
+	assert(job != NULL);
+
+	uint64_t hash = UINT64_C(14695981039346656037);
+	hash = (hash ^ job->type) * UINT64_C(1099511628211);
+	for (size_t i = 0; i < job->payload_length; i++) {
+		hash = (hash ^ (unsigned char)job->payload[i]) * UINT64_C(1099511628211);
+	}
+
+	hash ^= hash >> 33;
+	hash *= UINT64_C(0xff51afd7ed558ccd);
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+// handles a request, answering it from the cache of the worker if it was handled before
+static void server_handle(
+	const struct server *server,
+	struct server_cache_entry *cache,
+	struct server_job *job
+) {
+	assert(server != NULL && job != NULL);
+
+	uint64_t hash = server_hash(job);
+	struct server_cache_entry *entry = cache != NULL ? &cache[hash % SERVER_CACHE_SLOTS] : NULL;
+	if (entry != NULL && entry->payload != NULL && entry->hash == hash &&
+		entry->type == job->type && entry->payload_length == job->payload_length &&
+		memcmp(entry->payload, job->payload, job->payload_length) == 0) {
+		char *response = server_reserve(job, entry->response_length);
+		if (response != NULL) {
+			memcpy(response, entry->response, entry->response_length);
+		}
+		job->status = entry->status;
+		return;
+	}
+
+	enum server_status status = server_status_error;
+	switch ((enum server_request)job->type) {
+		case server_request_minimize:
+			status = server_minimize(job, server->budget, server->store);
+			break;
+		case server_request_evaluate: status = server_evaluate(job); break;
+		case server_request_truth_table: status = server_truth_table(job); break;
+		default: server_printf(job, "unknown request type %d", job->type); break;
+	}
+	job->status = (unsigned char)status;
+
+	// results that fell back to a cheaper cover depend on the load, so they aren't cached
+	if (job->failed || status == server_status_incomplete || entry == NULL) {
+		return;
+	}
+
+	char *payload = allocator_allocate(job->payload_length + 1);
+	char *response = allocator_allocate(job->response_length + 1);
+	if (payload == NULL || response == NULL) {
+		allocator_free(payload);
+		allocator_free(response);
+		return;
+	}
+	memcpy(payload, job->payload, job->payload_length);
+	if (job->response_length != 0) {
+		memcpy(response, job->response, job->response_length);
+	}
+
+	allocator_free(entry->payload);
+	allocator_free(entry->response);
+	*entry = (struct server_cache_entry){
+		.hash = hash,
+		.type = job->type,
+		.status = job->status,
+		.payload = payload,
+		.payload_length = job->payload_length,
+		.response = response,
+		.response_length = job->response_length,
+	};
+}
+
+static void *server_work(void *argument) {
+	struct server *server = argument;
+	assert(server != NULL);
+
+	// a worker without a cache still handles requests, just without remembering them
+	struct server_cache_entry *cache =
+		allocator_allocate_zeroed(SERVER_CACHE_SLOTS, sizeof(*cache));
+
+	while (true) {
+		(void)pthread_mutex_lock(&server->mutex);
+		while (server->pending.head == NULL && !server->stopping) {
+			(void)pthread_cond_wait(&server->condition, &server->mutex);
+		}
+		struct server_job *job = !server->stopping ? server_queue_pop(&server->pending) : NULL;
+		(void)pthread_mutex_unlock(&server->mutex);
+
+		if (job == NULL) {
+			break;
+		}
+
+		struct stats_time start = { 0 };
+		if (trace_enabled) {
+			start = stats_time_now();
+		}
+
+		server_handle(server, cache, job);
+		if (job->failed) {
+			free(job->response);
+			job->response = NULL;
+			job->response_length = 0;
+			job->response_capacity = 0;
+			job->status = server_status_error;
+		}
+
+		if (trace_enabled) {
+			trace_span("request", job->index, start, stats_time_now());
+		}
+
+		(void)pthread_mutex_lock(&server->mutex);
+		server_queue_push(&server->done, job);
+		(void)pthread_mutex_unlock(&server->mutex);
+
+		uint64_t one = 1;
+		(void)write(server->notifier, &one, sizeof(one));
+	}
+
+	if (cache != NULL) {
+		for (size_t i = 0; i < SERVER_CACHE_SLOTS; i++) {
+			allocator_free(cache[i].payload);
+			allocator_free(cache[i].response);
+		}
+	}
+	allocator_free(cache);
+
+	stats_merge();
+
+	return NULL;
+}
+
+static bool server_frame_complete(const struct server_connection *connection, size_t *length) {
+	assert(connection != NULL && length != NULL);
+
+	if (connection->input_length < SERVER_HEADER_SIZE) {
+		return false;
+	}
+
+	const unsigned char *header = connection->input;
+	*length = (size_t)header[0] | (size_t)header[1] << 8 | (size_t)header[2] << 16 |
+			  (size_t)header[3] << 24;
+	return connection->input_length - SERVER_HEADER_SIZE >= *length;
+}
+
+// watches a connection for the events it can make progress on
+static void server_watch(struct server *server, struct server_connection *connection) {
+	assert(server != NULL && connection != NULL);
+
+	// a frame longer than the buffer is read whole, unless it's longer than any request may be
+	size_t length = 0;
+	bool complete = server_frame_complete(connection, &length);
+	bool reading = !connection->ended && !connection->failed &&
+				   (connection->input_length < SERVER_BUFFER_SIZE ||
+					(!complete && length <= SERVER_PAYLOAD_LIMIT));
+	bool writing = !connection->failed && connection->output_start != connection->output_length;
+	uint32_t events = (reading ? (uint32_t)EPOLLIN : 0) | (writing ? (uint32_t)EPOLLOUT : 0);
+	if (events == connection->events) {
+		return;
+	}
+
+	// a connection whose client hung up keeps reporting it, so it's removed instead of being
+	// watched for nothing
+	struct epoll_event event = { .events = events, .data.ptr = connection };
+	int operation = connection->events == 0 ? EPOLL_CTL_ADD
+					: events == 0			? EPOLL_CTL_DEL
+											: EPOLL_CTL_MOD;
+	if (epoll_ctl(server->epoll, operation, connection->file_descriptor, &event) == -1) {
+		connection->failed = true;
+	}
+	connection->events = events;
+}
+
+static void server_connection_drop(struct server *server, struct server_connection *connection) {
+	assert(server != NULL && connection != NULL && !connection->busy);
+
+	if (connection->previous != NULL) {
+		connection->previous->next = connection->next;
+	} else {
+		server->connections = connection->next;
+	}
+	if (connection->next != NULL) {
+		connection->next->previous = connection->previous;
+	}
+
+	(void)close(connection->file_descriptor);
+	allocator_free(connection->input);
+	allocator_free(connection->output);
+	allocator_free(connection);
+}
+
+static void server_read(struct server_connection *connection) {
+	assert(connection != NULL);
+
+	while (!connection->ended && !connection->failed) {
+		if (connection->input_capacity - connection->input_length < SERVER_BUFFER_SIZE) {
+			size_t capacity = connection->input_capacity + SERVER_BUFFER_SIZE;
+			unsigned char *input = allocator_reallocate(connection->input, capacity);
+			if (input == NULL) {
+				connection->failed = true;
+				break;
+			}
+			connection->input = input;
+			connection->input_capacity = capacity;
+		}
+
+		ssize_t length = recv(
+			connection->file_descriptor,
+			&connection->input[connection->input_length],
+			connection->input_capacity - connection->input_length,
+			0
+		);
+		if (length > 0) {
+			connection->input_length += (size_t)length;
+			if (connection->input_length >= SERVER_BUFFER_SIZE) {
+				break;
+			}
+		} else if (length == 0) {
+			connection->ended = true;
+		} else if (errno != EINTR) {
+			connection->failed = errno != EAGAIN && errno != EWOULDBLOCK;
+			break;
+		}
+	}
+}
+
+static void server_write(struct server_connection *connection) {
+	assert(connection != NULL);
+
+	while (!connection->failed && connection->output_start != connection->output_length) {
+		ssize_t length = send(
+			connection->file_descriptor,
+			&connection->output[connection->output_start],
+			connection->output_length - connection->output_start,
+			MSG_NOSIGNAL
+		);
+		if (length >= 0) {
+			connection->output_start += (size_t)length;
+		} else if (errno != EINTR) {
+			connection->failed = errno != EAGAIN && errno != EWOULDBLOCK;
+			break;
+		}
+	}
+
+	if (connection->output_start == connection->output_length) {
+		connection->output_start = 0;
+		connection->output_length = 0;
+	}
+}
+
+// hands the next request of a connection to the workers, requests of a connection are handled one
+// at a time so that they are answered in order
+static void server_dispatch(struct server *server, struct server_connection *connection) {
+	assert(server != NULL && connection != NULL);
+
+	size_t length = 0;
+	if (connection->busy || connection->failed ||
+		connection->output_length - connection->output_start >= SERVER_BUFFER_SIZE ||
+		!server_frame_complete(connection, &length)) {
+		if (length > SERVER_PAYLOAD_LIMIT) {
+			connection->failed = true;
+		}
+		return;
+	}
+
+	struct server_job *job = calloc(1, sizeof(*job));
+	char *payload = malloc(length + 1);
+	if (job == NULL || payload == NULL) {
+		free(job);
+		free(payload);
+		connection->failed = true;
+		return;
+	}
+	memcpy(payload, &connection->input[SERVER_HEADER_SIZE], length);
+	payload[length] = '\0';
+
+	job->connection = connection;
+	job->index = server->requests_count++;
+	job->type = connection->input[4];
+	job->payload = payload;
+	job->payload_length = length;
+
+	connection->input_length -= SERVER_HEADER_SIZE + length;
+	memmove(
+		connection->input,
+		&connection->input[SERVER_HEADER_SIZE + length],
+		connection->input_length
+	);
+	connection->busy = true;
+
+	(void)pthread_mutex_lock(&server->mutex);
+	server_queue_push(&server->pending, job);
+	(void)pthread_cond_signal(&server->condition);
+	(void)pthread_mutex_unlock(&server->mutex);
+}
+
+// queues the response of a job on its connection
+static void server_respond(struct server_connection *connection, const struct server_job *job) {
+	assert(connection != NULL && job != NULL);
+
+	size_t length = SERVER_HEADER_SIZE + job->response_length;
+	if (length > connection->output_capacity - connection->output_length) {
+		size_t capacity = connection->output_length + length;
+		unsigned char *output = allocator_reallocate(connection->output, capacity);
+		if (output == NULL) {
+			connection->failed = true;
+			return;
+		}
+		connection->output = output;
+		connection->output_capacity = capacity;
+	}
+
+	unsigned char *header = &connection->output[connection->output_length];
+	header[0] = (unsigned char)job->response_length;
+	header[1] = (unsigned char)(job->response_length >> 8);
+	header[2] = (unsigned char)(job->response_length >> 16);
+	header[3] = (unsigned char)(job->response_length >> 24);
+	header[4] = job->status;
+	if (job->response_length != 0) {
+		memcpy(&header[SERVER_HEADER_SIZE], job->response, job->response_length);
+	}
+	connection->output_length += length;
+}
+
+// makes as much progress on a connection as possible, and drops it once it's finished
+static void server_update(struct server *server, struct server_connection *connection) {
+	assert(server != NULL && connection != NULL);
+
+	server_write(connection);
+	server_dispatch(server, connection);
+	server_watch(server, connection);
+
+	// a client that finished sending is answered before its connection is closed
+	size_t length = 0;
+	bool finished = connection->failed ||
+					(connection->ended && connection->output_length == 0 &&
+					 !server_frame_complete(connection, &length));
+	if (finished && !connection->busy) {
+		server_connection_drop(server, connection);
+	}
+}
+
+static void server_accept(struct server *server, int listener) {
+	assert(server != NULL);
+
+	while (true) {
+		int file_descriptor = accept(listener, NULL, NULL);
+		if (file_descriptor != -1 && (fcntl(file_descriptor, F_SETFL, O_NONBLOCK) == -1 ||
+									  fcntl(file_descriptor, F_SETFD, FD_CLOEXEC) == -1)) {
+			(void)close(file_descriptor);
+			file_descriptor = -1;
+		}
+		if (file_descriptor == -1) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				(void)fprintf(
+					stderr,
+					"Warning: failed to accept a connection: %s\n",
+					strerror(errno)
+				);
+			}
+			if (errno != EINTR) {
+				break;
+			}
+			continue;
+		}
+
+		struct server_connection *connection =
+			allocator_allocate_zeroed(1, sizeof(*connection));
+		if (connection == NULL) {
+			(void)close(file_descriptor);
+			continue;
+		}
+		connection->file_descriptor = file_descriptor;
+		connection->next = server->connections;
+		if (server->connections != NULL) {
+			server->connections->previous = connection;
+		}
+		server->connections = connection;
+
+		server_update(server, connection);
+	}
+}
+
+// sends the responses the workers finished
+static void server_complete(struct server *server) {
+	assert(server != NULL);
+
+	uint64_t count = 0;
+	(void)read(server->notifier, &count, sizeof(count));
+
+	(void)pthread_mutex_lock(&server->mutex);
+	struct server_job *jobs = server->done.head;
+	server->done.head = NULL;
+	server->done.tail = &server->done.head;
+	(void)pthread_mutex_unlock(&server->mutex);
+
+	while (jobs != NULL) {
+		struct server_job *job = jobs;
+		jobs = job->next;
+
+		struct server_connection *connection = job->connection;
+		connection->busy = false;
+		if (!connection->failed) {
+			server_respond(connection, job);
+		}
+		server_job_drop(job);
+
+		server_update(server, connection);
+	}
+}
+
+static int server_listen(const char *path) {
+	assert(path != NULL);
+
+	struct sockaddr_un address = { .sun_family = AF_UNIX };
+	size_t path_length = strlen(path);
+	if (path_length >= sizeof(address.sun_path)) {
+		(void)fprintf(stderr, "Error: socket path \"%s\" is too long\n", path);
+		return -1;
+	}
+	memcpy(address.sun_path, path, path_length + 1);
+
+	// a socket left behind by a server that didn't shut down cleanly is replaced
+	struct stat status;
+	if (lstat(path, &status) == 0 && S_ISSOCK(status.st_mode)) {
+		(void)unlink(path);
+	}
+
+	int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (listener == -1 ||
+		bind(listener, (const struct sockaddr *)&address, sizeof(address)) == -1 ||
+		listen(listener, SOMAXCONN) == -1) {
+		(void)fprintf(stderr, "Error: failed to listen on \"%s\": %s\n", path, strerror(errno));
+		if (listener != -1) {
+			(void)close(listener);
+		}
+		return -1;
+	}
+
+	return listener;
+}
+
+bool server_run(
+	const char *path,
+	size_t workers_count,
+	struct budget budget,
+	struct store *store
+) {
+	assert(path != NULL && workers_count != 0);
+
+	int listener = server_listen(path);
+	if (listener == -1) {
+		return false;
+	}
+
+	// the signals that stop the server are received through the loop, the workers inherit the
+	// mask so that they never handle them
+	sigset_t signals;
+	sigset_t previous_signals;
+	(void)sigemptyset(&signals);
+	(void)sigaddset(&signals, SIGINT);
+	(void)sigaddset(&signals, SIGTERM);
+	(void)pthread_sigmask(SIG_BLOCK, &signals, &previous_signals);
+
+	struct server server = {
+		.budget = budget,
+		.store = store,
+		.mutex = PTHREAD_MUTEX_INITIALIZER,
+		.condition = PTHREAD_COND_INITIALIZER,
+		.pending = { .head = NULL, .tail = &server.pending.head },
+		.done = { .head = NULL, .tail = &server.done.head },
+		.stopping = false,
+		.notifier = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC),
+		.epoll = epoll_create1(EPOLL_CLOEXEC),
+		.connections = NULL,
+		.requests_count = 0,
+	};
+	int signals_file_descriptor = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+	// the listener, the signals and the notifier are told apart from the connections by their
+	// addresses
+	struct epoll_event listener_event = { .events = EPOLLIN, .data.ptr = &listener };
+	struct epoll_event signals_event = { .events = EPOLLIN, .data.ptr = &signals_file_descriptor };
+	struct epoll_event notifier_event = { .events = EPOLLIN, .data.ptr = &server.notifier };
+	pthread_t *workers = allocator_allocate_zeroed(workers_count, sizeof(*workers));
+	bool started = server.notifier != -1 && server.epoll != -1 && signals_file_descriptor != -1 &&
+				   workers != NULL &&
+				   epoll_ctl(server.epoll, EPOLL_CTL_ADD, listener, &listener_event) == 0 &&
+				   epoll_ctl(
+					   server.epoll,
+					   EPOLL_CTL_ADD,
+					   signals_file_descriptor,
+					   &signals_event
+				   ) == 0 &&
+				   epoll_ctl(server.epoll, EPOLL_CTL_ADD, server.notifier, &notifier_event) == 0;
+	if (!started) {
+		(void)fprintf(stderr, "Error: failed to start server: %s\n", strerror(errno));
+	}
+
+	size_t started_count = 0;
+	while (started && started_count < workers_count) {
+		int error = pthread_create(&workers[started_count], NULL, server_work, &server);
+		if (error != 0) {
+			(void)fprintf(stderr, "Error: failed to start worker: %s\n", strerror(error));
+			started = false;
+			break;
+		}
+		started_count++;
+	}
+
+	bool running = started;
+	while (running) {
+		// responses are sent after the batch's other events, as sending one may drop a connection
+		// that has an event later in the batch
+		bool completed = false;
+		struct epoll_event events[SERVER_EVENTS_COUNT];
+		int events_count = epoll_wait(server.epoll, events, SERVER_EVENTS_COUNT, -1);
+		if (events_count == -1) {
+			if (errno != EINTR) {
+				(void)fprintf(stderr, "Error: failed to wait for events: %s\n", strerror(errno));
+				running = false;
+			}
+			continue;
+		}
+
+		for (int i = 0; i < events_count; i++) {
+			void *source = events[i].data.ptr;
+			if (source == &listener) {
+				server_accept(&server, listener);
+			} else if (source == &signals_file_descriptor) {
+				// the signal is consumed, otherwise it would be delivered once the mask is restored
+				struct signalfd_siginfo information;
+				(void)read(signals_file_descriptor, &information, sizeof(information));
+				running = false;
+			} else if (source == &server.notifier) {
+				completed = true;
+			} else {
+				struct server_connection *connection = source;
+				if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+					server_read(connection);
+				}
+				server_update(&server, connection);
+			}
+		}
+		if (completed) {
+			server_complete(&server);
+		}
+	}
+
+	// the workers finish the requests they are handling before they stop, the requests that no
+	// worker took yet are dropped
+	(void)pthread_mutex_lock(&server.mutex);
+	server.stopping = true;
+	(void)pthread_cond_broadcast(&server.condition);
+	(void)pthread_mutex_unlock(&server.mutex);
+	for (size_t i = 0; i < started_count; i++) {
+		(void)pthread_join(workers[i], NULL);
+	}
+	allocator_free(workers);
+
+	struct server_job *job = NULL;
+	while ((job = server_queue_pop(&server.pending)) != NULL) {
+		server_job_drop(job);
+	}
+	while ((job = server_queue_pop(&server.done)) != NULL) {
+		server_job_drop(job);
+	}
+	while (server.connections != NULL) {
+		server.connections->busy = false;
+		server_connection_drop(&server, server.connections);
+	}
+
+	if (signals_file_descriptor != -1) {
+		(void)close(signals_file_descriptor);
+	}
+	if (server.epoll != -1) {
+		(void)close(server.epoll);
+	}
+	if (server.notifier != -1) {
+		(void)close(server.notifier);
+	}
+	(void)close(listener);
+	(void)unlink(path);
+
+	// a signal that arrived while the server was stopping is dropped as well, the server is already
+	// doing what it asked for
+	const struct timespec timeout = { .tv_sec = 0, .tv_nsec = 0 };
+	while (sigtimedwait(&signals, NULL, &timeout) != -1) {}
+	(void)pthread_sigmask(SIG_SETMASK, &previous_signals, NULL);
+
+	return started;
+}
@@ -0,0 +1,273 @@
+#include <simulation.h>
+
+#include <allocator.h>
+#include <assert.h>
+#include <ctype.h>
+#include <environment.h>
+#include <expression_pool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIMULATION_BLOCK_VECTORS (64 * SIMULATION_BLOCK_WORDS)
+
+struct simulation {
+	struct expression_pool pool;
+	size_t columns[VARIABLES_COUNT]; // variable index of every column, or `VARIABLES_COUNT`
+	size_t columns_count;
+	// a run of `SIMULATION_BLOCK_WORDS` words per variable, and a spare one for ignored columns
+	uint64_t *block;
+	size_t block_length;  // number of vectors in the block
+	char *output;		  // the results of a block as lines
+	size_t line_number;
+	size_t vectors_count; // number of vectors simulated so far
+	FILE *results;
+};
+
+static void simulation_error(const struct simulation *simulation, const char *message) {
+	assert(simulation != NULL && message != NULL);
+
+	(void)fprintf(stderr, "Error: line %zu of vectors: %s\n", simulation->line_number, message);
+}
+
+// evaluates the vectors of the block and writes their results
+static bool simulation_flush(struct simulation *simulation) {
+	assert(simulation != NULL);
+
+	if (simulation->block_length == 0) {
+		return true;
+	}
+
+	uint64_t values[SIMULATION_BLOCK_WORDS];
+	if (!expression_pool_evaluate_block(
+			&simulation->pool,
+			simulation->block,
+			SIMULATION_BLOCK_WORDS,
+			values
+		)) {
+		simulation_error(simulation, "out of memory");
+		return false;
+	}
+
+	for (size_t i = 0; i < simulation->block_length; i++) {
+		simulation->output[2 * i] = (char)('0' + ((values[i / 64] >> (i % 64)) & 1U));
+		simulation->output[2 * i + 1] = '\n';
+	}
+	if (fwrite(simulation->output, 2, simulation->block_length, simulation->results) !=
+		simulation->block_length) {
+		(void)fprintf(stderr, "Error: failed to write results\n");
+		return false;
+	}
+
+	// only the runs of the columns are ever set
+	for (size_t i = 0; i < simulation->columns_count; i++) {
+		memset(
+			&simulation->block[simulation->columns[i] * SIMULATION_BLOCK_WORDS],
+			0,
+			SIMULATION_BLOCK_WORDS * sizeof(*simulation->block)
+		);
+	}
+
+	simulation->vectors_count += simulation->block_length;
+	simulation->block_length = 0;
+
+	return true;
+}
+
+// names the columns after a `.inputs` header, which must name every variable of the expression
+static bool simulation_read_header(
+	struct simulation *simulation,
+	char *names,
+	const struct environment *variables
+) {
+	assert(simulation != NULL && names != NULL && variables != NULL);
+
+	struct environment named = environment_new();
+	simulation->columns_count = 0;
+
+	char *state = NULL;
+	for (char *name = strtok_r(names, " \t\r\n", &state); name != NULL;
+		 name = strtok_r(NULL, " \t\r\n", &state)) {
+		if (!isalpha((unsigned char)name[0]) || name[1] != '\0' ||
+			environment_get_variable(&named, name[0])) {
+			simulation_error(simulation, "invalid input name");
+			return false;
+		}
+		environment_set_variable(&named, name[0], true);
+
+		size_t index = environment_variable_index(name[0]);
+		simulation->columns[simulation->columns_count++] =
+			environment_get_variable(variables, name[0]) ? index : VARIABLES_COUNT;
+	}
+
+	if ((variables->variables & ~named.variables) != 0) {
+		simulation_error(simulation, "missing a column for a variable of the expression");
+		return false;
+	}
+
+	return true;
+}
+
+// adds a vector to the block
+static bool simulation_read_vector(struct simulation *simulation, const char *line) {
+	assert(simulation != NULL && line != NULL);
+
+	// this runs once per vector, so blanks are matched directly rather than with `isspace()` and
+	// ignored columns are written to a spare run rather than branched over
+	uint64_t *words = &simulation->block[simulation->block_length / 64];
+	unsigned shift = (unsigned)(simulation->block_length % 64);
+	for (size_t i = 0; i < simulation->columns_count; i++) {
+		while (*line == ' ' || *line == '\t') {
+			line++;
+		}
+		uint64_t value = (uint64_t)(unsigned char)*line++ - '0';
+		if (value > 1) {
+			simulation_error(simulation, "invalid column");
+			return false;
+		}
+		words[simulation->columns[i] * SIMULATION_BLOCK_WORDS] |= value << shift;
+	}
+	while (*line == ' ' || *line == '\t' || *line == '\r') {
+		line++;
+	}
+	if (*line != '\0' && *line != '#') {
+		simulation_error(simulation, "trailing columns");
+		return false;
+	}
+
+	if (++simulation->block_length == SIMULATION_BLOCK_VECTORS) {
+		return simulation_flush(simulation);
+	}
+	return true;
+}
+
+// handles a line of the vectors, either the header or a vector
+static bool simulation_read_line(
+	struct simulation *simulation,
+	char *line,
+	const struct environment *variables
+) {
+	assert(simulation != NULL && line != NULL && variables != NULL);
+
+	simulation->line_number++;
+
+	while (*line == ' ' || *line == '\t') {
+		line++;
+	}
+	if (*line == '0' || *line == '1') {
+		return simulation_read_vector(simulation, line);
+	}
+
+	char *comment = strchr(line, '#');
+	if (comment != NULL) {
+		*comment = '\0';
+	}
+	while (isspace((unsigned char)*line)) {
+		line++;
+	}
+	if (*line == '\0') {
+		return true;
+	}
+
+	if (strncmp(line, ".inputs", 7) == 0 && (line[7] == '\0' || isspace((unsigned char)line[7]))) {
+		if (simulation->vectors_count != 0 || simulation->block_length != 0) {
+			simulation_error(simulation, "header after the first vector");
+			return false;
+		}
+		return simulation_read_header(simulation, &line[7], variables);
+	}
+
+	simulation_error(simulation, "invalid column");
+	return false;
+}
+
+bool simulation_run(const struct expression *expression, FILE *vectors, FILE *results) {
+	assert(expression != NULL && vectors != NULL && results != NULL);
+
+	struct simulation simulation = {
+		.pool = expression_pool_from_expression(expression),
+		.columns_count = 0,
+		.block = allocator_allocate_zeroed(
+			(size_t)(VARIABLES_COUNT + 1) * SIMULATION_BLOCK_WORDS,
+			sizeof(*simulation.block)
+		),
+		.block_length = 0,
+		.output = allocator_allocate(2 * SIMULATION_BLOCK_VECTORS),
+		.line_number = 0,
+		.vectors_count = 0,
+		.results = results,
+	};
+
+	// the columns default to the variables of the expression
+	struct environment variables = environment_new();
+	struct variables names = variables_from_expression(expression);
+	const char *elements = variables_const_elements(&names);
+	for (size_t i = 0; i < names.length; i++) {
+		environment_set_variable(&variables, elements[i], true);
+		simulation.columns[simulation.columns_count++] = environment_variable_index(elements[i]);
+	}
+
+	bool simulated =
+		simulation.pool.length != 0 && simulation.block != NULL && simulation.output != NULL;
+	if (!simulated) {
+		simulation_error(&simulation, "out of memory");
+	}
+	variables_drop(&names);
+
+	// the vectors are read in large chunks and split into lines in place, as reading them line by
+	// line would cost more than simulating them
+	size_t buffer_capacity = (size_t)1 << 20;
+	char *buffer = allocator_allocate(buffer_capacity);
+	size_t buffer_length = 0;
+	if (buffer == NULL) {
+		simulation_error(&simulation, "out of memory");
+		simulated = false;
+	}
+	while (simulated) {
+		// a line that doesn't fit in the buffer makes it grow, one byte is kept for a terminator
+		if (buffer_length + 1 == buffer_capacity) {
+			char *grown = allocator_reallocate(buffer, 2 * buffer_capacity);
+			if (grown == NULL) {
+				simulation_error(&simulation, "out of memory");
+				simulated = false;
+				break;
+			}
+			buffer = grown;
+			buffer_capacity *= 2;
+		}
+
+		size_t read =
+			fread(&buffer[buffer_length], 1, buffer_capacity - buffer_length - 1, vectors);
+		buffer_length += read;
+
+		char *line = buffer;
+		char *limit = &buffer[buffer_length];
+		for (char *newline = NULL;
+			 simulated && (newline = memchr(line, '\n', (size_t)(limit - line))) != NULL;
+			 line = newline + 1) {
+			*newline = '\0';
+			simulated = simulation_read_line(&simulation, line, &variables);
+		}
+
+		if (read == 0) {
+			// the last line may lack a newline
+			if (simulated && line != limit) {
+				*limit = '\0';
+				simulated = simulation_read_line(&simulation, line, &variables);
+			}
+			break;
+		}
+
+		buffer_length = (size_t)(limit - line);
+		memmove(buffer, line, buffer_length);
+	}
+	allocator_free(buffer);
+
+	simulated = simulated && simulation_flush(&simulation);
+
+	expression_pool_drop(&simulation.pool);
+	allocator_free(simulation.block);
+	allocator_free(simulation.output);
+
+	return simulated;
+}
@@ -0,0 +1,274 @@
+#include <stats.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <trace.h>
+
+bool stats_enabled = false;
+
+static const char *const stats_stage_names[STATS_STAGES_COUNT] = {
+	[stats_stage_parse] = "parse",
+	[stats_stage_enumeration] = "enumeration",
+	[stats_stage_prime_implicants] = "prime_implicants",
+	[stats_stage_minimalize] = "minimalize",
+	[stats_stage_output] = "output",
+};
+
+_Thread_local struct stats stats = {
+	.passes = NULL,
+	.passes_length = 0,
+	.passes_capacity = 0,
+	.duplicates = 0,
+	.allocations = 0,
+	.stage = STATS_STAGES_COUNT,
+};
+
+// the counters of the threads that finished, which are shared between threads, so their passes are
+// allocated with the C standard library, the usage of the allocator being tracked per thread
+static struct stats stats_totals = {
+	.passes = NULL,
+	.passes_length = 0,
+	.passes_capacity = 0,
+	.duplicates = 0,
+	.allocations = 0,
+	.stage = STATS_STAGES_COUNT,
+};
+static size_t stats_totals_peak_bytes = 0;
+static uint64_t stats_totals_failures = 0;
+static pthread_mutex_t stats_totals_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static double stats_seconds(clockid_t clock) {
+	struct timespec time;
+	if (clock_gettime(clock, &time) != 0) {
+		return 0.0;
+	}
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+struct stats_time stats_time_now(void) {
+	return (struct stats_time){
+		.wall = stats_seconds(CLOCK_MONOTONIC),
+		.cpu = stats_seconds(CLOCK_THREAD_CPUTIME_ID),
+	};
+}
+
+void stats_end(struct stats_span span) {
+	if (!stats_enabled) {
+		return;
+	}
+
+	struct stats_time now = stats_time_now();
+
+	struct stats_stage_counters *counters = &stats.stages[span.stage];
+	counters->calls++;
+	counters->time.wall += now.wall - span.start.wall;
+	counters->time.cpu += now.cpu - span.start.cpu;
+	counters->bytes += (int64_t)allocator_usage.bytes - (int64_t)span.bytes;
+
+	trace_span(stats_stage_names[span.stage], counters->calls - 1, span.start, now);
+
+	stats.stage = span.parent;
+}
+
+void stats_end_pass(
+	struct stats_span span,
+	size_t pass,
+	size_t implicants,
+	size_t combined,
+	size_t primes
+) {
+	if (!stats_enabled) {
+		return;
+	}
+
+	struct stats_time now = stats_time_now();
+
+	trace_span("pass", pass, span.start, now);
+
+	if (pass >= stats.passes_length) {
+		if (pass >= stats.passes_capacity) {
+			size_t capacity = stats.passes_capacity == 0 ? 8 : 2 * stats.passes_capacity;
+			while (capacity <= pass) {
+				capacity *= 2;
+			}
+			struct stats_pass *passes =
+				allocator_reallocate(stats.passes, capacity * sizeof(*passes));
+			if (passes == NULL) {
+				return;
+			}
+			stats.passes = passes;
+			stats.passes_capacity = capacity;
+		}
+		while (stats.passes_length <= pass) {
+			stats.passes[stats.passes_length++] = (struct stats_pass){ 0 };
+		}
+	}
+
+	struct stats_pass *counters = &stats.passes[pass];
+	counters->time.wall += now.wall - span.start.wall;
+	counters->time.cpu += now.cpu - span.start.cpu;
+	counters->implicants += implicants;
+	counters->combined += combined;
+	counters->primes += primes;
+}
+
+// adds the counters of a stage or a pass to others
+static void stats_add_stage_(
+	struct stats_stage_counters *counters,
+	const struct stats_stage_counters *other
+) {
+	counters->calls += other->calls;
+	counters->time.wall += other->time.wall;
+	counters->time.cpu += other->time.cpu;
+	counters->allocations += other->allocations;
+	counters->bytes += other->bytes;
+	if (other->peak_bytes > counters->peak_bytes) {
+		counters->peak_bytes = other->peak_bytes;
+	}
+}
+static void stats_add_pass_(struct stats_pass *counters, const struct stats_pass *other) {
+	counters->time.wall += other->time.wall;
+	counters->time.cpu += other->time.cpu;
+	counters->implicants += other->implicants;
+	counters->combined += other->combined;
+	counters->primes += other->primes;
+}
+
+void stats_merge(void) {
+	if (stats_enabled) {
+		(void)pthread_mutex_lock(&stats_totals_mutex);
+
+		for (size_t i = 0; i < STATS_STAGES_COUNT; i++) {
+			stats_add_stage_(&stats_totals.stages[i], &stats.stages[i]);
+		}
+
+		// if the totals can't hold the thread's passes, the passes they can't hold are left out
+		if (stats.passes_length > stats_totals.passes_capacity) {
+			struct stats_pass *passes =
+				realloc(stats_totals.passes, stats.passes_length * sizeof(*passes));
+			if (passes != NULL) {
+				stats_totals.passes = passes;
+				stats_totals.passes_capacity = stats.passes_length;
+			}
+		}
+		while (stats_totals.passes_length < stats.passes_length &&
+			   stats_totals.passes_length < stats_totals.passes_capacity) {
+			stats_totals.passes[stats_totals.passes_length++] = (struct stats_pass){ 0 };
+		}
+		for (size_t i = 0; i < stats.passes_length && i < stats_totals.passes_length; i++) {
+			stats_add_pass_(&stats_totals.passes[i], &stats.passes[i]);
+		}
+
+		stats_totals.duplicates += stats.duplicates;
+		stats_totals.allocations += stats.allocations;
+		if (allocator_usage.peak_bytes > stats_totals_peak_bytes) {
+			stats_totals_peak_bytes = allocator_usage.peak_bytes;
+		}
+		stats_totals_failures += allocator_usage.failures;
+
+		(void)pthread_mutex_unlock(&stats_totals_mutex);
+	}
+
+	allocator_free(stats.passes);
+
+	stats = (struct stats){
+		.passes = NULL,
+		.passes_length = 0,
+		.passes_capacity = 0,
+		.duplicates = 0,
+		.allocations = 0,
+		.stage = STATS_STAGES_COUNT,
+	};
+}
+
+void stats_print(FILE *file) {
+	assert(file != NULL);
+
+	(void)pthread_mutex_lock(&stats_totals_mutex);
+
+	(void)fprintf(file, "{\"stages\":{");
+	for (size_t i = 0; i < STATS_STAGES_COUNT; i++) {
+		struct stats_stage_counters counters = stats_totals.stages[i];
+		stats_add_stage_(&counters, &stats.stages[i]);
+		(void)fprintf(
+			file,
+			"%s\"%s\":{\"calls\":%" PRIu64 ",\"wall_seconds\":%.9f,\"cpu_seconds\":%.9f,"
+			"\"allocations\":%" PRIu64 ",\"bytes\":%" PRId64 ",\"peak_bytes\":%zu}",
+			i == 0 ? "" : ",",
+			stats_stage_names[i],
+			counters.calls,
+			counters.time.wall,
+			counters.time.cpu,
+			counters.allocations,
+			counters.bytes,
+			counters.peak_bytes
+		);
+	}
+	(void)fprintf(file, "},\"prime_implicants_passes\":[");
+	size_t passes_length = stats.passes_length > stats_totals.passes_length
+							   ? stats.passes_length
+							   : stats_totals.passes_length;
+	for (size_t i = 0; i < passes_length; i++) {
+		struct stats_pass counters = { 0 };
+		if (i < stats_totals.passes_length) {
+			stats_add_pass_(&counters, &stats_totals.passes[i]);
+		}
+		if (i < stats.passes_length) {
+			stats_add_pass_(&counters, &stats.passes[i]);
+		}
+		(void)fprintf(
+			file,
+			"%s{\"wall_seconds\":%.9f,\"cpu_seconds\":%.9f,\"implicants\":%" PRIu64
+			",\"combined\":%" PRIu64 ",\"primes\":%" PRIu64 "}",
+			i == 0 ? "" : ",",
+			counters.time.wall,
+			counters.time.cpu,
+			counters.implicants,
+			counters.combined,
+			counters.primes
+		);
+	}
+	(void)fprintf(
+		file,
+		"],\"duplicates_rejected\":%" PRIu64 ",\"allocations\":%" PRIu64
+		",\"bytes\":%zu,\"peak_bytes\":%zu,\"allocation_failures\":%" PRIu64 "}\n",
+		stats_totals.duplicates + stats.duplicates,
+		stats_totals.allocations + stats.allocations,
+		allocator_usage.bytes,
+		allocator_usage.peak_bytes > stats_totals_peak_bytes ? allocator_usage.peak_bytes
+															 : stats_totals_peak_bytes,
+		stats_totals_failures + allocator_usage.failures
+	);
+
+	(void)pthread_mutex_unlock(&stats_totals_mutex);
+}
+
+void stats_drop(void) {
+	allocator_free(stats.passes);
+
+	stats = (struct stats){
+		.passes = NULL,
+		.passes_length = 0,
+		.passes_capacity = 0,
+		.duplicates = 0,
+		.allocations = 0,
+		.stage = STATS_STAGES_COUNT,
+	};
+
+	(void)pthread_mutex_lock(&stats_totals_mutex);
+	free(stats_totals.passes);
+	stats_totals = (struct stats){
+		.passes = NULL,
+		.passes_length = 0,
+		.passes_capacity = 0,
+		.duplicates = 0,
+		.allocations = 0,
+		.stage = STATS_STAGES_COUNT,
+	};
+	stats_totals_peak_bytes = 0;
+	stats_totals_failures = 0;
+	(void)pthread_mutex_unlock(&stats_totals_mutex);
+}
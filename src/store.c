@@ -0,0 +1,387 @@
+#include <store.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define STORE_MAGIC "DGLSTORE"
+#define STORE_VERSION (1)
+#define STORE_BUCKETS_COUNT (4096)
+
+struct store_header {
+	char magic[sizeof(STORE_MAGIC) - 1];
+	uint32_t version;
+	uint32_t buckets_count;
+	uint64_t length; ///< Number of bytes of the file that are occupied by records.
+	uint64_t buckets[STORE_BUCKETS_COUNT]; ///< Offsets of the last record inserted in each bucket.
+};
+
+// a record is followed by its minterms and then by its implicants
+struct store_record {
+	uint64_t hash;
+	uint64_t next; ///< Offset of the previous record in the same bucket, or zero.
+	uint64_t variables_count;
+	uint64_t minterms_count;
+	uint64_t implicants_count;
+};
+
+static uint64_t store_hash(const struct minterms *minterms) {
+	assert(minterms != NULL);
+
+	// FNV-1a over 64-bit words followed by a final avalanche, so that consecutive minterms spread
+	// over all the buckets
+	uint64_t hash = UINT64_C(14695981039346656037);
+	hash = (hash ^ minterms->variables.length) * UINT64_C(1099511628211);
+	for (size_t i = 0; i < minterms->length; i++) {
+		hash = (hash ^ minterms->data[i]) * UINT64_C(1099511628211);
+	}
+
+	hash ^= hash >> 33;
+	hash *= UINT64_C(0xff51afd7ed558ccd);
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+// returns the latest mapping of the store
+static void store_mapping(struct store *store, unsigned char **data, size_t *size) {
+	assert(store != NULL && data != NULL && size != NULL);
+
+	(void)pthread_mutex_lock(&store->mapping_mutex);
+	*data = store->data;
+	*size = store->size;
+	(void)pthread_mutex_unlock(&store->mapping_mutex);
+}
+
+// maps the whole file if it outgrew the latest mapping, which is then returned, the earlier mapping
+// is retired rather than unmapped, as other threads may still be reading from it
+static bool store_map(struct store *store, unsigned char **data, size_t *size) {
+	assert(store != NULL && data != NULL && size != NULL);
+
+	(void)pthread_mutex_lock(&store->mapping_mutex);
+
+	// if another thread already mapped all of the file, its mapping is returned
+	struct stat status;
+	bool mapped = fstat(store->file_descriptor, &status) == 0;
+	if (mapped && (size_t)status.st_size < sizeof(struct store_header)) {
+		errno = EINVAL;
+		mapped = false;
+	} else if (mapped && (size_t)status.st_size > store->size) {
+		// room to retire the latest mapping is made first, so that failing leaves it as it was, the
+		// mappings are shared between threads, so they are tracked with the C standard library
+		bool retirable = store->data == NULL;
+		if (!retirable) {
+			struct store_mapping *retired =
+				realloc(store->retired, (store->retired_length + 1) * sizeof(*store->retired));
+			if (retired != NULL) {
+				store->retired = retired;
+				retirable = true;
+			}
+		}
+
+		void *mapping = MAP_FAILED;
+		if (retirable) {
+			mapping = mmap(
+				NULL,
+				(size_t)status.st_size,
+				PROT_READ | (store->writable ? PROT_WRITE : 0),
+				MAP_SHARED,
+				store->file_descriptor,
+				0
+			);
+		}
+		if (mapping != MAP_FAILED) {
+			if (store->data != NULL) {
+				store->retired[store->retired_length++] = (struct store_mapping){
+					.data = store->data,
+					.size = store->size,
+				};
+			}
+			store->data = mapping;
+			store->size = (size_t)status.st_size;
+		}
+		mapped = mapping != MAP_FAILED;
+	}
+
+	*data = store->data;
+	*size = store->size;
+
+	(void)pthread_mutex_unlock(&store->mapping_mutex);
+
+	return mapped;
+}
+
+static bool store_initialize(struct store *store) {
+	assert(store != NULL && store->writable);
+
+	struct stat status;
+	if (fstat(store->file_descriptor, &status) != 0) {
+		return false;
+	}
+	if (status.st_size != 0) {
+		return true;
+	}
+
+	unsigned char *data = NULL;
+	size_t size = 0;
+	if (ftruncate(store->file_descriptor, (off_t)sizeof(struct store_header)) != 0 ||
+		!store_map(store, &data, &size)) {
+		return false;
+	}
+
+	struct store_header *header = (void *)data;
+	header->version = STORE_VERSION;
+	header->buckets_count = STORE_BUCKETS_COUNT;
+	__atomic_store_n(&header->length, sizeof(*header), __ATOMIC_RELEASE);
+	memcpy(header->magic, STORE_MAGIC, sizeof(header->magic));
+
+	return true;
+}
+
+bool store_open(struct store *store, const char *path, bool writable) {
+	assert(store != NULL && path != NULL);
+
+	*store = (struct store){
+		.file_descriptor = -1,
+		.writable = writable,
+		.data = NULL,
+		.size = 0,
+		.retired = NULL,
+		.retired_length = 0,
+		.mapping_mutex = PTHREAD_MUTEX_INITIALIZER,
+		.insert_mutex = PTHREAD_MUTEX_INITIALIZER,
+	};
+
+	store->file_descriptor = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+	if (store->file_descriptor < 0) {
+		(void)fprintf(stderr, "Error: failed to open store \"%s\": %s\n", path, strerror(errno));
+		return false;
+	}
+
+	if (writable) {
+		if (flock(store->file_descriptor, LOCK_EX) != 0) {
+			(void
+			)fprintf(stderr, "Error: failed to lock store \"%s\": %s\n", path, strerror(errno));
+			store_close(store);
+			return false;
+		}
+		bool initialized = store_initialize(store);
+		(void)flock(store->file_descriptor, LOCK_UN);
+		if (!initialized) {
+			(void)fprintf(
+				stderr,
+				"Error: failed to initialize store \"%s\": %s\n",
+				path,
+				strerror(errno)
+			);
+			store_close(store);
+			return false;
+		}
+	}
+
+	unsigned char *data = store->data;
+	size_t size = store->size;
+	if (data == NULL && !store_map(store, &data, &size)) {
+		(void)fprintf(stderr, "Error: failed to map store \"%s\": %s\n", path, strerror(errno));
+		store_close(store);
+		return false;
+	}
+
+	const struct store_header *header = (const void *)data;
+	if (memcmp(header->magic, STORE_MAGIC, sizeof(header->magic)) != 0 ||
+		header->version != STORE_VERSION || header->buckets_count != STORE_BUCKETS_COUNT) {
+		(void)fprintf(stderr, "Error: \"%s\" is not a valid store\n", path);
+		store_close(store);
+		return false;
+	}
+
+	return true;
+}
+
+void store_close(struct store *store) {
+	assert(store != NULL);
+
+	if (store->data != NULL) {
+		munmap(store->data, store->size);
+	}
+	for (size_t i = 0; i < store->retired_length; i++) {
+		munmap(store->retired[i].data, store->retired[i].size);
+	}
+	free(store->retired);
+	if (store->file_descriptor >= 0) {
+		close(store->file_descriptor);
+	}
+
+	store->file_descriptor = -1;
+	store->data = NULL;
+	store->size = 0;
+	store->retired = NULL;
+	store->retired_length = 0;
+}
+
+static size_t store_record_size(const struct store_record *record) {
+	assert(record != NULL);
+
+	return sizeof(*record) + record->minterms_count * sizeof(uint64_t) +
+		   record->implicants_count * sizeof(struct implicant);
+}
+
+bool store_lookup(
+	struct store *store,
+	const struct minterms *minterms,
+	struct implicants *implicants
+) {
+	assert(store != NULL && store->file_descriptor >= 0 && minterms != NULL && implicants != NULL);
+
+	uint64_t hash = store_hash(minterms);
+
+	unsigned char *data = NULL;
+	size_t size = 0;
+	store_mapping(store, &data, &size);
+
+	const struct store_header *header = (const void *)data;
+	// records are fully written before they are linked into their bucket, so everything reachable
+	// from the bucket is safe to read once the mapping covers it
+	uint64_t offset =
+		__atomic_load_n(&header->buckets[hash % STORE_BUCKETS_COUNT], __ATOMIC_ACQUIRE);
+	while (offset != 0) {
+		if (offset > size - sizeof(struct store_record)) {
+			if (!store_map(store, &data, &size) || offset > size - sizeof(struct store_record)) {
+				return false;
+			}
+		}
+
+		const struct store_record *record = (const void *)&data[offset];
+		if (record->minterms_count > SIZE_MAX / 2 / sizeof(uint64_t) ||
+			record->implicants_count > SIZE_MAX / 2 / sizeof(struct implicant)) {
+			return false;
+		}
+		size_t record_size = store_record_size(record);
+		if (record_size > size - offset) {
+			if (!store_map(store, &data, &size) || record_size > size - offset) {
+				return false;
+			}
+			record = (const void *)&data[offset];
+		}
+
+		const uint64_t *record_minterms = (const void *)&record[1];
+		if (record->hash == hash && record->variables_count == minterms->variables.length &&
+			record->minterms_count == minterms->length &&
+			(minterms->length == 0 ||
+			 memcmp(record_minterms, minterms->data, minterms->length * sizeof(*minterms->data)) ==
+				 0)) {
+			// the view is never grown, its capacity only marks its elements as not being inline
+			size_t implicants_offset =
+				offset + sizeof(*record) + record->minterms_count * sizeof(uint64_t);
+			*implicants = (struct implicants){
+				.storage.heap = (void *)&data[implicants_offset],
+				.length = record->implicants_count,
+				.capacity = SIZE_MAX,
+			};
+			return true;
+		}
+
+		offset = record->next;
+	}
+
+	return false;
+}
+
+static bool store_append(
+	struct store *store,
+	const struct minterms *minterms,
+	const struct implicants *implicants
+) {
+	assert(store != NULL && minterms != NULL && implicants != NULL);
+
+	struct implicants existing;
+	if (store_lookup(store, minterms, &existing)) {
+		return true;
+	}
+
+	struct store_record record = {
+		.hash = store_hash(minterms),
+		.next = 0,
+		.variables_count = minterms->variables.length,
+		.minterms_count = minterms->length,
+		.implicants_count = implicants->length,
+	};
+	size_t record_size = store_record_size(&record);
+
+	unsigned char *data = NULL;
+	size_t size = 0;
+	store_mapping(store, &data, &size);
+
+	struct store_header *header = (void *)data;
+	uint64_t offset = __atomic_load_n(&header->length, __ATOMIC_ACQUIRE);
+	if (record_size > SIZE_MAX - offset) {
+		return false;
+	}
+	if (offset + record_size > size && !store_map(store, &data, &size)) {
+		return false;
+	}
+	if (offset + record_size > size) {
+		// grow the file geometrically so that appending stays amortized constant
+		size_t grown_size = size < SIZE_MAX / 2 ? size * 2 : SIZE_MAX;
+		if (grown_size < offset + record_size) {
+			grown_size = offset + record_size;
+		}
+		if (ftruncate(store->file_descriptor, (off_t)grown_size) != 0 ||
+			!store_map(store, &data, &size)) {
+			return false;
+		}
+	}
+
+	header = (void *)data;
+	record.next = header->buckets[record.hash % STORE_BUCKETS_COUNT];
+
+	unsigned char *record_data = &data[offset];
+	memcpy(record_data, &record, sizeof(record));
+	record_data += sizeof(record);
+	if (minterms->length != 0) {
+		memcpy(record_data, minterms->data, minterms->length * sizeof(*minterms->data));
+		record_data += minterms->length * sizeof(*minterms->data);
+	}
+	if (implicants->length != 0) {
+		memcpy(
+			record_data,
+			implicants_const_elements(implicants),
+			implicants->length * sizeof(struct implicant)
+		);
+	}
+
+	// publish the record only after it was completely written
+	__atomic_store_n(&header->length, offset + record_size, __ATOMIC_RELEASE);
+	__atomic_store_n(&header->buckets[record.hash % STORE_BUCKETS_COUNT], offset, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+bool store_insert(
+	struct store *store,
+	const struct minterms *minterms,
+	const struct implicants *implicants
+) {
+	assert(store != NULL && store->file_descriptor >= 0 && minterms != NULL && implicants != NULL);
+	assert(store->writable);
+
+	// the lock on the file is held by the descriptor, so it doesn't exclude the threads sharing it
+	(void)pthread_mutex_lock(&store->insert_mutex);
+
+	bool inserted = flock(store->file_descriptor, LOCK_EX) == 0;
+	if (inserted) {
+		inserted = store_append(store, minterms, implicants);
+		(void)flock(store->file_descriptor, LOCK_UN);
+	}
+
+	(void)pthread_mutex_unlock(&store->insert_mutex);
+
+	return inserted;
+}
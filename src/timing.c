@@ -0,0 +1,344 @@
+#include <timing.h>
+
+#include <allocator.h>
+#include <assert.h>
+#include <vector/define.h>
+
+VECTOR_DEFINE(timing_changes)
+VECTOR_DEFINE(timing_events)
+
+#define TIMING_ALLOCATE(pointer, count)                                                            \
+	do {                                                                                           \
+		(pointer) = allocator_allocate_zeroed((count), sizeof(*(pointer)));                        \
+		assert((pointer) != NULL);                                                                 \
+	} while (0)
+
+struct timing_netlist timing_netlist_new(
+	const struct expression *expressions,
+	size_t expressions_count,
+	const uint32_t *delays
+) {
+	assert(expressions != NULL || expressions_count == 0);
+
+	struct timing_netlist netlist = {
+		.pool = expression_pool_new(),
+		.outputs_count = expressions_count,
+	};
+
+	TIMING_ALLOCATE(netlist.outputs, expressions_count != 0 ? expressions_count : 1);
+	for (size_t i = 0; i < expressions_count; i++) {
+		netlist.outputs[i] = expression_pool_add_expression(&netlist.pool, &expressions[i]);
+		assert(netlist.outputs[i] != EXPRESSION_POOL_NONE);
+	}
+
+	const struct expression_pool *pool = &netlist.pool;
+	TIMING_ALLOCATE(netlist.delays, pool->length + 1);
+	TIMING_ALLOCATE(netlist.fanouts_starts, pool->length + 1);
+	TIMING_ALLOCATE(netlist.fanouts, pool->operands_length + 1);
+	for (size_t i = 0; i < VARIABLES_COUNT; i++) {
+		netlist.inputs[i] = EXPRESSION_POOL_NONE;
+	}
+
+	// the fanouts are grouped by operand, counting them first gives the start of every group
+	for (size_t i = 0; i < pool->length; i++) {
+		switch (pool->types[i]) {
+			case expression_type_constant: break;
+			case expression_type_variable: {
+				netlist.inputs[environment_variable_index((char)pool->values[i])] = (uint32_t)i;
+			} break;
+			case expression_type_operation: {
+				netlist.delays[i] = delays != NULL ? delays[pool->values[i]] : 1;
+				assert(netlist.delays[i] != 0);
+
+				for (size_t j = 0; j < pool->operands_counts[i]; j++) {
+					netlist.fanouts_starts[pool->operands[pool->operands_starts[i] + j] + 1]++;
+				}
+			} break;
+			default: assert(false);
+		}
+	}
+	for (size_t i = 0; i < pool->length; i++) {
+		netlist.fanouts_starts[i + 1] += netlist.fanouts_starts[i];
+	}
+
+	uint32_t *positions = NULL;
+	TIMING_ALLOCATE(positions, pool->length + 1);
+	for (size_t i = 0; i < pool->length; i++) {
+		for (size_t j = 0; j < pool->operands_counts[i]; j++) {
+			uint32_t operand = pool->operands[pool->operands_starts[i] + j];
+			netlist.fanouts[netlist.fanouts_starts[operand] + positions[operand]++] = (uint32_t)i;
+		}
+	}
+
+	// the outputs are grouped by node the same way
+	TIMING_ALLOCATE(netlist.outputs_starts, pool->length + 1);
+	TIMING_ALLOCATE(netlist.outputs_of, expressions_count + 1);
+	for (size_t i = 0; i < expressions_count; i++) {
+		netlist.outputs_starts[netlist.outputs[i] + 1]++;
+	}
+	for (size_t i = 0; i < pool->length; i++) {
+		netlist.outputs_starts[i + 1] += netlist.outputs_starts[i];
+		positions[i] = 0;
+	}
+	for (size_t i = 0; i < expressions_count; i++) {
+		uint32_t output = netlist.outputs[i];
+		netlist.outputs_of[netlist.outputs_starts[output] + positions[output]++] = (uint32_t)i;
+	}
+
+	allocator_free(positions);
+
+	return netlist;
+}
+
+void timing_netlist_drop(struct timing_netlist *netlist) {
+	assert(netlist != NULL);
+
+	expression_pool_drop(&netlist->pool);
+	allocator_free(netlist->delays);
+	allocator_free(netlist->fanouts_starts);
+	allocator_free(netlist->fanouts);
+	allocator_free(netlist->outputs);
+	allocator_free(netlist->outputs_starts);
+	allocator_free(netlist->outputs_of);
+}
+
+// evaluates a node on the current values of its operands
+static bool timing_evaluate(const struct expression_pool *pool, const bool *values, size_t node) {
+	assert(pool != NULL && values != NULL && node < pool->length);
+
+	switch (pool->types[node]) {
+		case expression_type_constant: return pool->values[node] != 0;
+		case expression_type_variable: return values[node];
+		case expression_type_operation: {
+			const uint32_t *operands = &pool->operands[pool->operands_starts[node]];
+			size_t operands_count = pool->operands_counts[node];
+			switch ((enum operation_type)pool->values[node]) {
+				case operation_type_conjunction: {
+					for (size_t i = 0; i < operands_count; i++) {
+						if (!values[operands[i]]) {
+							return false;
+						}
+					}
+					return true;
+				}
+				case operation_type_disjunction: {
+					for (size_t i = 0; i < operands_count; i++) {
+						if (values[operands[i]]) {
+							return true;
+						}
+					}
+					return false;
+				}
+				case operation_type_negation: return !values[operands[0]];
+				case operation_type_exclusive_disjunction: {
+					return values[operands[0]] != values[operands[1]];
+				}
+				case operation_type_biconditional: {
+					return values[operands[0]] == values[operands[1]];
+				}
+				case operation_type_alternative_denial: {
+					return !(values[operands[0]] && values[operands[1]]);
+				}
+				case operation_type_joint_denial: {
+					return !(values[operands[0]] || values[operands[1]]);
+				}
+				case operation_type_implication: {
+					return !values[operands[0]] || values[operands[1]];
+				}
+				default: assert(false);
+			}
+		} break;
+		default: assert(false);
+	}
+
+	return false;
+}
+
+struct timing_simulator timing_simulator_new(const struct timing_netlist *netlist) {
+	assert(netlist != NULL);
+
+	const struct expression_pool *pool = &netlist->pool;
+
+	// every event is scheduled less than the largest delay ahead, so the wheel never wraps onto
+	// a slot that still holds events
+	uint32_t delay = 1;
+	for (size_t i = 0; i < pool->length; i++) {
+		if (netlist->delays[i] > delay) {
+			delay = netlist->delays[i];
+		}
+	}
+	size_t slots = 2;
+	while (slots <= delay) {
+		slots *= 2;
+	}
+
+	struct timing_simulator simulator = {
+		.netlist = netlist,
+		.wheel_mask = slots - 1,
+		.pending = 0,
+		.time = 0,
+		.settle_time = 0,
+		.events_count = 0,
+	};
+	TIMING_ALLOCATE(simulator.values, pool->length + 1);
+	TIMING_ALLOCATE(simulator.projected, pool->length + 1);
+	TIMING_ALLOCATE(simulator.stamps, pool->length + 1);
+	TIMING_ALLOCATE(simulator.evaluated, pool->length + 1);
+	TIMING_ALLOCATE(simulator.wheel, slots);
+	TIMING_ALLOCATE(simulator.waveforms, netlist->outputs_count + 1);
+	for (size_t i = 0; i < slots; i++) {
+		simulator.wheel[i] = timing_events_new();
+	}
+
+	// the nodes are in topological order, so a single pass settles the netlist
+	for (size_t i = 0; i < pool->length; i++) {
+		simulator.values[i] = timing_evaluate(pool, simulator.values, i);
+		simulator.projected[i] = simulator.values[i];
+	}
+
+	for (size_t i = 0; i < netlist->outputs_count; i++) {
+		simulator.waveforms[i] = timing_changes_new();
+
+		struct timing_change change = {
+			.time = 0,
+			.value = simulator.values[netlist->outputs[i]],
+		};
+		bool inserted = timing_changes_insert(&simulator.waveforms[i], 0, &change, 1);
+		assert(inserted);
+		(void)inserted;
+	}
+
+	return simulator;
+}
+
+void timing_simulator_drop(struct timing_simulator *simulator) {
+	assert(simulator != NULL);
+
+	for (size_t i = 0; i <= simulator->wheel_mask; i++) {
+		timing_events_drop(&simulator->wheel[i]);
+	}
+	for (size_t i = 0; i < simulator->netlist->outputs_count; i++) {
+		timing_changes_drop(&simulator->waveforms[i]);
+	}
+
+	allocator_free(simulator->values);
+	allocator_free(simulator->projected);
+	allocator_free(simulator->stamps);
+	allocator_free(simulator->evaluated);
+	allocator_free(simulator->wheel);
+	allocator_free(simulator->waveforms);
+}
+
+// schedules a change of a node at a tick that is less than the wheel's length ahead
+static void timing_schedule(
+	struct timing_simulator *simulator,
+	uint64_t time,
+	uint32_t node,
+	bool value
+) {
+	assert(simulator != NULL && time - simulator->time <= simulator->wheel_mask);
+
+	simulator->projected[node] = value;
+
+	struct timing_events *slot = &simulator->wheel[time & simulator->wheel_mask];
+	struct timing_event event = { .node = node, .value = value };
+	bool inserted = timing_events_insert(slot, slot->length, &event, 1);
+	assert(inserted);
+	(void)inserted;
+
+	simulator->pending++;
+}
+
+// simulates the current tick, applying its events and evaluating the gates they affect
+static void timing_step(struct timing_simulator *simulator) {
+	assert(simulator != NULL);
+
+	const struct timing_netlist *netlist = simulator->netlist;
+	uint64_t time = simulator->time;
+	struct timing_events *slot = &simulator->wheel[time & simulator->wheel_mask];
+
+	// all the events of a tick are applied before any gate is evaluated, so that simultaneous
+	// changes of a gate's operands are seen together
+	size_t evaluated_count = 0;
+	for (size_t i = 0; i < slot->length; i++) {
+		struct timing_event event = timing_events_elements(slot)[i];
+		if (simulator->values[event.node] == event.value) {
+			continue;
+		}
+
+		simulator->values[event.node] = event.value;
+		simulator->settle_time = time;
+		simulator->events_count++;
+
+		for (uint32_t j = netlist->outputs_starts[event.node];
+			 j < netlist->outputs_starts[event.node + 1];
+			 j++) {
+			struct timing_changes *waveform = &simulator->waveforms[netlist->outputs_of[j]];
+			struct timing_change change = { .time = time, .value = event.value };
+			bool inserted = timing_changes_insert(waveform, waveform->length, &change, 1);
+			assert(inserted);
+			(void)inserted;
+		}
+
+		for (uint32_t j = netlist->fanouts_starts[event.node];
+			 j < netlist->fanouts_starts[event.node + 1];
+			 j++) {
+			uint32_t gate = netlist->fanouts[j];
+			if (simulator->stamps[gate] != time + 1) {
+				simulator->stamps[gate] = time + 1;
+				simulator->evaluated[evaluated_count++] = gate;
+			}
+		}
+	}
+	simulator->pending -= slot->length;
+	slot->length = 0;
+
+	for (size_t i = 0; i < evaluated_count; i++) {
+		uint32_t gate = simulator->evaluated[i];
+		bool value = timing_evaluate(&netlist->pool, simulator->values, gate);
+		if (value != simulator->projected[gate]) {
+			timing_schedule(simulator, time + netlist->delays[gate], gate, value);
+		}
+	}
+
+	simulator->time++;
+}
+
+// simulates the ticks before `time`, skipping the ticks without events
+static void timing_run(struct timing_simulator *simulator, uint64_t time) {
+	assert(simulator != NULL);
+
+	while (simulator->time < time) {
+		if (simulator->pending == 0) {
+			simulator->time = time;
+			break;
+		}
+		timing_step(simulator);
+	}
+}
+
+void timing_simulator_set(
+	struct timing_simulator *simulator,
+	uint64_t time,
+	char name,
+	bool value
+) {
+	assert(simulator != NULL && time >= simulator->time);
+
+	timing_run(simulator, time);
+
+	uint32_t node = simulator->netlist->inputs[environment_variable_index(name)];
+	if (node != EXPRESSION_POOL_NONE && simulator->projected[node] != value) {
+		timing_schedule(simulator, time, node, value);
+	}
+}
+
+uint64_t timing_simulator_settle(struct timing_simulator *simulator) {
+	assert(simulator != NULL);
+
+	while (simulator->pending != 0) {
+		timing_step(simulator);
+	}
+
+	return simulator->settle_time;
+}
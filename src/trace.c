@@ -0,0 +1,95 @@
+#include <trace.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+bool trace_enabled = false;
+
+static FILE *trace_file = NULL;
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static double trace_origin = 0.0;
+
+static atomic_size_t trace_threads_count = 0;
+static _Thread_local size_t trace_thread = 0;
+
+bool trace_open(const char *path) {
+	assert(path != NULL && trace_file == NULL);
+
+	trace_file = fopen(path, "w");
+	if (trace_file == NULL) {
+		(void)fprintf(stderr, "Error: failed to open trace \"%s\": %s\n", path, strerror(errno));
+		return false;
+	}
+
+	trace_origin = stats_time_now().wall;
+	(void)fprintf(trace_file, "{\"traceEvents\":[");
+
+	// the thread that opens the trace is the main one, whichever thread records a span first
+	trace_thread = 1;
+	atomic_store(&trace_threads_count, 1);
+	(void)fprintf(
+		trace_file,
+		"\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+		"\"args\":{\"name\":\"main\"}}"
+	);
+
+	trace_enabled = true;
+	return true;
+}
+
+void trace_close(void) {
+	if (!trace_enabled) {
+		return;
+	}
+
+	(void)fprintf(trace_file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	(void)fclose(trace_file);
+	trace_file = NULL;
+
+	trace_enabled = false;
+}
+
+void trace_span(const char *name, size_t index, struct stats_time start, struct stats_time end) {
+	assert(name != NULL);
+
+	if (!trace_enabled) {
+		return;
+	}
+
+	// the other threads are numbered in the order they record their first span, after the main one
+	bool first = false;
+	if (trace_thread == 0) {
+		trace_thread = atomic_fetch_add(&trace_threads_count, 1) + 1;
+		first = true;
+	}
+
+	(void)pthread_mutex_lock(&trace_mutex);
+
+	if (first) {
+		(void)fprintf(
+			trace_file,
+			",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,"
+			"\"args\":{\"name\":\"worker %zu\"}}",
+			trace_thread,
+			trace_thread - 1
+		);
+	}
+
+	(void)fprintf(
+		trace_file,
+		",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,"
+		"\"args\":{\"index\":%zu,\"cpu_us\":%.3f}}",
+		name,
+		trace_thread,
+		(start.wall - trace_origin) * 1e6,
+		(end.wall - start.wall) * 1e6,
+		index,
+		(end.cpu - start.cpu) * 1e6
+	);
+
+	(void)pthread_mutex_unlock(&trace_mutex);
+}
@@ -0,0 +1,500 @@
+#include <zdd.h>
+
+#include <allocator.h>
+#include <assert.h>
+#include <budget.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the variable of the terminals, which comes after every other one
+#define ZDD_TERMINAL (UINT32_MAX)
+
+// how many nodes are made between checks of the budget
+#define ZDD_BUDGET_INTERVAL (1024)
+
+enum zdd_operation {
+	zdd_operation_conjunction = 1,
+	zdd_operation_difference,
+	zdd_operation_prime_implicants,
+};
+
+struct zdd zdd_new(size_t variables_count) {
+	assert(variables_count <= 64);
+
+	struct zdd zdd = {
+		.variables_count = variables_count,
+		.length = 0,
+		.capacity = 0,
+		.variables = NULL,
+		.lows = NULL,
+		.highs = NULL,
+		.buckets = NULL,
+		.buckets_count = 0,
+		.cache = NULL,
+		.failed = false,
+	};
+
+	// the terminals aren't in the hash table, every other node is
+	size_t capacity = 1024;
+	zdd.variables = allocator_allocate(capacity * sizeof(*zdd.variables));
+	zdd.lows = allocator_allocate(capacity * sizeof(*zdd.lows));
+	zdd.highs = allocator_allocate(capacity * sizeof(*zdd.highs));
+	zdd.buckets = allocator_allocate(2 * capacity * sizeof(*zdd.buckets));
+	zdd.cache = allocator_allocate_zeroed(2 * capacity, sizeof(*zdd.cache));
+	if (zdd.variables == NULL || zdd.lows == NULL || zdd.highs == NULL || zdd.buckets == NULL ||
+		zdd.cache == NULL) {
+		zdd.failed = true;
+		return zdd;
+	}
+	zdd.capacity = capacity;
+	zdd.buckets_count = 2 * capacity;
+	memset(zdd.buckets, 0xFF, zdd.buckets_count * sizeof(*zdd.buckets));
+
+	for (uint32_t i = ZDD_EMPTY; i <= ZDD_BASE; i++) {
+		zdd.variables[i] = ZDD_TERMINAL;
+		zdd.lows[i] = i;
+		zdd.highs[i] = i;
+	}
+	zdd.length = 2;
+
+	return zdd;
+}
+
+void zdd_drop(struct zdd *zdd) {
+	assert(zdd != NULL);
+
+	allocator_free(zdd->variables);
+	allocator_free(zdd->lows);
+	allocator_free(zdd->highs);
+	allocator_free(zdd->buckets);
+	allocator_free(zdd->cache);
+}
+
+static uint64_t zdd_hash_(uint32_t value_1, uint32_t value_2, uint32_t value_3) {
+	uint64_t hash = UINT64_C(14695981039346656037);
+	hash = (hash ^ value_1) * UINT64_C(1099511628211);
+	hash = (hash ^ value_2) * UINT64_C(1099511628211);
+	hash = (hash ^ value_3) * UINT64_C(1099511628211);
+
+	hash ^= hash >> 33;
+	hash *= UINT64_C(0xff51afd7ed558ccd);
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+// finds the bucket a node with the given contents is or would be stored in
+static size_t zdd_find_(const struct zdd *zdd, uint32_t variable, uint32_t low, uint32_t high) {
+	assert(zdd != NULL && zdd->buckets_count != 0);
+
+	size_t mask = zdd->buckets_count - 1;
+	size_t i = (size_t)zdd_hash_(variable, low, high) & mask;
+	while (zdd->buckets[i] != ZDD_NONE) {
+		uint32_t node = zdd->buckets[i];
+		if (zdd->variables[node] == variable && zdd->lows[node] == low &&
+			zdd->highs[node] == high) {
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+
+	return i;
+}
+
+// doubles the nodes' arrays and the hash table, the cache is resized along with the table and
+// forgets every result
+static bool zdd_grow_(struct zdd *zdd) {
+	assert(zdd != NULL);
+
+	if (zdd->capacity > UINT32_MAX / 4) {
+		return false;
+	}
+	size_t capacity = 2 * zdd->capacity;
+
+	uint32_t *variables = allocator_reallocate(zdd->variables, capacity * sizeof(*variables));
+	if (variables == NULL) {
+		return false;
+	}
+	zdd->variables = variables;
+	uint32_t *lows = allocator_reallocate(zdd->lows, capacity * sizeof(*lows));
+	if (lows == NULL) {
+		return false;
+	}
+	zdd->lows = lows;
+	uint32_t *highs = allocator_reallocate(zdd->highs, capacity * sizeof(*highs));
+	if (highs == NULL) {
+		return false;
+	}
+	zdd->highs = highs;
+
+	uint32_t *buckets = allocator_allocate(2 * capacity * sizeof(*buckets));
+	struct zdd_cache_entry *cache = allocator_allocate_zeroed(2 * capacity, sizeof(*cache));
+	if (buckets == NULL || cache == NULL) {
+		allocator_free(buckets);
+		allocator_free(cache);
+		return false;
+	}
+	allocator_free(zdd->buckets);
+	allocator_free(zdd->cache);
+	zdd->capacity = capacity;
+	zdd->buckets = buckets;
+	zdd->buckets_count = 2 * capacity;
+	zdd->cache = cache;
+
+	memset(zdd->buckets, 0xFF, zdd->buckets_count * sizeof(*zdd->buckets));
+	for (size_t i = ZDD_BASE + 1; i < zdd->length; i++) {
+		zdd->buckets[zdd_find_(zdd, zdd->variables[i], zdd->lows[i], zdd->highs[i])] = (uint32_t)i;
+	}
+
+	return true;
+}
+
+// adds a node unless an identical one exists, without reducing it
+static uint32_t zdd_add_(struct zdd *zdd, uint32_t variable, uint32_t low, uint32_t high) {
+	assert(zdd != NULL);
+
+	if (zdd->failed || low == ZDD_NONE || high == ZDD_NONE) {
+		return ZDD_NONE;
+	}
+
+	size_t bucket = zdd_find_(zdd, variable, low, high);
+	if (zdd->buckets[bucket] != ZDD_NONE) {
+		return zdd->buckets[bucket];
+	}
+
+	if (zdd->length % ZDD_BUDGET_INTERVAL == 0 && budget_exceeded(0)) {
+		zdd->failed = true;
+		return ZDD_NONE;
+	}
+	if (zdd->length == zdd->capacity) {
+		if (!zdd_grow_(zdd)) {
+			zdd->failed = true;
+			return ZDD_NONE;
+		}
+		bucket = zdd_find_(zdd, variable, low, high);
+	}
+
+	uint32_t node = (uint32_t)zdd->length++;
+	zdd->variables[node] = variable;
+	zdd->lows[node] = low;
+	zdd->highs[node] = high;
+	zdd->buckets[bucket] = node;
+
+	return node;
+}
+
+// a node of a function is redundant if both of its children are the same
+static uint32_t zdd_function_node_(
+	struct zdd *zdd,
+	uint32_t variable,
+	uint32_t low,
+	uint32_t high
+) {
+	return low == high ? low : zdd_add_(zdd, variable, low, high);
+}
+
+// a node of a set is redundant if no cube contains its literal
+static uint32_t zdd_set_node_(struct zdd *zdd, uint32_t literal, uint32_t low, uint32_t high) {
+	return high == ZDD_EMPTY ? low : zdd_add_(zdd, literal, low, high);
+}
+
+static struct zdd_cache_entry *zdd_cache_entry_(
+	struct zdd *zdd,
+	enum zdd_operation operation,
+	uint32_t operand_1,
+	uint32_t operand_2
+) {
+	assert(zdd != NULL);
+
+	size_t index = (size_t)zdd_hash_(operation, operand_1, operand_2) & (zdd->buckets_count - 1);
+	return &zdd->cache[index];
+}
+
+static uint32_t zdd_cache_find_(
+	struct zdd *zdd,
+	enum zdd_operation operation,
+	uint32_t operand_1,
+	uint32_t operand_2
+) {
+	const struct zdd_cache_entry *entry = zdd_cache_entry_(zdd, operation, operand_1, operand_2);
+	if (entry->operation == operation && entry->operand_1 == operand_1 &&
+		entry->operand_2 == operand_2) {
+		return entry->result;
+	}
+	return ZDD_NONE;
+}
+
+static void zdd_cache_insert_(
+	struct zdd *zdd,
+	enum zdd_operation operation,
+	uint32_t operand_1,
+	uint32_t operand_2,
+	uint32_t result
+) {
+	if (result == ZDD_NONE) {
+		return;
+	}
+
+	// the cache may have been resized since the entry was looked up
+	*zdd_cache_entry_(zdd, operation, operand_1, operand_2) = (struct zdd_cache_entry){
+		.operation = operation,
+		.operand_1 = operand_1,
+		.operand_2 = operand_2,
+		.result = result,
+	};
+}
+
+static uint32_t zdd_conjunction_(struct zdd *zdd, uint32_t function_1, uint32_t function_2) {
+	assert(zdd != NULL);
+
+	if (function_1 == ZDD_NONE || function_2 == ZDD_NONE) {
+		return ZDD_NONE;
+	}
+	if (function_1 == ZDD_EMPTY || function_2 == ZDD_EMPTY) {
+		return ZDD_EMPTY;
+	}
+	if (function_1 == ZDD_BASE || function_1 == function_2) {
+		return function_2;
+	}
+	if (function_2 == ZDD_BASE) {
+		return function_1;
+	}
+
+	// the conjunction is commutative, so both orders share an entry
+	if (function_1 > function_2) {
+		uint32_t function = function_1;
+		function_1 = function_2;
+		function_2 = function;
+	}
+
+	uint32_t result = zdd_cache_find_(zdd, zdd_operation_conjunction, function_1, function_2);
+	if (result != ZDD_NONE) {
+		return result;
+	}
+
+	uint32_t variable_1 = zdd->variables[function_1];
+	uint32_t variable_2 = zdd->variables[function_2];
+	uint32_t variable = variable_1 < variable_2 ? variable_1 : variable_2;
+
+	uint32_t low_1 = variable_1 == variable ? zdd->lows[function_1] : function_1;
+	uint32_t high_1 = variable_1 == variable ? zdd->highs[function_1] : function_1;
+	uint32_t low_2 = variable_2 == variable ? zdd->lows[function_2] : function_2;
+	uint32_t high_2 = variable_2 == variable ? zdd->highs[function_2] : function_2;
+
+	uint32_t low = zdd_conjunction_(zdd, low_1, low_2);
+	uint32_t high = zdd_conjunction_(zdd, high_1, high_2);
+	result = zdd_function_node_(zdd, variable, low, high);
+
+	zdd_cache_insert_(zdd, zdd_operation_conjunction, function_1, function_2, result);
+
+	return result;
+}
+
+// the cubes of the first set that aren't in the second one
+static uint32_t zdd_difference_(struct zdd *zdd, uint32_t set_1, uint32_t set_2) {
+	assert(zdd != NULL);
+
+	if (set_1 == ZDD_NONE || set_2 == ZDD_NONE) {
+		return ZDD_NONE;
+	}
+	if (set_1 == ZDD_EMPTY || set_1 == set_2) {
+		return ZDD_EMPTY;
+	}
+	if (set_2 == ZDD_EMPTY) {
+		return set_1;
+	}
+
+	uint32_t result = zdd_cache_find_(zdd, zdd_operation_difference, set_1, set_2);
+	if (result != ZDD_NONE) {
+		return result;
+	}
+
+	uint32_t literal_1 = zdd->variables[set_1];
+	uint32_t literal_2 = zdd->variables[set_2];
+	if (literal_1 < literal_2) {
+		// no cube of the second set contains the literal
+		uint32_t low = zdd_difference_(zdd, zdd->lows[set_1], set_2);
+		result = zdd_set_node_(zdd, literal_1, low, zdd->highs[set_1]);
+	} else if (literal_1 > literal_2) {
+		// no cube of the first set contains the literal
+		result = zdd_difference_(zdd, set_1, zdd->lows[set_2]);
+	} else {
+		uint32_t low = zdd_difference_(zdd, zdd->lows[set_1], zdd->lows[set_2]);
+		uint32_t high = zdd_difference_(zdd, zdd->highs[set_1], zdd->highs[set_2]);
+		result = zdd_set_node_(zdd, literal_1, low, high);
+	}
+
+	zdd_cache_insert_(zdd, zdd_operation_difference, set_1, set_2, result);
+
+	return result;
+}
+
+uint32_t zdd_prime_implicants(struct zdd *zdd, uint32_t function) {
+	assert(zdd != NULL);
+
+	if (function == ZDD_NONE || zdd->failed) {
+		return ZDD_NONE;
+	}
+	if (function == ZDD_EMPTY || function == ZDD_BASE) {
+		return function;
+	}
+
+	uint32_t result = zdd_cache_find_(zdd, zdd_operation_prime_implicants, function, 0);
+	if (result != ZDD_NONE) {
+		return result;
+	}
+
+	uint32_t variable = zdd->variables[function];
+	uint32_t low = zdd->lows[function];
+	uint32_t high = zdd->highs[function];
+
+	uint32_t both = zdd_prime_implicants(zdd, zdd_conjunction_(zdd, low, high));
+	uint32_t negative = zdd_difference_(zdd, zdd_prime_implicants(zdd, low), both);
+	uint32_t positive = zdd_difference_(zdd, zdd_prime_implicants(zdd, high), both);
+	result = zdd_set_node_(
+		zdd,
+		2 * variable,
+		zdd_set_node_(zdd, 2 * variable + 1, both, negative),
+		positive
+	);
+
+	zdd_cache_insert_(zdd, zdd_operation_prime_implicants, function, 0, result);
+
+	return result;
+}
+
+// builds the function of sorted and distinct minterms that agree on the variables before `level`
+static uint32_t zdd_from_minterms_(
+	struct zdd *zdd,
+	const uint64_t *minterms,
+	size_t count,
+	size_t level
+) {
+	assert(zdd != NULL);
+
+	size_t remaining = zdd->variables_count - level;
+	if (count == 0) {
+		return ZDD_EMPTY;
+	}
+	if (remaining < 64 && count == (size_t)1 << remaining) {
+		return ZDD_BASE;
+	}
+	assert(remaining != 0);
+
+	// the minterms where the variable is true come after the others
+	uint64_t bit = UINT64_C(1) << (remaining - 1);
+	size_t start = 0;
+	size_t end = count;
+	while (start < end) {
+		size_t middle = start + (end - start) / 2;
+		if ((minterms[middle] & bit) != 0) {
+			end = middle;
+		} else {
+			start = middle + 1;
+		}
+	}
+
+	uint32_t low = zdd_from_minterms_(zdd, minterms, start, level + 1);
+	uint32_t high = zdd_from_minterms_(zdd, &minterms[start], count - start, level + 1);
+	return zdd_function_node_(zdd, (uint32_t)level, low, high);
+}
+
+static int zdd_minterm_compare_(const void *minterm_1, const void *minterm_2) {
+	uint64_t value_1 = *(const uint64_t *)minterm_1;
+	uint64_t value_2 = *(const uint64_t *)minterm_2;
+	return (value_1 > value_2) - (value_1 < value_2);
+}
+
+uint32_t zdd_from_minterms(struct zdd *zdd, const struct minterms *minterms) {
+	assert(zdd != NULL && minterms != NULL);
+	assert(minterms->variables.length == zdd->variables_count);
+
+	if (zdd->failed) {
+		return ZDD_NONE;
+	}
+
+	bool sorted = true;
+	for (size_t i = 1; i < minterms->length && sorted; i++) {
+		sorted = minterms->data[i - 1] < minterms->data[i];
+	}
+	if (sorted) {
+		return zdd_from_minterms_(zdd, minterms->data, minterms->length, 0);
+	}
+
+	uint64_t *data = allocator_allocate_zeroed(minterms->length, sizeof(*data));
+	if (data == NULL) {
+		zdd->failed = true;
+		return ZDD_NONE;
+	}
+	memcpy(data, minterms->data, minterms->length * sizeof(*data));
+	qsort(data, minterms->length, sizeof(*data), zdd_minterm_compare_);
+
+	size_t length = 0;
+	for (size_t i = 0; i < minterms->length; i++) {
+		if (length == 0 || data[length - 1] != data[i]) {
+			data[length++] = data[i];
+		}
+	}
+
+	uint32_t function = zdd_from_minterms_(zdd, data, length, 0);
+	allocator_free(data);
+
+	return function;
+}
+
+bool zdd_count(const struct zdd *zdd, uint32_t set, double *count) {
+	assert(zdd != NULL && set < zdd->length && count != NULL);
+
+	// every node comes after its children, so the counts are filled in a single pass
+	double *counts = allocator_allocate_zeroed((size_t)set + 1, sizeof(*counts));
+	if (counts == NULL) {
+		return false;
+	}
+	for (uint32_t i = 0; i <= set; i++) {
+		if (i == ZDD_EMPTY || i == ZDD_BASE) {
+			counts[i] = (double)i;
+		} else {
+			counts[i] = counts[zdd->lows[i]] + counts[zdd->highs[i]];
+		}
+	}
+
+	*count = counts[set];
+	allocator_free(counts);
+
+	return true;
+}
+
+static bool zdd_to_implicants_(
+	const struct zdd *zdd,
+	uint32_t set,
+	struct implicant implicant,
+	struct implicants *implicants
+) {
+	if (set == ZDD_EMPTY) {
+		return true;
+	}
+	if (set == ZDD_BASE) {
+		if (implicants->length % 64 == 0 && budget_exceeded(implicants->length)) {
+			return false;
+		}
+		return implicants_add(implicants, implicant);
+	}
+
+	if (!zdd_to_implicants_(zdd, zdd->lows[set], implicant, implicants)) {
+		return false;
+	}
+
+	uint32_t literal = zdd->variables[set];
+	uint64_t bit = UINT64_C(1) << (zdd->variables_count - 1 - literal / 2);
+	implicant.mask |= bit;
+	if (literal % 2 == 0) {
+		implicant.value |= bit;
+	}
+	return zdd_to_implicants_(zdd, zdd->highs[set], implicant, implicants);
+}
+
+bool zdd_to_implicants(const struct zdd *zdd, uint32_t set, struct implicants *implicants) {
+	assert(zdd != NULL && set < zdd->length && implicants != NULL);
+
+	return zdd_to_implicants_(zdd, set, (struct implicant){ .value = 0, .mask = 0 }, implicants);
+}
@@ -0,0 +1,115 @@
+#include "test.h"
+
+#include <allocator.h>
+#include <environment.h>
+#include <expression.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// the variables of the expressions that are compared against every one of their environments
+#define EXHAUSTIVE_VARIABLES (8)
+
+// checks the answers of the checks against the values of the expressions in every environment
+static void test_exhaustive(uint64_t *state) {
+	struct expression expression_1 = test_random_expression(state, EXHAUSTIVE_VARIABLES, 5);
+	struct expression expression_2 = test_random_expression(state, EXHAUSTIVE_VARIABLES, 5);
+
+	bool equivalent = true;
+	bool tautology = true;
+	bool satisfiable = false;
+	for (uint64_t i = 0; i < UINT64_C(1) << EXHAUSTIVE_VARIABLES; i++) {
+		struct environment environment = { .variables = i };
+		bool value_1 = expression_evaluate(&expression_1, &environment);
+		bool value_2 = expression_evaluate(&expression_2, &environment);
+		equivalent = equivalent && value_1 == value_2;
+		tautology = tautology && value_1;
+		satisfiable = satisfiable || value_1;
+	}
+
+	struct environment counterexample = environment_new();
+	TEST_CHECK(expression_equivalent(&expression_1, &expression_2, &counterexample) == equivalent);
+	if (!equivalent) {
+		TEST_CHECK(
+			expression_evaluate(&expression_1, &counterexample) !=
+			expression_evaluate(&expression_2, &counterexample)
+		);
+	}
+	TEST_CHECK(expression_is_tautology(&expression_1, &counterexample) == tautology);
+	if (!tautology) {
+		TEST_CHECK(!expression_evaluate(&expression_1, &counterexample));
+	}
+	struct environment witness = environment_new();
+	TEST_CHECK(expression_is_satisfiable(&expression_1, &witness) == satisfiable);
+	if (satisfiable) {
+		TEST_CHECK(expression_evaluate(&expression_1, &witness));
+	}
+
+	// a simplified expression and the disjunction with its negation are known without evaluating
+	struct expression simplified = expression_clone(&expression_1);
+	expression_simplify(&simplified, NULL);
+	TEST_CHECK(expression_equivalent(&expression_1, &simplified, NULL));
+	struct expression negation = expression_operation(operation_type_negation, simplified);
+	struct expression disjunction =
+		expression_operation(operation_type_disjunction, expression_1, negation);
+	TEST_CHECK(expression_is_tautology(&disjunction, NULL));
+
+	expression_drop(&disjunction);
+	expression_drop(&expression_2);
+}
+
+// checks expressions whose support is too large to compare 64 environments at a time, which are
+// solved for an environment they differ in instead
+static void test_satisfiability(uint64_t *state) {
+	size_t variables_count = EXPRESSION_PARALLEL_SUPPORT + 1 + test_random(state) % 8;
+	struct expression *operands = allocator_allocate(variables_count * sizeof(*operands));
+	TEST_CHECK(operands != NULL);
+	if (operands == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < variables_count; i++) {
+		operands[i] = test_random_expression(state, variables_count, 3);
+	}
+	struct expression expression =
+		expression_operation_from_operands(operation_type_disjunction, operands, variables_count);
+
+	struct expression simplified = expression_clone(&expression);
+	expression_simplify(&simplified, NULL);
+	TEST_CHECK(expression_equivalent(&expression, &simplified, NULL));
+
+	// any difference the solver reports must be a real one
+	struct expression other = test_random_expression(state, variables_count, 6);
+	struct expression changed = expression_operation(
+		operation_type_exclusive_disjunction,
+		other,
+		expression_clone(&expression)
+	);
+	struct environment counterexample = environment_new();
+	if (!expression_equivalent(&expression, &changed, &counterexample)) {
+		TEST_CHECK(
+			expression_evaluate(&expression, &counterexample) !=
+			expression_evaluate(&changed, &counterexample)
+		);
+	}
+	if (!expression_is_tautology(&expression, &counterexample)) {
+		TEST_CHECK(!expression_evaluate(&expression, &counterexample));
+	}
+	if (expression_is_satisfiable(&changed, &counterexample)) {
+		TEST_CHECK(expression_evaluate(&changed, &counterexample));
+	}
+
+	expression_drop(&changed);
+	expression_drop(&simplified);
+	expression_drop(&expression);
+}
+
+int main(void) {
+	uint64_t state = 0x2545F4914F6CDD1D;
+	for (size_t i = 0; i < 512; i++) {
+		test_exhaustive(&state);
+	}
+	for (size_t i = 0; i < 32; i++) {
+		test_satisfiability(&state);
+	}
+	return test_finish();
+}
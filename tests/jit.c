@@ -0,0 +1,64 @@
+#include "test.h"
+
+#include <environment.h>
+#include <expression.h>
+#include <expression_pool.h>
+#include <jit.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// checks that the compiled expression evaluates like the expression in random environments
+static void test_compiled(const struct expression *expression, uint64_t *state) {
+	struct jit jit = jit_compile(expression);
+	TEST_CHECK(jit.pool.length != 0);
+	if (jit.pool.length == 0) {
+		jit_drop(&jit);
+		return;
+	}
+
+	for (size_t i = 0; i < 4; i++) {
+		uint64_t variables[VARIABLES_COUNT];
+		test_random_variables(state, variables);
+		uint64_t values = jit_evaluate_parallel(&jit, variables);
+		TEST_CHECK(values == expression_evaluate_parallel(expression, variables));
+		for (size_t j = 0; j < 64; j++) {
+			struct environment environment = test_variables_environment(variables, j);
+			bool value = expression_evaluate(expression, &environment);
+			TEST_CHECK((values >> j & 1) == value);
+			TEST_CHECK(jit_evaluate(&jit, &environment) == value);
+		}
+	}
+
+	jit_drop(&jit);
+}
+
+// returns the number of distinct nodes of an expression
+static size_t test_nodes_count(const struct expression *expression) {
+	struct expression_pool pool = expression_pool_from_expression(expression);
+	size_t nodes_count = pool.length;
+	expression_pool_drop(&pool);
+	return nodes_count;
+}
+
+int main(void) {
+	uint64_t state = 0xDA942042E4DD58B5;
+	for (size_t i = 0; i < 512; i++) {
+		struct expression expression =
+			test_random_expression(&state, 1 + test_random(&state) % VARIABLES_COUNT, 8);
+		test_compiled(&expression, &state);
+		expression_drop(&expression);
+	}
+
+	// an expression with more nodes than are compiled is interpreted
+	struct expression expression = test_random_expression(&state, VARIABLES_COUNT, 2);
+	while (test_nodes_count(&expression) <= JIT_NODES_LIMIT) {
+		struct expression operand = test_random_expression(&state, VARIABLES_COUNT, 8);
+		expression =
+			expression_operation(operation_type_exclusive_disjunction, expression, operand);
+	}
+	test_compiled(&expression, &state);
+	expression_drop(&expression);
+
+	return test_finish();
+}
@@ -0,0 +1,39 @@
+#include "test.h"
+
+#include <environment.h>
+#include <expression.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// checks that the lookup table of an expression over some of the variables evaluates like it
+static void test_lut(uint64_t *state) {
+	size_t variables_count = 1 + test_random(state) % (EXPRESSION_LUT_VARIABLES + 4);
+	struct expression expression = test_random_expression(state, variables_count, 6);
+	struct variables variables = variables_from_expression(&expression);
+
+	struct expression_lut lut;
+	bool compiled = expression_compile_lut(&expression, &lut);
+	TEST_CHECK(compiled == (variables.length <= EXPRESSION_LUT_VARIABLES));
+	if (compiled) {
+		for (size_t i = 0; i < 256; i++) {
+			struct environment environment = test_random_environment(state);
+			TEST_CHECK(
+				expression_lut_evaluate(&lut, &environment) ==
+				expression_evaluate(&expression, &environment)
+			);
+		}
+		expression_lut_drop(&lut);
+	}
+
+	variables_drop(&variables);
+	expression_drop(&expression);
+}
+
+int main(void) {
+	uint64_t state = 0x9FB21C651E98DF25;
+	for (size_t i = 0; i < 1024; i++) {
+		test_lut(&state);
+	}
+	return test_finish();
+}
@@ -0,0 +1,138 @@
+#include "test.h"
+
+#include <allocator.h>
+#include <expression.h>
+#include <pla.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define OUTPUTS_COUNT (3)
+
+// writes the prime implicants of random functions and checks that their minterms are read back
+static void test_round_trip(uint64_t *state, size_t variables_count) {
+	struct variables variables = variables_new();
+	for (size_t i = 0; i < variables_count; i++) {
+		char name = environment_variable_name(i);
+		TEST_CHECK(variables_append(&variables, &name, 1));
+	}
+
+	struct minterms minterms[OUTPUTS_COUNT];
+	for (size_t output = 0; output < OUTPUTS_COUNT; output++) {
+		minterms[output] = (struct minterms){
+			.variables = variables,
+			.data = allocator_allocate(sizeof(*minterms[output].data) << variables_count),
+			.length = 0,
+		};
+		for (uint64_t minterm = 0; minterm < UINT64_C(1) << variables_count; minterm++) {
+			if (test_random(state) % 3 == 0) {
+				minterms[output].data[minterms[output].length++] = minterm;
+			}
+		}
+	}
+
+	FILE *file = tmpfile();
+	TEST_CHECK(file != NULL);
+	if (file == NULL) {
+		return;
+	}
+	struct pla_writer writer;
+	TEST_CHECK(pla_writer_open(&writer, file, &variables, OUTPUTS_COUNT, NULL));
+	for (size_t output = 0; output < OUTPUTS_COUNT; output++) {
+		struct implicants implicants = minterms_to_prime_implicants(&minterms[output]);
+		for (size_t i = 0; i < implicants.length; i++) {
+			pla_writer_write(&writer, implicants_const_elements(&implicants)[i], output);
+		}
+		implicants_drop(&implicants);
+	}
+	TEST_CHECK(pla_writer_close(&writer));
+
+	rewind(file);
+	struct pla_reader reader;
+	bool opened = pla_reader_open(&reader, file);
+	TEST_CHECK(opened);
+	struct minterms read[OUTPUTS_COUNT];
+	bool read_minterms = opened && pla_reader_read_minterms(&reader, read);
+	TEST_CHECK(read_minterms);
+	if (opened) {
+		TEST_CHECK(reader.inputs_count == variables_count);
+		TEST_CHECK(reader.outputs_count == OUTPUTS_COUNT);
+		pla_reader_close(&reader);
+	}
+	(void)fclose(file);
+	if (!read_minterms) {
+		for (size_t output = 0; output < OUTPUTS_COUNT; output++) {
+			allocator_free(minterms[output].data);
+		}
+		variables_drop(&variables);
+		return;
+	}
+
+	for (size_t output = 0; output < OUTPUTS_COUNT; output++) {
+		TEST_CHECK(read[output].variables.length == variables_count);
+		TEST_CHECK(
+			memcmp(
+				variables_const_elements(&read[output].variables),
+				variables_const_elements(&variables),
+				variables_count
+			) == 0
+		);
+		TEST_CHECK(read[output].length == minterms[output].length);
+		TEST_CHECK(
+			read[output].length != minterms[output].length ||
+			memcmp(
+				read[output].data,
+				minterms[output].data,
+				read[output].length * sizeof(*read[output].data)
+			) == 0
+		);
+		minterms_drop(&read[output]);
+		allocator_free(minterms[output].data);
+	}
+	variables_drop(&variables);
+}
+
+// checks that the cubes of a file written on windows are read, and that don't-cares are off
+static void test_type_fd(void) {
+	char text[] = ".i 2\r\n.o 2\r\n.ilb x y\r\n.type fd\r\n"
+				  "01 1-\r\n"
+				  "11 -1 # a comment\r\n"
+				  "1- 00\r\n"
+				  ".e\r\n";
+	FILE *file = fmemopen(text, strlen(text), "r");
+	TEST_CHECK(file != NULL);
+	if (file == NULL) {
+		return;
+	}
+	struct pla_reader reader;
+	bool opened = pla_reader_open(&reader, file);
+	TEST_CHECK(opened);
+	struct minterms read[2];
+	bool read_minterms = opened && pla_reader_read_minterms(&reader, read);
+	TEST_CHECK(read_minterms);
+	if (opened) {
+		pla_reader_close(&reader);
+	}
+	(void)fclose(file);
+	if (!read_minterms) {
+		return;
+	}
+
+	TEST_CHECK(read[0].variables.length == 2);
+	TEST_CHECK(memcmp(variables_const_elements(&read[0].variables), "xy", 2) == 0);
+	TEST_CHECK(read[0].length == 1 && read[0].data[0] == 1);
+	TEST_CHECK(read[1].length == 1 && read[1].data[0] == 3);
+	minterms_drop(&read[0]);
+	minterms_drop(&read[1]);
+}
+
+int main(void) {
+	uint64_t state = 0x9E3779B97F4A7C15;
+	for (size_t i = 0; i < 64; i++) {
+		test_round_trip(&state, 1 + i % 10);
+	}
+	test_type_fd();
+	return test_finish();
+}
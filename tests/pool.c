@@ -0,0 +1,67 @@
+#include "test.h"
+
+#include <environment.h>
+#include <expression.h>
+#include <expression_pool.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// checks that a pool evaluates like its expression in random environments
+static void test_evaluate(
+	const struct expression_pool *pool,
+	const struct expression *expression,
+	uint64_t *state
+) {
+	uint64_t variables[VARIABLES_COUNT];
+	test_random_variables(state, variables);
+	uint64_t values = expression_pool_evaluate_parallel(pool, variables);
+	for (size_t i = 0; i < 64; i++) {
+		struct environment environment = test_variables_environment(variables, i);
+		bool value = expression_evaluate(expression, &environment);
+		TEST_CHECK((values >> i & 1) == value);
+		TEST_CHECK(expression_pool_evaluate(pool, &environment) == value);
+	}
+}
+
+static void test_simplify(uint64_t *state) {
+	struct expression expression = test_random_expression(state, 1 + test_random(state) % 12, 7);
+
+	struct expression_pool pool = expression_pool_from_expression(&expression);
+	TEST_CHECK(pool.length != 0);
+	if (pool.length == 0) {
+		expression_drop(&expression);
+		return;
+	}
+	test_evaluate(&pool, &expression, state);
+
+	// simplifying keeps the function, and converting the pool back keeps it too
+	expression_pool_simplify(&pool, NULL);
+	test_evaluate(&pool, &expression, state);
+	struct expression converted = expression_pool_to_expression(&pool);
+	TEST_CHECK(expression_equivalent(&expression, &converted, NULL));
+	expression_drop(&converted);
+	expression_pool_drop(&pool);
+
+	// simplifying in an environment assigns every variable, which leaves the expression's value
+	struct environment environment = test_random_environment(state);
+	pool = expression_pool_from_expression(&expression);
+	TEST_CHECK(pool.length != 0);
+	if (pool.length != 0) {
+		expression_pool_simplify(&pool, &environment);
+		bool value = expression_evaluate(&expression, &environment);
+		struct environment other = test_random_environment(state);
+		TEST_CHECK(expression_pool_evaluate(&pool, &other) == value);
+	}
+	expression_pool_drop(&pool);
+
+	expression_drop(&expression);
+}
+
+int main(void) {
+	uint64_t state = 0x853C49E6748FEA9B;
+	for (size_t i = 0; i < 1024; i++) {
+		test_simplify(&state);
+	}
+	return test_finish();
+}
@@ -0,0 +1,109 @@
+#include "test.h"
+
+#include <allocator.h>
+#include <environment.h>
+#include <expression.h>
+#include <serial.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// checks that a serialized expression evaluates like the expression and rebuilds into it
+static void test_expression(const struct expression *expression, uint64_t *state) {
+	size_t size = 0;
+	void *data = expression_serialize(expression, &size);
+	TEST_CHECK(data != NULL);
+	if (data == NULL) {
+		return;
+	}
+
+	struct serial_expression view;
+	TEST_CHECK(serial_expression_view(data, size, &view));
+	TEST_CHECK(!serial_expression_view(data, size - 1, &view));
+	TEST_CHECK(serial_expression_view(data, size, &view));
+
+	uint64_t variables[VARIABLES_COUNT];
+	test_random_variables(state, variables);
+	uint64_t values = 0;
+	TEST_CHECK(serial_expression_evaluate_parallel(&view, variables, &values));
+	for (size_t i = 0; i < 64; i++) {
+		struct environment environment = test_variables_environment(variables, i);
+		TEST_CHECK((values >> i & 1) == expression_evaluate(expression, &environment));
+	}
+
+	struct expression rebuilt;
+	TEST_CHECK(serial_expression_to_expression(&view, &rebuilt));
+	TEST_CHECK(expression_equals(expression, &rebuilt));
+	expression_drop(&rebuilt);
+
+	allocator_free(data);
+}
+
+// checks that the minterms and the prime implicants of an expression are read back as written
+static void test_minterms(const struct expression *expression) {
+	struct minterms minterms = minterms_from_expression(expression);
+	size_t size = 0;
+	void *data = minterms_serialize(&minterms, &size);
+	TEST_CHECK(data != NULL);
+	struct minterms read;
+	if (data != NULL && minterms_deserialize(data, size, &read)) {
+		TEST_CHECK(read.variables.length == minterms.variables.length);
+		TEST_CHECK(
+			memcmp(
+				variables_const_elements(&read.variables),
+				variables_const_elements(&minterms.variables),
+				minterms.variables.length
+			) == 0
+		);
+		TEST_CHECK(read.length == minterms.length);
+		TEST_CHECK(
+			read.length != minterms.length ||
+			memcmp(read.data, minterms.data, minterms.length * sizeof(*minterms.data)) == 0
+		);
+		minterms_drop(&read);
+	} else {
+		TEST_CHECK(false);
+	}
+	allocator_free(data);
+
+	struct implicants implicants = minterms_to_prime_implicants(&minterms);
+	data = implicants_serialize(&implicants, &minterms.variables, &size);
+	TEST_CHECK(data != NULL);
+	struct implicants read_implicants;
+	struct variables read_variables;
+	if (data != NULL && implicants_deserialize(data, size, &read_implicants, &read_variables)) {
+		TEST_CHECK(read_variables.length == minterms.variables.length);
+		TEST_CHECK(read_implicants.length == implicants.length);
+		for (size_t i = 0; i < implicants.length && i < read_implicants.length; i++) {
+			struct implicant implicant = implicants_const_elements(&implicants)[i];
+			struct implicant read_implicant = implicants_const_elements(&read_implicants)[i];
+			TEST_CHECK(implicant.value == read_implicant.value);
+			TEST_CHECK(implicant.mask == read_implicant.mask);
+		}
+		implicants_drop(&read_implicants);
+		variables_drop(&read_variables);
+	} else {
+		TEST_CHECK(false);
+	}
+	allocator_free(data);
+
+	implicants_drop(&implicants);
+	minterms_drop(&minterms);
+}
+
+int main(void) {
+	uint64_t state = 0xC2B2AE3D27D4EB4F;
+	for (size_t i = 0; i < 1024; i++) {
+		struct expression expression =
+			test_random_expression(&state, 1 + test_random(&state) % VARIABLES_COUNT, 7);
+		test_expression(&expression, &state);
+		expression_drop(&expression);
+	}
+	for (size_t i = 0; i < 256; i++) {
+		struct expression expression = test_random_expression(&state, 1 + i % 10, 6);
+		test_minterms(&expression);
+		expression_drop(&expression);
+	}
+	return test_finish();
+}
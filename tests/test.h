@@ -0,0 +1,153 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <environment.h>
+#include <expression.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief The number of failed checks of the test.
+ */
+static size_t test_failures = 0;
+
+/**
+ * @brief Checks that a condition holds, printing it with its location if it doesn't.
+ */
+#define TEST_CHECK(condition)                                                                      \
+	do {                                                                                           \
+		if (!(condition)) {                                                                        \
+			(void)fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+			test_failures++;                                                                       \
+		}                                                                                          \
+	} while (false)
+
+/**
+ * @brief Finishes a test.
+ *
+ * @return The exit status of the test, nonzero if any check failed.
+ */
+static inline int test_finish(void) {
+	if (test_failures != 0) {
+		(void)fprintf(stderr, "%zu checks failed\n", test_failures);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Draws a random number.
+ *
+ * A xorshift generator, so that every run of a test checks the same expressions.
+ *
+ * @param[in,out] state The state of the generator, must not be 0.
+ * @return The random number.
+ */
+static inline uint64_t test_random(uint64_t *state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+/**
+ * @brief Builds a random expression.
+ *
+ * The expression is made of every type of operation, over the first `variables_count` variables
+ * of the alphabet, and has no more than `depth` levels of operations.
+ *
+ * @param[in,out] state The state of the generator.
+ * @param[in] variables_count The number of variables to choose from, at least 1.
+ * @param[in] depth The largest depth of the expression.
+ * @return The newly created expression.
+ */
+static inline struct expression test_random_expression(
+	uint64_t *state,
+	size_t variables_count,
+	size_t depth
+) {
+	uint64_t choice = test_random(state);
+	if (depth == 0 || choice % 8 == 0) {
+		if (choice % 64 == 0) {
+			return expression_constant((choice >> 8) % 2 != 0);
+		}
+		return expression_variable(environment_variable_name((choice >> 8) % variables_count));
+	}
+
+	uint64_t types_count = operation_type_implication + 1;
+	enum operation_type type = (enum operation_type)((choice >> 8) % types_count);
+	struct expression operand_1 = test_random_expression(state, variables_count, depth - 1);
+	if (type == operation_type_negation) {
+		return expression_operation(type, operand_1);
+	}
+	struct expression operand_2 = test_random_expression(state, variables_count, depth - 1);
+	return expression_operation(type, operand_1, operand_2);
+}
+
+/**
+ * @brief Draws a random environment.
+ *
+ * @param[in,out] state The state of the generator.
+ * @return The environment, where every variable has a random value.
+ */
+static inline struct environment test_random_environment(uint64_t *state) {
+	return (struct environment){
+		.variables = test_random(state) & ((UINT64_C(1) << VARIABLES_COUNT) - 1U),
+	};
+}
+
+/**
+ * @brief Draws the values of the variables of 64 random environments.
+ *
+ * @param[in,out] state The state of the generator.
+ * @param[out] variables Set to the values of the variables, `VARIABLES_COUNT` words, in the layout
+ * of `expression_evaluate_parallel()`.
+ */
+static inline void test_random_variables(uint64_t *state, uint64_t *variables) {
+	for (size_t i = 0; i < VARIABLES_COUNT; i++) {
+		variables[i] = test_random(state);
+	}
+}
+
+/**
+ * @brief Gets one of 64 environments.
+ *
+ * @param[in] variables The values of the variables, `VARIABLES_COUNT` words, in the layout of
+ * `expression_evaluate_parallel()`.
+ * @param[in] bit The environment, less than 64.
+ * @return The `bit`th environment.
+ */
+static inline struct environment test_variables_environment(const uint64_t *variables, size_t bit) {
+	struct environment environment = environment_new();
+	for (size_t i = 0; i < VARIABLES_COUNT; i++) {
+		environment.variables |= (variables[i] >> bit & 1) << i;
+	}
+	return environment;
+}
+
+/**
+ * @brief Builds the environment of a minterm.
+ *
+ * @param[in] variables The variables of the minterm, the first one being its most significant bit.
+ * @param[in] minterm The minterm.
+ * @return The environment where the variables have the values of the minterm.
+ */
+static inline struct environment test_minterm_environment(
+	const struct variables *variables,
+	uint64_t minterm
+) {
+	struct environment environment = environment_new();
+	for (size_t i = 0; i < variables->length; i++) {
+		environment_set_variable(
+			&environment,
+			variables_const_elements(variables)[i],
+			(minterm >> (variables->length - 1 - i) & 1) != 0
+		);
+	}
+	return environment;
+}
+
+#endif